@@ -0,0 +1,65 @@
+#include "../include/Combiner.h"
+#include "../include/KeyValueBuffer.h"
+#include "TEST_Test_Framework.h"
+#include <map>
+#include <string>
+
+static std::map<std::string, long> sumByKey(const KeyValueBuffer& records) {
+    std::map<std::string, long> sums;
+    for (const auto& record : records) sums[std::string(record.key())] += record.value;
+    return sums;
+}
+
+TEST_CASE(CombinerTests) {
+    // 2000 records over 20 keys, in a skewed order so keys recur between flushes
+    std::map<std::string, long> expected;
+    KeyValueBuffer input;
+    for (int i = 0; i < 2000; ++i) {
+        std::string key = "word" + std::to_string((i * i + 3 * i) % 20);
+        int count = 1 + i % 3;
+        input.add(key, count);
+        expected[key] += count;
+    }
+
+    // A budget of four entries forces many flushes; no count is lost or doubled
+    const size_t entryBytes = 12; // {key ID, count} plus its slot in the ID index
+    Combiner tiny(4 * entryBytes);
+    KeyValueBuffer combined;
+    size_t flushesSeen = 0;
+    bool withinBudget = true;
+    for (const auto& record : input) {
+        tiny.add(record.key(), record.value, combined);
+        withinBudget = withinBudget && tiny.getMemoryUsed() <= tiny.getMemoryBudget();
+        flushesSeen = tiny.getStats().flushes;
+    }
+    ASSERT_TRUE(withinBudget);
+    ASSERT_TRUE(flushesSeen > 10);
+    ASSERT_EQ(flushesSeen * 4, combined.size()); // Every budget flush writes a full table
+    tiny.flush(combined);
+    ASSERT_TRUE(sumByKey(combined) == expected);
+    ASSERT_EQ(input.size(), tiny.getStats().inputRecords);
+    ASSERT_EQ(combined.size(), tiny.getStats().outputRecords);
+    ASSERT_TRUE(combined.size() < input.size()); // Repeated keys still collapse between flushes
+    ASSERT_EQ(static_cast<size_t>(0), tiny.getMemoryUsed());
+
+    // With room for every key, each key comes out exactly once
+    Combiner roomy;
+    KeyValueBuffer once;
+    for (const auto& record : input) roomy.add(record.key(), record.value, once);
+    ASSERT_TRUE(once.empty()); // Nothing flushed before the final flush
+    roomy.flush(once);
+    ASSERT_EQ(expected.size(), once.size());
+    ASSERT_EQ(static_cast<size_t>(1), roomy.getStats().flushes);
+    ASSERT_TRUE(sumByKey(once) == expected);
+    roomy.flush(once); // An empty flush is not counted
+    ASSERT_EQ(static_cast<size_t>(1), roomy.getStats().flushes);
+
+    // Adding by key ID into an already interned buffer aggregates the same way
+    KeyValueBuffer byId;
+    byId.internKeys();
+    Combiner idCombiner(4 * entryBytes);
+    for (const auto& record : input) idCombiner.add(byId.intern(record.key()), record.value, byId);
+    idCombiner.flush(byId);
+    ASSERT_TRUE(sumByKey(byId) == expected);
+    ASSERT_EQ(combined.size(), byId.size());
+}
@@ -0,0 +1,194 @@
+#include "../include/ControllerService.h"
+#include "TEST_Test_Framework.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// A worker that registers, then answers every job with `exitCode`. A worker
+// with dropAfter > 0 disconnects without answering its dropAfter-th job. A
+// straggler reports 1% progress and never finishes; a hung worker goes silent
+// after its first job. With heartbeatMs > 0 it heartbeats until then.
+struct FakeWorker {
+    int exitCode = 0;
+    int dropAfter = 0;
+    bool straggler = false;
+    bool hangs = false;
+    int heartbeatMs = 0;
+    std::vector<std::string> ran; // "map 3", "reduce 1", ...
+    std::vector<uint32_t> attempts;
+
+    void run(uint16_t port, uint32_t slots, std::mutex& orderMutex, std::vector<std::string>& order) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return;
+        std::string error;
+        std::mutex sendMutex;
+        auto send = [&](FrameType type, uint32_t requestId, const std::string& payload) {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            std::string sendError;
+            FrameProtocol::sendFrame(fd, type, requestId, payload, sendError);
+        };
+        send(FrameType::REGISTER, 0, FrameProtocol::encode(WorkerInfo{slots, "fake"}));
+        std::atomic<bool> beating{heartbeatMs > 0};
+        std::thread heartbeat([&]() {
+            while (beating) {
+                send(FrameType::HEARTBEAT, 0, FrameProtocol::encode(WorkerHeartbeat{}));
+                std::this_thread::sleep_for(std::chrono::milliseconds(heartbeatMs));
+            }
+        });
+        FrameReader reader;
+        Frame frame;
+        int jobs = 0;
+        while (reader.receive(fd, frame, error)) {
+            if (frame.type == FrameType::SHUTDOWN) break;
+            if (frame.type != FrameType::JOB_ASSIGNMENT) continue;
+            TaskAssignment task;
+            FrameProtocol::decode(frame.payload, task);
+            if (dropAfter > 0 && ++jobs == dropAfter) break;
+            std::string name = task.command + " " + task.args[0];
+            ran.push_back(name);
+            attempts.push_back(task.attempt);
+            {
+                std::lock_guard<std::mutex> lock(orderMutex);
+                order.push_back(name);
+            }
+            send(FrameType::STATUS, frame.requestId, "job started");
+            if (hangs) beating = false;
+            if (straggler) send(FrameType::PROGRESS, frame.requestId, FrameProtocol::encode(TaskProgress{1, 100, 0}));
+            if (hangs || straggler) continue;
+            send(FrameType::RESULT_MANIFEST, frame.requestId, FrameProtocol::encode(TaskResult{exitCode, "published/" + task.args[0]}));
+        }
+        beating = false;
+        heartbeat.join();
+        close(fd);
+    }
+};
+
+TEST_CASE(ControllerServiceTests) {
+    std::string error;
+
+    // Three workers share six maps and then three reduces; one drops its second job
+    {
+        ControllerService service;
+        ASSERT_TRUE(service.listen(0, error));
+        ASSERT_TRUE(service.port() != 0);
+        service.setMinWorkers(3);
+        for (int m = 0; m < 6; ++m) service.submit(TaskAssignment{"map", {std::to_string(m)}});
+        service.nextStage();
+        for (int r = 0; r < 3; ++r) service.submit(TaskAssignment{"reduce", {std::to_string(r)}});
+
+        std::mutex orderMutex;
+        std::vector<std::string> order;
+        std::vector<FakeWorker> fakes(3);
+        fakes[2].dropAfter = 2;
+        std::vector<std::thread> threads;
+        for (auto& fake : fakes) {
+            threads.emplace_back([&service, &fake, &orderMutex, &order]() { fake.run(service.port(), 2, orderMutex, order); });
+        }
+
+        ASSERT_TRUE(service.runUntilDone(error));
+        ASSERT_EQ(static_cast<size_t>(9), service.outcomes().size());
+        service.shutdownWorkers();
+        for (auto& thread : threads) thread.join();
+
+        // Every task ran exactly once, and no reduce started before the last map finished
+        ASSERT_EQ(static_cast<size_t>(9), order.size());
+        size_t lastMap = 0, firstReduce = order.size();
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (order[i].rfind("map", 0) == 0) lastMap = i;
+            else if (firstReduce == order.size()) firstReduce = i;
+        }
+        ASSERT_TRUE(lastMap < firstReduce);
+        ASSERT_TRUE(!fakes[0].ran.empty());
+        ASSERT_TRUE(!fakes[1].ran.empty());
+        ASSERT_EQ(static_cast<size_t>(1), fakes[2].ran.size()); // Its dropped job went to another worker
+        ASSERT_TRUE(service.outcomes()[0].result.manifestPath.rfind("published/", 0) == 0);
+    }
+
+    // A failing task fails the run instead of hanging it
+    {
+        ControllerService service;
+        ASSERT_TRUE(service.listen(0, error));
+        service.submit(TaskAssignment{"map", {"0"}});
+        service.submit(TaskAssignment{"map", {"1"}});
+        std::mutex orderMutex;
+        std::vector<std::string> order;
+        FakeWorker failing;
+        failing.exitCode = 3;
+        std::thread worker([&]() { failing.run(service.port(), 1, orderMutex, order); });
+        error.clear();
+        ASSERT_TRUE(!service.runUntilDone(error));
+        ASSERT_TRUE(error.find("exit code 3") != std::string::npos);
+        service.shutdownWorkers();
+        worker.join();
+    }
+
+    // A worker that stops heartbeating is dropped and its task reassigned
+    {
+        ControllerService service;
+        ASSERT_TRUE(service.listen(0, error));
+        ControllerService::Policy policy;
+        policy.heartbeatTimeout = std::chrono::milliseconds(300);
+        policy.speculate = false;
+        service.setPolicy(policy);
+        service.setMinWorkers(2);
+        service.submit(TaskAssignment{"map", {"0"}});
+        service.submit(TaskAssignment{"map", {"1"}});
+        std::mutex orderMutex;
+        std::vector<std::string> order;
+        std::vector<FakeWorker> fakes(2);
+        fakes[0].heartbeatMs = fakes[1].heartbeatMs = 50;
+        fakes[1].hangs = true;
+        std::vector<std::thread> threads;
+        for (auto& fake : fakes) {
+            threads.emplace_back([&service, &fake, &orderMutex, &order]() { fake.run(service.port(), 1, orderMutex, order); });
+        }
+        error.clear();
+        ASSERT_TRUE(service.runUntilDone(error));
+        ASSERT_EQ(static_cast<size_t>(2), service.outcomes().size());
+        ASSERT_EQ(static_cast<size_t>(2), fakes[0].ran.size());
+        ASSERT_EQ(static_cast<uint32_t>(1), fakes[0].attempts.back()); // The reassigned copy is attempt 1
+        service.shutdownWorkers();
+        for (auto& thread : threads) thread.join();
+    }
+
+    // A task whose progress rate is far below the stage median gets a backup
+    // copy on another worker, and the first copy to finish completes it
+    {
+        ControllerService service;
+        ASSERT_TRUE(service.listen(0, error));
+        ControllerService::Policy policy;
+        policy.minRuntime = std::chrono::milliseconds(50);
+        service.setPolicy(policy);
+        service.setMinWorkers(2);
+        for (int m = 0; m < 3; ++m) service.submit(TaskAssignment{"map", {std::to_string(m)}});
+        std::mutex orderMutex;
+        std::vector<std::string> order;
+        std::vector<FakeWorker> fakes(2);
+        fakes[1].straggler = true;
+        std::thread fast([&]() { fakes[0].run(service.port(), 2, orderMutex, order); });
+        std::thread slow([&]() { fakes[1].run(service.port(), 1, orderMutex, order); });
+        error.clear();
+        ASSERT_TRUE(service.runUntilDone(error));
+        ASSERT_EQ(static_cast<size_t>(3), service.outcomes().size());
+        ASSERT_EQ(static_cast<size_t>(1), service.backupsLaunched());
+        ASSERT_EQ(static_cast<size_t>(1), fakes[1].ran.size());
+        ASSERT_EQ(static_cast<size_t>(3), fakes[0].ran.size());
+        ASSERT_TRUE(fakes[0].ran.back() == fakes[1].ran[0]);
+        ASSERT_EQ(static_cast<uint32_t>(1), fakes[0].attempts.back());
+        ASSERT_TRUE(service.outcomes().back().backup);
+        service.shutdownWorkers();
+        fast.join();
+        slow.join();
+    }
+}
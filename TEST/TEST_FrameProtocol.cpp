@@ -0,0 +1,106 @@
+#include "../include/FrameProtocol.h"
+#include "TEST_Test_Framework.h"
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST_CASE(FrameProtocolTests) {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    std::string error;
+
+    // A job with far more than 1 KiB of arguments arrives whole
+    TaskAssignment job;
+    job.command = "map";
+    for (int i = 0; i < 500; ++i) job.args.push_back("./inputFolder/file_with_a_long_name_" + std::to_string(i) + ".txt");
+    ASSERT_TRUE(FrameProtocol::sendFrame(fds[0], FrameType::JOB_ASSIGNMENT, 7, FrameProtocol::encode(job), error));
+
+    // Back-to-back frames stay separate even when read in one call
+    ASSERT_TRUE(FrameProtocol::sendFrame(fds[0], FrameType::HEARTBEAT, 8, {}, error));
+    ASSERT_TRUE(FrameProtocol::sendFrame(fds[0], FrameType::STATUS, 7, "job started", error));
+    ASSERT_TRUE(FrameProtocol::sendFrame(fds[0], FrameType::PROGRESS, 7, FrameProtocol::encode(TaskProgress{3, 10}), error));
+    ASSERT_TRUE(FrameProtocol::sendFrame(fds[0], FrameType::RESULT_MANIFEST, 7,
+                                         FrameProtocol::encode(TaskResult{0, "temp/manifests/mapper_1.manifest"}), error));
+
+    FrameReader reader;
+    Frame frame;
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    ASSERT_TRUE(frame.type == FrameType::JOB_ASSIGNMENT);
+    ASSERT_EQ(static_cast<uint32_t>(7), frame.requestId);
+    TaskAssignment received;
+    ASSERT_TRUE(FrameProtocol::decode(frame.payload, received));
+    ASSERT_TRUE(received.command == "map");
+    ASSERT_EQ(job.args.size(), received.args.size());
+    ASSERT_TRUE(received.args.back() == job.args.back());
+
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    ASSERT_TRUE(frame.type == FrameType::HEARTBEAT);
+    ASSERT_EQ(static_cast<uint32_t>(8), frame.requestId);
+    ASSERT_TRUE(frame.payload.empty());
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    ASSERT_TRUE(frame.type == FrameType::STATUS && frame.payload == "job started");
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    TaskProgress progress;
+    ASSERT_TRUE(FrameProtocol::decode(frame.payload, progress));
+    ASSERT_EQ(static_cast<uint64_t>(3), progress.done);
+    ASSERT_EQ(static_cast<uint64_t>(10), progress.total);
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    TaskResult result;
+    ASSERT_TRUE(FrameProtocol::decode(frame.payload, result));
+    ASSERT_EQ(0, result.exitCode);
+    ASSERT_TRUE(result.manifestPath == "temp/manifests/mapper_1.manifest");
+
+    // A large payload written from another thread, and frames trickled in one byte at a time
+    std::string big(3 * 1024 * 1024 + 17, 'x');
+    big[12345] = 'y';
+    std::thread writer([&]() {
+        std::string writeError;
+        FrameProtocol::sendFrame(fds[0], FrameType::STATUS, 9, big, writeError);
+        char header[FrameProtocol::HEADER_SIZE];
+        FrameProtocol::encodeHeader(header, FrameType::STATUS, 10, 2);
+        std::string trickled = std::string(header, sizeof(header)) + "ok";
+        for (char byte : trickled) ASSERT_EQ(static_cast<ssize_t>(1), write(fds[0], &byte, 1));
+    });
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    ASSERT_EQ(big.size(), frame.payload.size());
+    ASSERT_TRUE(frame.payload == big);
+    ASSERT_TRUE(reader.receive(fds[1], frame, error));
+    ASSERT_EQ(static_cast<uint32_t>(10), frame.requestId);
+    ASSERT_TRUE(frame.payload == "ok");
+    writer.join();
+
+    // Truncated payloads do not decode
+    std::string encoded = FrameProtocol::encode(job);
+    ASSERT_TRUE(!FrameProtocol::decode(std::string_view(encoded).substr(0, encoded.size() - 1), received));
+
+    // Attempt numbers and heartbeats carrying per-task progress round-trip
+    job.attempt = 2;
+    ASSERT_TRUE(FrameProtocol::decode(FrameProtocol::encode(job), received));
+    ASSERT_EQ(static_cast<uint32_t>(2), received.attempt);
+    WorkerHeartbeat heartbeat;
+    heartbeat.tasks.emplace_back(5, TaskProgress{100, 400, 17});
+    heartbeat.tasks.emplace_back(6, TaskProgress{});
+    WorkerHeartbeat decoded;
+    ASSERT_TRUE(FrameProtocol::decode(FrameProtocol::encode(heartbeat), decoded));
+    ASSERT_EQ(static_cast<size_t>(2), decoded.tasks.size());
+    ASSERT_EQ(static_cast<uint32_t>(5), decoded.tasks[0].first);
+    ASSERT_EQ(static_cast<uint64_t>(400), decoded.tasks[0].second.total);
+    ASSERT_EQ(static_cast<uint64_t>(17), decoded.tasks[0].second.records);
+    ASSERT_TRUE(FrameProtocol::decode(std::string_view(), decoded)); // A bare probe reply
+    ASSERT_TRUE(decoded.tasks.empty());
+
+    // A stream that is not this protocol is rejected rather than misparsed
+    ASSERT_EQ(static_cast<ssize_t>(20), write(fds[0], "map ./temp 0 2 a.txt", 20));
+    ASSERT_TRUE(!reader.receive(fds[1], frame, error));
+    ASSERT_TRUE(!error.empty());
+
+    // An orderly close between frames is not an error
+    close(fds[0]);
+    FrameReader fresh;
+    error.clear();
+    ASSERT_TRUE(!fresh.receive(fds[1], frame, error));
+    ASSERT_TRUE(error.empty());
+    close(fds[1]);
+}
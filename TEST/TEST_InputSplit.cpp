@@ -0,0 +1,124 @@
+#include "../include/InputSplit.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::string writeFile(const fs::path& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary) << text;
+    return path.string();
+}
+
+// Concatenates what the splits cover, in order, so gaps and overlaps show up
+static std::string coveredText(const std::string& text, const std::vector<InputSplit>& splits) {
+    std::string covered;
+    for (const auto& split : splits) covered += text.substr(split.offset, split.length);
+    return covered;
+}
+
+TEST_CASE(InputSplitTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_InputSplit";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // Cuts land just after a '\n': every line is covered exactly once
+    std::string lines;
+    for (int i = 0; i < 200; ++i) lines += "line " + std::to_string(i) + " of some text\n";
+    std::string linesPath = writeFile(dir / "lines.txt", lines);
+    std::vector<InputSplit> splits = InputSplitPlanner::plan({linesPath}, 100);
+    ASSERT_TRUE(splits.size() > 10);
+    bool aligned = true;
+    size_t expectedOffset = 0;
+    for (const auto& split : splits) {
+        aligned = aligned && split.offset == expectedOffset && split.length > 0 && lines[split.offset + split.length - 1] == '\n';
+        expectedOffset = split.offset + split.length;
+    }
+    ASSERT_TRUE(aligned);
+    ASSERT_EQ(lines.size(), expectedOffset);
+    ASSERT_TRUE(coveredText(lines, splits) == lines);
+
+    // No trailing newline: the last split runs to end of file
+    std::string unterminated = lines + "last line without newline";
+    std::string unterminatedPath = writeFile(dir / "unterminated.txt", unterminated);
+    splits = InputSplitPlanner::plan({unterminatedPath}, 100);
+    ASSERT_TRUE(coveredText(unterminated, splits) == unterminated);
+    ASSERT_EQ(unterminated.size(), splits.back().offset + splits.back().length);
+    ASSERT_TRUE(splits.back().length > 0);
+
+    // A line longer than the split size stays whole
+    std::string longLine = std::string(500, 'x') + "\nshort\n";
+    std::string longPath = writeFile(dir / "long.txt", longLine);
+    splits = InputSplitPlanner::plan({longPath}, 100);
+    ASSERT_EQ(static_cast<size_t>(2), splits.size());
+    ASSERT_EQ(static_cast<size_t>(501), splits[0].length);
+
+    // An empty file, a split size larger than the file, and split size 0 keep whole files
+    std::string emptyPath = writeFile(dir / "empty.txt", "");
+    splits = InputSplitPlanner::plan({emptyPath, linesPath}, lines.size() + 1);
+    ASSERT_EQ(static_cast<size_t>(2), splits.size());
+    ASSERT_TRUE(splits[0].filePath == emptyPath && splits[0].offset == 0 && splits[0].length == 0);
+    ASSERT_TRUE(splits[1].offset == 0 && splits[1].length == lines.size());
+    ASSERT_EQ(static_cast<size_t>(1), InputSplitPlanner::plan({linesPath}, 0).size());
+
+    // Missing files are skipped
+    ASSERT_TRUE(InputSplitPlanner::plan({(dir / "missing.txt").string()}, 100).empty());
+
+    // toString / parse round trip, including a file name that looks like a split itself
+    std::string trickyPath = writeFile(dir / "data@12+34", "a\nb\n");
+    InputSplit original{trickyPath, 2, 2};
+    InputSplit parsed = InputSplit::parse(original.toString());
+    ASSERT_TRUE(parsed.filePath == trickyPath);
+    ASSERT_EQ(static_cast<size_t>(2), parsed.offset);
+    ASSERT_EQ(static_cast<size_t>(2), parsed.length);
+    splits = InputSplitPlanner::plan({trickyPath}, 0);
+    parsed = InputSplit::parse(splits[0].toString());
+    ASSERT_TRUE(parsed.filePath == trickyPath && parsed.offset == 0 && parsed.length == 4);
+
+    // A plain path, or one whose suffix is not a valid range, covers the whole file
+    parsed = InputSplit::parse(linesPath);
+    ASSERT_TRUE(parsed.filePath == linesPath && parsed.offset == 0 && parsed.length == MappedFile::WHOLE_FILE);
+    parsed = InputSplit::parse("notes@x+1");
+    ASSERT_TRUE(parsed.filePath == "notes@x+1" && parsed.length == MappedFile::WHOLE_FILE);
+    parsed = InputSplit::parse("notes@1+");
+    ASSERT_TRUE(parsed.filePath == "notes@1+" && parsed.length == MappedFile::WHOLE_FILE);
+
+    // assign balances bytes across mappers and keeps each mapper's splits in file order
+    std::vector<InputSplit> sized;
+    for (size_t i = 0; i < 40; ++i) sized.push_back({"file" + std::to_string(i % 3), i * 1000, 100 + (i * 37) % 400});
+    size_t totalBytes = 0;
+    for (const auto& split : sized) totalBytes += split.length;
+    const int numMappers = 4;
+    std::vector<std::vector<InputSplit>> assignments = InputSplitPlanner::assign(sized, numMappers);
+    ASSERT_EQ(static_cast<size_t>(numMappers), assignments.size());
+    size_t assignedSplits = 0;
+    size_t maxLoad = 0;
+    bool ordered = true;
+    for (const auto& mapperSplits : assignments) {
+        size_t load = 0;
+        for (size_t i = 0; i < mapperSplits.size(); ++i) {
+            load += mapperSplits[i].length;
+            if (i > 0 && mapperSplits[i - 1].filePath == mapperSplits[i].filePath) {
+                ordered = ordered && mapperSplits[i - 1].offset < mapperSplits[i].offset;
+            }
+        }
+        assignedSplits += mapperSplits.size();
+        maxLoad = std::max(maxLoad, load);
+    }
+    ASSERT_EQ(sized.size(), assignedSplits);
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(maxLoad <= totalBytes / numMappers + 500); // Within one split of the average
+
+    // More mappers than splits: the extra mappers get nothing; no mappers, no assignments
+    assignments = InputSplitPlanner::assign({sized[0], sized[1]}, 5);
+    ASSERT_EQ(static_cast<size_t>(5), assignments.size());
+    size_t busy = 0;
+    for (const auto& mapperSplits : assignments) busy += mapperSplits.empty() ? 0 : 1;
+    ASSERT_EQ(static_cast<size_t>(2), busy);
+    ASSERT_TRUE(InputSplitPlanner::assign(sized, 0).empty());
+
+    fs::remove_all(dir);
+}
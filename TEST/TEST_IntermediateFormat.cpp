@@ -0,0 +1,131 @@
+#include "../include/IntermediateFormat.h"
+#include "../include/FileHandler.h"
+#include "TEST_Test_Framework.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using Records = std::vector<std::pair<std::string, int>>;
+
+static std::string encode(const Records& records, size_t blockSize) {
+    IntermediateFormat::Writer writer(blockSize);
+    for (const auto& record : records) writer.add(record.first, record.second);
+    return writer.finish();
+}
+
+static Records toRecords(const KeyValueBuffer& buffer) {
+    Records records;
+    for (const auto& record : buffer) records.emplace_back(std::string(record.key()), record.value);
+    return records;
+}
+
+static bool decode(const std::string& bytes, Records& records, std::string& error) {
+    return IntermediateFormat::forEachRecord(bytes, [&records](std::string_view key, int count) {
+        records.emplace_back(std::string(key), count);
+    }, error);
+}
+
+TEST_CASE(IntermediateFormatTests) {
+    Records records = {{"the", 1}, {"", 0}, {"negative", -42}, {std::string(300, 'x'), 2147483647}, {"min", -2147483647 - 1}};
+    for (int i = 0; i < 1000; ++i) records.emplace_back("word" + std::to_string(i), i);
+
+    // Round trip with one block and with many small blocks
+    for (size_t blockSize : {IntermediateFormat::DEFAULT_BLOCK_SIZE, size_t(16)}) {
+        std::string bytes = encode(records, blockSize);
+        ASSERT_TRUE(IntermediateFormat::isBinary(bytes));
+        Records decoded;
+        std::string error;
+        ASSERT_TRUE(decode(bytes, decoded, error));
+        ASSERT_TRUE(decoded == records);
+    }
+
+    // Concatenated segments, including an empty one, decode in order
+    Records first(records.begin(), records.begin() + 10);
+    Records second(records.begin() + 10, records.end());
+    std::string concatenated = encode(first, 64) + encode({}, 64) + encode(second, 64);
+    Records decoded;
+    std::string error;
+    ASSERT_TRUE(decode(concatenated, decoded, error));
+    ASSERT_TRUE(decoded == records);
+
+    // A flipped payload byte fails the checksum before any record is delivered
+    std::string corrupt = encode(records, 64);
+    corrupt[IntermediateFormat::HEADER_SIZE + 5] ^= 0x01;
+    decoded.clear();
+    ASSERT_TRUE(!decode(corrupt, decoded, error));
+    ASSERT_TRUE(decoded.empty());
+
+    // Truncated segments are rejected
+    std::string truncated = encode(records, 64);
+    truncated.resize(truncated.size() - 1);
+    decoded.clear();
+    ASSERT_TRUE(!decode(truncated, decoded, error));
+
+    // Dictionary-encoded segments store each key once and decode to the same records
+    Records repeated;
+    for (int i = 0; i < 3000; ++i) repeated.emplace_back("key" + std::to_string(i / 10), i % 4 - 1);
+    repeated.emplace_back(std::string(300, 'y'), 1);
+    repeated.emplace_back(std::string(300, 'y'), 2);
+    for (size_t blockSize : {IntermediateFormat::DEFAULT_BLOCK_SIZE, size_t(16)}) {
+        IntermediateFormat::Writer writer(blockSize, IntermediateFormat::FLAG_SORTED | IntermediateFormat::FLAG_DICTIONARY);
+        for (const auto& record : repeated) writer.add(record.first, record.second);
+        std::string bytes = writer.finish();
+        ASSERT_TRUE(bytes.size() < encode(repeated, blockSize).size());
+        Records fromDictionary;
+        ASSERT_TRUE(decode(bytes, fromDictionary, error));
+        ASSERT_TRUE(fromDictionary == repeated);
+    }
+    {
+        IntermediateFormat::Writer writer(64, IntermediateFormat::FLAG_DICTIONARY);
+        for (const auto& record : repeated) writer.add(record.first, record.second);
+        std::string bytes = writer.finish();
+        bytes[bytes.size() - 2] = static_cast<char>(0x7F); // Last record's key index, now out of range
+        IntermediateFormat::putFixed<uint32_t>(&bytes[28], IntermediateFormat::crc32(bytes.data() + IntermediateFormat::HEADER_SIZE,
+                                                                                  bytes.size() - IntermediateFormat::HEADER_SIZE));
+        decoded.clear();
+        ASSERT_TRUE(!decode(bytes, decoded, error));
+    }
+
+    // Version 1 segments are still read; unknown versions are not
+    std::string versionOne = encode(first, 64);
+    IntermediateFormat::putFixed<uint16_t>(&versionOne[4], 1);
+    decoded.clear();
+    ASSERT_TRUE(decode(versionOne, decoded, error));
+    ASSERT_TRUE(decoded == first);
+    IntermediateFormat::putFixed<uint16_t>(&versionOne[4], IntermediateFormat::VERSION + 1);
+    ASSERT_TRUE(!decode(versionOne, decoded, error));
+
+    // FileHandler reads binary files, appended segments and legacy text files alike
+    fs::path dir = fs::temp_directory_path() / "TEST_IntermediateFormat";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::string binaryPath = (dir / "partition_0.txt").string();
+    ASSERT_TRUE(IntermediateFormat::appendToFile(binaryPath, encode(first, 64), error));
+    ASSERT_TRUE(IntermediateFormat::appendToFile(binaryPath, encode(second, 64), error));
+    KeyValueBuffer fromFile;
+    ASSERT_TRUE(FileHandler::read_mapped_data(binaryPath, fromFile));
+    ASSERT_TRUE(toRecords(fromFile) == records);
+
+    std::string textPath = (dir / "partition_1.txt").string();
+    {
+        std::ofstream text(textPath);
+        text << "alpha\t3\nbeta\t-1\n";
+    }
+    KeyValueBuffer fromText;
+    ASSERT_TRUE(FileHandler::read_mapped_data(textPath, fromText));
+    ASSERT_TRUE(toRecords(fromText) == (Records{{"alpha", 3}, {"beta", -1}}));
+
+    std::string corruptPath = (dir / "partition_2.txt").string();
+    ASSERT_TRUE(IntermediateFormat::appendToFile(corruptPath, corrupt, error));
+    KeyValueBuffer fromCorrupt;
+    fromCorrupt.add("kept", 1);
+    ASSERT_TRUE(!FileHandler::read_mapped_data(corruptPath, fromCorrupt));
+    ASSERT_TRUE(toRecords(fromCorrupt) == (Records{{"kept", 1}}));
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,95 @@
+#include "../include/KeyValueBuffer.h"
+#include "../include/StableHash.h"
+#include "TEST_Test_Framework.h"
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+TEST_CASE(KeyValueBufferTests) {
+    KeyValueBuffer buffer;
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQ(static_cast<size_t>(0), buffer.memoryUsed());
+
+    // Keys are copied in; the caller's bytes may change afterwards
+    std::string scratch = "gamma";
+    buffer.add(scratch, 3);
+    scratch = "XXXXX";
+    buffer.add("alpha", 1);
+    buffer.add("", 7);
+    std::string big(KeyValueBuffer::CHUNK_SIZE + 10, 'b'); // Gets a chunk of its own
+    buffer.add(big, 2);
+    ASSERT_EQ(static_cast<size_t>(4), buffer.size());
+    ASSERT_TRUE(buffer[0].key() == "gamma");
+    ASSERT_EQ(3, buffer[0].value);
+    ASSERT_TRUE(buffer[2].key().empty());
+    ASSERT_TRUE(buffer[3].key() == big);
+    ASSERT_EQ(4 * sizeof(KeyValueBuffer::Record) + 10 + big.size(), buffer.memoryUsed());
+
+    // Keys stay put while later records fill more chunks
+    std::string_view first = buffer[0].key();
+    for (int i = 0; i < 100000; ++i) buffer.add("key" + std::to_string(i), i);
+    ASSERT_TRUE(first.data() == buffer[0].key().data() && first == "gamma");
+
+    // Sorting a suffix leaves the prefix alone
+    buffer.truncate(4);
+    buffer.add("delta", 4);
+    buffer.add("beta", 5);
+    buffer.sortByKey(4);
+    ASSERT_TRUE(buffer[0].key() == "gamma" && buffer[4].key() == "beta" && buffer[5].key() == "delta");
+    buffer.sortByKey();
+    std::vector<std::string> keys;
+    for (const auto& record : buffer) keys.emplace_back(record.key());
+    ASSERT_TRUE((keys == std::vector<std::string>{"", "alpha", big, "beta", "delta", "gamma"}));
+
+    // clear() empties the buffer and it fills again; moving keeps keys valid
+    buffer.clear();
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQ(static_cast<size_t>(0), buffer.memoryUsed());
+    buffer.add("again", 1);
+    KeyValueBuffer moved = std::move(buffer);
+    ASSERT_EQ(static_cast<size_t>(1), moved.size());
+    ASSERT_TRUE(moved[0].key() == "again");
+
+    // Interning keeps records already added and stores each distinct key once
+    KeyValueBuffer interned;
+    interned.add("the", 1);
+    interned.add("cat", 1);
+    interned.internKeys(42);
+    ASSERT_TRUE(interned.internsKeys());
+    ASSERT_EQ(static_cast<uint64_t>(42), interned.keyDictionary()->seed());
+    for (int i = 0; i < 1000; ++i) interned.add(i % 2 ? "the" : "cat", 1);
+    interned.add("", 1);
+    const KeyDictionary& dictionary = *interned.keyDictionary();
+    ASSERT_EQ(static_cast<size_t>(3), dictionary.size());
+    ASSERT_EQ(static_cast<uint32_t>(0), interned.keyId(0));
+    ASSERT_EQ(static_cast<uint32_t>(1), interned.keyId(1));
+    ASSERT_TRUE(interned[1000].key() == "cat" && interned[1000].key().data() == interned[1].key().data());
+    ASSERT_TRUE(interned[1001].key() == "the" && interned[1001].key().data() == interned[0].key().data());
+    ASSERT_TRUE(interned[1002].key().empty());
+    ASSERT_EQ(StableHash::hash(std::string_view("cat"), 42), dictionary.hash(1));
+    ASSERT_TRUE((dictionary.sortedIds() == std::vector<uint32_t>{2, 1, 0}));
+    ASSERT_EQ(interned.size() * (sizeof(KeyValueBuffer::Record) + sizeof(uint32_t)) + dictionary.memoryUsed(), interned.memoryUsed());
+
+    // IDs move with their records when sorting, and survive clear() but not clearKeys()
+    interned.sortByKey();
+    bool idsMatch = true;
+    for (size_t i = 0; i < interned.size(); ++i) idsMatch = idsMatch && dictionary.key(interned.keyId(i)) == interned[i].key();
+    ASSERT_TRUE(idsMatch);
+    interned.clear();
+    interned.add("the", 5);
+    ASSERT_EQ(static_cast<uint32_t>(0), interned.keyId(0));
+    interned.addInterned(interned.intern("dog"), 2);
+    ASSERT_TRUE(interned[1].key() == "dog" && interned[1].value == 2);
+    interned.clearKeys();
+    ASSERT_EQ(static_cast<size_t>(0), dictionary.size());
+    interned.add("dog", 1);
+    ASSERT_EQ(static_cast<uint32_t>(0), interned.keyId(0));
+
+    // A dictionary past many grow() calls still finds every key
+    KeyDictionary large;
+    for (int i = 0; i < 50000; ++i) large.intern("key" + std::to_string(i));
+    bool found = large.size() == 50000;
+    for (int i = 0; i < 50000; i += 7) found = found && large.intern("key" + std::to_string(i)) == static_cast<uint32_t>(i);
+    ASSERT_TRUE(found);
+}
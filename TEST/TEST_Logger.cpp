@@ -0,0 +1,148 @@
+#include "../include/Logger.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::vector<std::string> readLines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(line);
+    return lines;
+}
+
+TEST_CASE(LoggerTests) {
+    const std::string path = "TEST_Logger_output.log";
+    std::remove(path.c_str());
+    Logger& logger = Logger::getInstance();
+    logger.configureLogFilePath(path);
+    logger.setConsoleOutput(false);
+
+    // Synchronous mode: filtered levels never reach the file
+    logger.setMinimumLevel(Logger::Level::INFO);
+    ASSERT_TRUE(!logger.isEnabled(Logger::Level::DEBUG));
+    ASSERT_TRUE(logger.isEnabled(Logger::Level::ERROR));
+    logger.log("dropped", Logger::Level::DEBUG);
+    logger.log("kept", Logger::Level::WARNING);
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(static_cast<size_t>(1), lines.size());
+    ASSERT_TRUE(lines[0].find("] [WARNING] kept") != std::string::npos);
+    logger.setMinimumLevel(Logger::Level::DEBUG);
+
+    // Async mode: every line from every thread arrives, each thread's lines in order,
+    // including threads that exit and rings that fill up before the writer wakes
+    std::remove(path.c_str());
+    logger.configureLogFilePath(path);
+    logger.setAsync(true);
+    ASSERT_TRUE(logger.isAsync());
+    const int threads = 6;
+    const int perThread = 3 * static_cast<int>(Logger::RING_CAPACITY);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&logger, t]() {
+            for (int i = 0; i < perThread; ++i) logger.log("t" + std::to_string(t) + " " + std::to_string(i));
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    logger.log("after join", Logger::Level::ERROR);
+    logger.flush();
+    lines = readLines(path);
+    ASSERT_EQ(static_cast<size_t>(threads * perThread + 1), lines.size());
+
+    std::vector<int> next(threads, 0);
+    bool ordered = true;
+    for (const std::string& line : lines) {
+        size_t pos = line.find("] t");
+        if (pos == std::string::npos) continue;
+        int t = std::stoi(line.substr(pos + 3));
+        int i = std::stoi(line.substr(line.find(' ', pos + 3) + 1));
+        ordered = ordered && i == next[t]++;
+    }
+    ASSERT_TRUE(ordered);
+
+    // Stopping the writer writes whatever is still pending
+    logger.log("last");
+    logger.setAsync(false);
+    ASSERT_TRUE(!logger.isAsync());
+    lines = readLines(path);
+    ASSERT_TRUE(!lines.empty() && lines.back().find("[INFO] last") != std::string::npos);
+
+    // Messages logged while the writer is being stopped are not lost
+    std::remove(path.c_str());
+    logger.configureLogFilePath(path);
+    std::atomic<int> logged{0};
+    std::atomic<bool> stopLogging{false};
+    writers.clear();
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&logger, &logged, &stopLogging]() {
+            while (!stopLogging.load()) {
+                logger.log("racing");
+                ++logged;
+            }
+        });
+    }
+    for (int round = 0; round < 200; ++round) {
+        logger.setAsync(true);
+        std::this_thread::yield();
+        logger.setAsync(false);
+    }
+    stopLogging = true;
+    for (auto& writer : writers) writer.join();
+    logger.flush();
+    ASSERT_EQ(static_cast<size_t>(logged.load()), readLines(path).size());
+
+    // Format macros render every argument type in place of "{}"
+    std::remove(path.c_str());
+    logger.configureLogFilePath(path);
+    std::string word = "apple";
+    LOG_WARNING("line {} ('{}'): {} {} {}", 42, word, -7, 2.5, 'x');
+    LOG_INFO("{} extra {}", 1u); // A missing argument leaves its "{}"
+    lines = readLines(path);
+    ASSERT_EQ(static_cast<size_t>(2), lines.size());
+    ASSERT_TRUE(lines[0].find("[WARNING] line 42 ('apple'): -7 2.500000 x") != std::string::npos);
+    ASSERT_TRUE(lines[1].find("[INFO] 1 extra {}") != std::string::npos);
+
+    // Below the runtime minimum the arguments are never evaluated
+    logger.setMinimumLevel(Logger::Level::INFO);
+    int evaluated = 0;
+    LOG_DEBUG("{}", ++evaluated);
+    ASSERT_EQ(0, evaluated);
+    logger.setMinimumLevel(Logger::Level::DEBUG);
+
+    // Binary output decodes to exactly the lines text output would have written
+    const std::string binaryPath = path + Logger::BINARY_LOG_SUFFIX;
+    std::remove(path.c_str());
+    std::remove(binaryPath.c_str());
+    logger.configureLogFilePath(path);
+    logger.setOutputFormat(Logger::OutputFormat::BINARY);
+    logger.setPrefix("[BIN] ");
+    for (int i = 0; i < 3; ++i) LOG_INFO("record {} of {}", i, word);
+    logger.log("plain message", Logger::Level::ERROR);
+    logger.setAsync(true);
+    LOG_DEBUG("async {}", 3.0);
+    logger.setAsync(false);
+    logger.setOutputFormat(Logger::OutputFormat::TEXT);
+    logger.setPrefix("");
+    ASSERT_TRUE(readLines(path).empty());
+
+    std::ifstream binaryIn(binaryPath, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(binaryIn)), std::istreambuf_iterator<char>());
+    std::string decoded, error;
+    ASSERT_TRUE(Logger::decodeBinaryLog(bytes, decoded, error));
+    ASSERT_TRUE(decoded.find("] [INFO] [BIN] record 2 of apple\n") != std::string::npos);
+    ASSERT_TRUE(decoded.find("] [ERROR] [BIN] plain message\n") != std::string::npos);
+    ASSERT_TRUE(decoded.find("] [DEBUG] [BIN] async 3.000000\n") != std::string::npos);
+    ASSERT_EQ(static_cast<size_t>(5), static_cast<size_t>(std::count(decoded.begin(), decoded.end(), '\n')));
+
+    // A truncated record is reported instead of rendered
+    decoded.clear();
+    ASSERT_TRUE(!Logger::decodeBinaryLog(std::string_view(bytes).substr(0, bytes.size() - 1), decoded, error));
+    std::remove(binaryPath.c_str());
+    std::remove(path.c_str());
+}
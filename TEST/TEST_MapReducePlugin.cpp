@@ -0,0 +1,192 @@
+#include "../include/MapReducePlugin.h"
+#include "../include/ERROR_Handler.h"
+#include "../include/IntermediateFormat.h"
+#include "../include/Logger.h"
+#include "../include/Mapper_DLL_so.h"
+#include "../include/ProcessOrchestrator.h"
+#include "../include/Reducer_DLL_so.h"
+#include "../include/SortedRunMerger.h"
+#include "TEST_Test_Framework.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Map: one record per line, keyed by the line, counting its length.
+// Reduce: doubles every sum and drops keys starting with 'x'.
+static int lineLengths(const char* data, size_t size, MrOutput* out) {
+    size_t begin = 0;
+    for (size_t i = 0; i <= size; ++i) {
+        if (i < size && data[i] != '\n') continue;
+        if (i > begin && out->emit(out->host, data + begin, static_cast<uint32_t>(i - begin), static_cast<int64_t>(i - begin)) != 0) return 1;
+        begin = i + 1;
+    }
+    return 0;
+}
+
+static int doubleSums(const MrRecord* records, size_t count, MrOutput* out) {
+    for (size_t i = 0; i < count; ++i) {
+        if (records[i].key_length > 0 && records[i].key[0] == 'x') continue;
+        if (out->emit(out->host, records[i].key, records[i].key_length, 2 * records[i].value) != 0) return 1;
+    }
+    return 0;
+}
+
+static int reverseOrder(const MrRecord* records, size_t count, MrOutput* out) {
+    for (size_t i = count; i-- > 0;) out->emit(out->host, records[i].key, records[i].key_length, records[i].value);
+    return 0;
+}
+
+static int failing(const char*, size_t, MrOutput*) { return 7; }
+
+TEST_CASE(MapReducePluginTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_MapReducePlugin";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    std::string error;
+
+    // The output arena hands back every emitted record, keys copied
+    PluginOutput output;
+    std::string scratch = "alpha";
+    output.abi()->emit(output.abi()->host, scratch.data(), 5, 3);
+    scratch = "XXXXX";
+    output.abi()->emit(output.abi()->host, "be", 2, -1);
+    ASSERT_EQ(static_cast<size_t>(2), output.size());
+    ASSERT_TRUE(output.key(0) == "alpha");
+    ASSERT_EQ(static_cast<int64_t>(3), output.value(0));
+    ASSERT_TRUE(output.key(1) == "be");
+    output.clear();
+    ASSERT_TRUE(output.empty());
+
+    // Tables from another ABI version, or with no entry points, are refused
+    MrPlugin table{MR_PLUGIN_ABI_VERSION + 1, "future", &lineLengths, nullptr};
+    ASSERT_TRUE(!MapReducePlugin::fromTable(&table, error));
+    ASSERT_TRUE(error.find("ABI version") != std::string::npos);
+    table = MrPlugin{MR_PLUGIN_ABI_VERSION, "empty", nullptr, nullptr};
+    ASSERT_TRUE(!MapReducePlugin::fromTable(&table, error));
+    ASSERT_TRUE(!MapReducePlugin::fromTable(nullptr, error));
+
+    // A mapper with a map plugin emits whatever map_batch emits, through the combiner
+    table = MrPlugin{MR_PLUGIN_ABI_VERSION, "lines", &lineLengths, &doubleSums};
+    std::shared_ptr<const MapReducePlugin> plugin = MapReducePlugin::fromTable(&table, error);
+    ASSERT_TRUE(plugin != nullptr);
+    ASSERT_TRUE(plugin->hasMap() && plugin->hasReduce());
+    ErrorHandler errorHandler;
+    Mapper mapper(Logger::getInstance(), errorHandler);
+    mapper.setPlugin(plugin);
+    mapper.enableCombiner();
+    KeyValueBuffer mapped;
+    mapper.mapBuffer("doc", "Hello World\nxyz\nHello World\n", mapped);
+    mapper.flushCombiner(mapped);
+    std::map<std::string, int> counts;
+    for (const auto& record : mapped) counts[std::string(record.key())] += record.value;
+    ASSERT_EQ(static_cast<size_t>(2), counts.size());
+    ASSERT_EQ(22, counts["Hello World"]);
+    ASSERT_EQ(3, counts["xyz"]);
+    ASSERT_TRUE(!mapper.hasPluginError());
+
+    // A reducer with a reduce plugin writes what reduce_batch emits, batch after batch
+    std::string partition = (dir / "partition_m0_r0.txt").string();
+    std::vector<std::pair<std::string, int>> records;
+    for (int i = 0; i < static_cast<int>(ReducerDLLso::PLUGIN_BATCH_RECORDS) + 10; ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "k%06d", i);
+        records.emplace_back(key, 1);
+    }
+    records.emplace_back("xdropped", 5);
+    {
+        IntermediateFormat::Writer writer(IntermediateFormat::DEFAULT_BLOCK_SIZE, IntermediateFormat::FLAG_SORTED);
+        for (const auto& record : records) writer.add(record.first, record.second);
+        ASSERT_TRUE(IntermediateFormat::appendToFile(partition, writer.finish(), error));
+    }
+    std::string outputPath = (dir / "reducer_0.txt").string();
+    ReducerDLLso reducer;
+    reducer.setPlugin(plugin);
+    ASSERT_TRUE(reducer.reduceSortedRuns(std::vector<std::string>{partition}, outputPath));
+    std::ifstream in(outputPath);
+    std::string line, last;
+    size_t lines = 0;
+    while (std::getline(in, line)) {
+        ASSERT_TRUE(line.size() > 2 && line.substr(line.size() - 3) == ": 2");
+        last = line;
+        ++lines;
+    }
+    ASSERT_EQ(records.size() - 1, lines);
+    ASSERT_TRUE(last.rfind("k", 0) == 0);
+
+    // Output out of key order, and a failing batch, fail the task
+    table.reduce_batch = &reverseOrder;
+    reducer.setPlugin(MapReducePlugin::fromTable(&table, error));
+    ASSERT_TRUE(!reducer.reduceSortedRuns(std::vector<std::string>{partition}, outputPath));
+    table.map_batch = &failing;
+    Mapper failingMapper(Logger::getInstance(), errorHandler);
+    failingMapper.setPlugin(MapReducePlugin::fromTable(&table, error));
+    failingMapper.mapBuffer("doc", "text\n", mapped);
+    ASSERT_TRUE(failingMapper.hasPluginError());
+
+    // Libraries that are missing or not plugins are reported
+    ASSERT_TRUE(!MapReducePlugin::load((dir / "missing.so").string(), error));
+    ASSERT_TRUE(!error.empty());
+    { std::ofstream(dir / "not_a_plugin.so") << "text"; }
+    ASSERT_TRUE(!MapReducePlugin::load((dir / "not_a_plugin.so").string(), error));
+
+    // The example plugin, when go.sh has built it: loaded once per build of the file
+    if (fs::exists("FrequentWordsPlugin.so")) {
+        std::shared_ptr<const MapReducePlugin> loaded = MapReducePlugin::load("FrequentWordsPlugin.so", error);
+        ASSERT_TRUE(loaded != nullptr);
+        ASSERT_TRUE(loaded->name() == "frequent-words");
+        ASSERT_TRUE(MapReducePlugin::load("FrequentWordsPlugin.so", error) == loaded);
+        output.clear();
+        ASSERT_TRUE(loaded->mapBatch("The cat, the CAT and a dog\n", output));
+        ASSERT_EQ(static_cast<size_t>(6), output.size());
+        ASSERT_TRUE(output.key(3) == "cat");
+
+        // Range partitioning keeps a hot key on one reducer, so reduce_batch sees its whole count
+        ProcessOrchestratorDLL orchestrator;
+        orchestrator.getConfig().setPluginLibrary(fs::absolute("FrequentWordsPlugin.so").string());
+        orchestrator.getConfig().setPartitionScheme(PartitionScheme::RANGE);
+        const int numReducers = 3;
+        std::string tempDir = (dir / "temp").string();
+        std::string outputDir = (dir / "output").string();
+        fs::create_directories(outputDir);
+        std::vector<InputSplit> splits;
+        for (int m = 0; m < 2; ++m) {
+            std::string input = (dir / ("input" + std::to_string(m) + ".txt")).string();
+            std::ofstream text(input);
+            for (int i = 0; i < 200; ++i) text << "the ";
+            for (char a = 'a'; a <= 'f'; ++a) {
+                for (char b = 'a'; b <= 'j'; ++b) text << "\nw" << a << b << " w" << a << b;
+            }
+            text << "\n";
+            text.close();
+            splits.push_back(InputSplit{input, 0, static_cast<size_t>(fs::file_size(input))});
+        }
+        ASSERT_TRUE(orchestrator.planRangePartitions(splits, numReducers, tempDir));
+        PartitionManifest::clearJob(tempDir);
+        for (int m = 0; m < 2; ++m) {
+            ASSERT_TRUE(orchestrator.runMapper(tempDir, m, numReducers, std::vector<InputSplit>{splits[m]}, 1, 1));
+        }
+        size_t outputsWithThe = 0;
+        std::map<std::string, int> reduced;
+        for (int r = 0; r < numReducers; ++r) {
+            ASSERT_TRUE(orchestrator.runReducer(outputDir, tempDir, r, 1, 1));
+            std::ifstream reducerOutput(fs::path(outputDir) / ("reducer_" + std::to_string(r) + ".txt"));
+            std::string outputLine;
+            while (std::getline(reducerOutput, outputLine)) {
+                std::string key = outputLine.substr(0, outputLine.find(':'));
+                if (key == "the") ++outputsWithThe;
+                reduced[key] += std::stoi(outputLine.substr(outputLine.find(':') + 1));
+            }
+        }
+        ASSERT_EQ(static_cast<size_t>(1), outputsWithThe);
+        ASSERT_EQ(400, reduced["the"]);
+        ASSERT_EQ(static_cast<size_t>(61), reduced.size());
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,92 @@
+#include "../include/MappedFile.h"
+#include "TEST_Test_Framework.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::string writeFile(const fs::path& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary) << text;
+    return path.string();
+}
+
+static std::vector<std::string> linesOf(const MappedFile& file) {
+    std::vector<std::string> lines;
+    for (std::string_view line : file.lines()) lines.emplace_back(line);
+    return lines;
+}
+
+TEST_CASE(MappedFileTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_MappedFile";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // An empty file opens to an empty view with no lines or blocks (no zero-length mmap)
+    MappedFile file;
+    ASSERT_TRUE(file.open(writeFile(dir / "empty.txt", "")));
+    ASSERT_TRUE(file.empty());
+    ASSERT_EQ(static_cast<size_t>(0), file.size());
+    ASSERT_TRUE(file.lines().begin() == file.lines().end());
+    ASSERT_TRUE(file.blocks(16).begin() == file.blocks(16).end());
+
+    // Lines follow std::getline: '\r' kept, no extra empty line after a final '\n'
+    std::string text = "first\r\n\nthird line\nlast without newline";
+    ASSERT_TRUE(file.open(writeFile(dir / "lines.txt", text)));
+    ASSERT_TRUE(file.view() == text);
+    ASSERT_TRUE((linesOf(file) == std::vector<std::string>{"first\r", "", "third line", "last without newline"}));
+    ASSERT_TRUE(file.open(writeFile(dir / "terminated.txt", "a\nb\n")));
+    ASSERT_TRUE((linesOf(file) == std::vector<std::string>{"a", "b"}));
+
+    // A range at an offset that is not page-aligned views exactly those bytes,
+    // including one that crosses a page boundary, and is clamped to the file size
+    std::string big;
+    for (int i = 0; big.size() < 3 * 4096 + 100; ++i) big += "row " + std::to_string(i) + "\n";
+    std::string bigPath = writeFile(dir / "big.txt", big);
+    const size_t offsets[] = {1, 4095, 4097, 3 * 4096 + 7};
+    bool rangesMatch = true;
+    for (size_t offset : offsets) {
+        rangesMatch = rangesMatch && file.open(bigPath, offset, 200) && file.view() == big.substr(offset, 200);
+    }
+    ASSERT_TRUE(rangesMatch);
+    ASSERT_TRUE(file.open(bigPath, big.size() - 10, 1000));
+    ASSERT_TRUE(file.view() == big.substr(big.size() - 10));
+    ASSERT_TRUE(file.open(bigPath, big.size() + 5, 10));
+    ASSERT_TRUE(file.empty());
+
+    // Blocks end just after a '\n' even when the target size falls mid-line,
+    // and together cover the file exactly once
+    ASSERT_TRUE(file.open(bigPath));
+    std::vector<std::string_view> bigBlocks(file.blocks(1000).begin(), file.blocks(1000).end());
+    std::string rejoined;
+    bool blocksEndOnNewline = bigBlocks.size() > 1;
+    for (size_t i = 0; i < bigBlocks.size(); ++i) {
+        blocksEndOnNewline = blocksEndOnNewline && bigBlocks[i].back() == '\n' && (bigBlocks[i].size() >= 1000 || i + 1 == bigBlocks.size());
+        rejoined += bigBlocks[i];
+    }
+    ASSERT_TRUE(blocksEndOnNewline);
+    ASSERT_TRUE(rejoined == big);
+    ASSERT_TRUE(file.open(writeFile(dir / "midline.txt", "aaaa bbbb\ncc\ntail")));
+    std::vector<std::string> blocks;
+    for (std::string_view block : file.blocks(3)) blocks.emplace_back(block);
+    ASSERT_TRUE((blocks == std::vector<std::string>{"aaaa bbbb\n", "cc\n", "tail"}));
+
+    // Moving keeps the view valid; the moved-from file is empty
+    MappedFile moved = std::move(file);
+    ASSERT_TRUE(moved.view() == "aaaa bbbb\ncc\ntail");
+    ASSERT_TRUE(file.empty());
+
+    // A missing file fails, reports the path, and leaves the file empty
+    std::ostringstream captured;
+    std::streambuf* original = std::cerr.rdbuf(captured.rdbuf());
+    bool opened = moved.open((dir / "missing.txt").string());
+    std::cerr.rdbuf(original);
+    ASSERT_TRUE(!opened);
+    ASSERT_TRUE(moved.empty());
+    ASSERT_TRUE(captured.str().find("missing.txt") != std::string::npos);
+
+    fs::remove_all(dir);
+}
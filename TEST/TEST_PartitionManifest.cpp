@@ -0,0 +1,164 @@
+#include "../include/PartitionManifest.h"
+#include "../include/ERROR_Handler.h"
+#include "../include/Logger.h"
+#include "../include/Mapper_DLL_so.h"
+#include "../include/SortedRunMerger.h"
+#include "TEST_Test_Framework.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void writeStaging(const fs::path& dir, int mapperId, int reducerId, const std::string& contents) {
+    std::ofstream out(dir / (PartitionManifest::partitionFileName(mapperId, reducerId) + PartitionManifest::STAGING_SUFFIX), std::ios::binary);
+    out << contents;
+}
+
+TEST_CASE(PartitionManifestTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_PartitionManifest";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    std::string tempDir = dir.string();
+    std::string error;
+
+    ASSERT_EQ(std::string("partition_m3_r12.txt"), PartitionManifest::partitionFileName(3, 12));
+
+    // Nothing committed yet: no inputs, and staged files are invisible
+    writeStaging(dir, 1, 0, "b\t1\n");
+    std::vector<PartitionManifest::Entry> files;
+    ASSERT_TRUE(PartitionManifest::collectReducerInputs(tempDir, 0, files, error));
+    ASSERT_TRUE(files.empty());
+    ASSERT_TRUE(!PartitionManifest::isCommitted(tempDir, 1));
+
+    // Mapper 1 has records for reducers 0 and 2 only
+    writeStaging(dir, 1, 2, "c\t1\nd\t1\n");
+    PartitionManifest manifest;
+    ASSERT_TRUE(PartitionManifest::commit(tempDir, 1, 3, manifest, error));
+    ASSERT_TRUE(PartitionManifest::isCommitted(tempDir, 1));
+    ASSERT_EQ(static_cast<size_t>(2), manifest.getEntries().size());
+    ASSERT_TRUE(manifest.entriesFor(1).empty());
+    ASSERT_EQ(static_cast<uint64_t>(8), manifest.entriesFor(2)[0].bytes);
+    ASSERT_TRUE(fs::exists(dir / "partition_m1_r2.txt"));
+    ASSERT_TRUE(!fs::exists(dir / "partition_m1_r2.txt.tmp"));
+
+    PartitionManifest loaded;
+    ASSERT_TRUE(PartitionManifest::load(PartitionManifest::path(tempDir, 1), loaded, error));
+    ASSERT_EQ(1, loaded.getMapperId());
+    ASSERT_EQ(3, loaded.getNumReducers());
+    ASSERT_EQ(static_cast<size_t>(2), loaded.getEntries().size());
+    ASSERT_EQ(std::string("partition_m1_r0.txt"), loaded.entriesFor(0)[0].fileName);
+
+    // Mapper 0 commits later; inputs still come back in mapper order
+    writeStaging(dir, 0, 0, "a\t1\n");
+    ASSERT_TRUE(PartitionManifest::commit(tempDir, 0, 3, manifest, error));
+    files.clear();
+    ASSERT_TRUE(PartitionManifest::collectReducerInputs(tempDir, 0, files, error));
+    ASSERT_EQ(static_cast<size_t>(2), files.size());
+    ASSERT_EQ((dir / "partition_m0_r0.txt").string(), files[0].fileName);
+    ASSERT_EQ((dir / "partition_m1_r0.txt").string(), files[1].fileName);
+    ASSERT_TRUE(!files[0].inSpillFile());
+
+    // A retried mapper drops its stale staging files and republishes
+    writeStaging(dir, 0, 1, "stale\t1\n");
+    PartitionManifest::clearStaging(tempDir, 0, 3);
+    ASSERT_TRUE(!fs::exists(dir / "partition_m0_r1.txt.tmp"));
+
+    // A corrupt manifest is reported rather than skipped
+    {
+        std::ofstream out(PartitionManifest::path(tempDir, 2));
+        out << "mapper 2 reducers 3\nnot an entry\n";
+    }
+    files.clear();
+    ASSERT_TRUE(!PartitionManifest::collectReducerInputs(tempDir, 0, files, error));
+    ASSERT_TRUE(!error.empty());
+
+    // clearJob removes manifests and every per-mapper partition
+    PartitionManifest::clearJob(tempDir);
+    ASSERT_TRUE(!fs::exists(dir / PartitionManifest::MANIFEST_DIR));
+    ASSERT_TRUE(!fs::exists(dir / "partition_m0_r0.txt"));
+    ASSERT_TRUE(!fs::exists(dir / "partition_m1_r2.txt"));
+
+    // Indexed layout: every export appends one segment per non-empty reducer to a
+    // single spill file, and each reducer maps only its own byte ranges
+    {
+        const int reducers = 4;
+        ErrorHandler errorHandler;
+        Mapper mapper(Logger::getInstance(), errorHandler);
+        std::string spillPath = (dir / (PartitionManifest::spillFileName(7) + PartitionManifest::STAGING_SUFFIX)).string();
+        mapper.setIndexedSpillFile(spillPath);
+        std::map<std::string, long long> expected;
+        for (int spill = 0; spill < 3; ++spill) {
+            KeyValueBuffer records;
+            for (int i = 0; i < 200; ++i) {
+                std::string key = "w" + std::to_string((i * 7 + spill) % 150);
+                records.add(key, spill + 1);
+                expected[key] += spill + 1;
+            }
+            ASSERT_TRUE(mapper.exportPartitionedData(tempDir, records, reducers, "unused_", ".txt"));
+        }
+        ASSERT_TRUE(!fs::exists(dir / "unused_0.txt"));
+        ASSERT_TRUE(mapper.getSpillIndex().size() > static_cast<size_t>(reducers));
+
+        std::vector<PartitionManifest::Entry> segments;
+        uint64_t indexedBytes = 0;
+        for (const Mapper::SpillExtent& extent : mapper.getSpillIndex()) {
+            segments.push_back(PartitionManifest::Entry{extent.reducerId, "", extent.bytes, extent.offset});
+            indexedBytes += extent.bytes;
+        }
+        ASSERT_EQ(static_cast<uint64_t>(fs::file_size(spillPath)), indexedBytes);
+        ASSERT_TRUE(PartitionManifest::commitIndexed(tempDir, 7, reducers, segments, manifest, error));
+        ASSERT_TRUE(fs::exists(dir / "partition_m7.spill"));
+        ASSERT_TRUE(!fs::exists(spillPath));
+
+        std::map<std::string, long long> merged;
+        for (int r = 0; r < reducers; ++r) {
+            std::vector<PartitionManifest::Entry> inputs;
+            ASSERT_TRUE(PartitionManifest::collectReducerInputs(tempDir, r, inputs, error));
+            SortedRunMerger merger;
+            for (const auto& input : inputs) {
+                ASSERT_TRUE(input.inSpillFile());
+                ASSERT_TRUE(merger.addFile(input.fileName, input.offset, input.bytes));
+            }
+            ASSERT_TRUE(merger.merge([&](std::string_view key, long long sum) { merged[std::string(key)] += sum; }));
+        }
+        ASSERT_TRUE(merged == expected);
+
+        // A range that does not start on a segment is rejected
+        SortedRunMerger merger;
+        ASSERT_TRUE(!merger.addFile((dir / "partition_m7.spill").string(), 1, 64));
+
+        // Retries drop the staged spill file too
+        { std::ofstream out(spillPath); out << "partial"; }
+        PartitionManifest::clearStaging(tempDir, 7, reducers);
+        ASSERT_TRUE(!fs::exists(spillPath));
+    }
+
+    // Two attempts of one mapper stage under different names; the first to
+    // commit wins and the loser's files are dropped
+    {
+        PartitionManifest::clearJob(tempDir);
+        ASSERT_EQ(std::string("partition_m4a2_r1.txt"), PartitionManifest::partitionFileName(4, 1, 2));
+        std::ofstream(dir / (PartitionManifest::partitionFileName(4, 0, 1) + PartitionManifest::STAGING_SUFFIX)) << "backup\t1\n";
+        std::ofstream(dir / (PartitionManifest::partitionFileName(4, 0, 0) + PartitionManifest::STAGING_SUFFIX)) << "original\t1\n";
+        ASSERT_TRUE(PartitionManifest::commit(tempDir, 4, 2, manifest, error, 1));
+        ASSERT_EQ(static_cast<uint32_t>(1), manifest.getAttempt());
+        ASSERT_TRUE(PartitionManifest::commit(tempDir, 4, 2, manifest, error, 0));
+        ASSERT_EQ(static_cast<uint32_t>(1), manifest.getAttempt()); // Adopted the backup's manifest
+        ASSERT_TRUE(!fs::exists(dir / "partition_m4_r0.txt"));
+        ASSERT_TRUE(fs::exists(dir / "partition_m4a1_r0.txt"));
+
+        PartitionManifest loaded;
+        ASSERT_TRUE(PartitionManifest::load(PartitionManifest::path(tempDir, 4), loaded, error));
+        ASSERT_EQ(static_cast<uint32_t>(1), loaded.getAttempt());
+        files.clear();
+        ASSERT_TRUE(PartitionManifest::collectReducerInputs(tempDir, 0, files, error));
+        ASSERT_EQ(static_cast<size_t>(1), files.size());
+        ASSERT_EQ((dir / "partition_m4a1_r0.txt").string(), files[0].fileName);
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,53 @@
+#include "../include/Partitioner.h"
+#include "../include/StableHash.h"
+#include "TEST_Test_Framework.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE(PartitionerTests) {
+    // Published XXH64 reference values: the hash must not drift across builds
+    ASSERT_EQ(0xEF46DB3751D8E999ULL, StableHash::hash(std::string_view("")));
+    ASSERT_EQ(0xD24EC4F1A98C6E5BULL, StableHash::hash(std::string_view("a")));
+    ASSERT_EQ(0x44BC2CF5AD770999ULL, StableHash::hash(std::string_view("abc")));
+    ASSERT_EQ(0xCFE1F278FA89835CULL, StableHash::hash(std::string_view("abcdefghijklmnopqrstuvwxyz")));
+    ASSERT_TRUE(StableHash::hash(std::string_view("abc"), 1) != StableHash::hash(std::string_view("abc"), 0));
+
+    // fastRange stays in range at the extremes
+    ASSERT_EQ(0u, StableHash::fastRange(0, 7));
+    ASSERT_EQ(6u, StableHash::fastRange(~0ULL, 7));
+
+    // Batch and single-key bucketing agree, and every bucket is used evenly
+    const int reducers = 7;
+    Partitioner partitioner(reducers, 42);
+    KeyValueBuffer records;
+    for (int i = 0; i < 70000; ++i) records.add("key" + std::to_string(i), 1);
+    std::vector<uint32_t> buckets;
+    partitioner.getReducerBuckets(records, buckets);
+    ASSERT_EQ(records.size(), buckets.size());
+
+    bool agrees = true;
+    std::vector<size_t> load(reducers, 0);
+    for (size_t i = 0; i < records.size(); ++i) {
+        agrees = agrees && static_cast<int>(buckets[i]) == partitioner.getReducerBucket(records[i].key());
+        ++load[buckets[i]];
+    }
+    ASSERT_TRUE(agrees);
+    bool balanced = true;
+    for (size_t count : load) balanced = balanced && count > 9000 && count < 11000;
+    ASSERT_TRUE(balanced);
+
+    // Interned keys use the dictionary's cached hash when the seeds match, and are rehashed when not
+    for (uint64_t dictionarySeed : {uint64_t(42), uint64_t(7)}) {
+        KeyValueBuffer interned;
+        interned.internKeys(dictionarySeed);
+        for (size_t i = 0; i < records.size(); ++i) interned.add(records[i].key(), 1);
+        std::vector<uint32_t> internedBuckets;
+        partitioner.getReducerBuckets(interned, internedBuckets);
+        ASSERT_TRUE(internedBuckets == buckets);
+    }
+
+    // A pluggable hash replaces the default
+    Partitioner constant(reducers, 0, [](const void*, size_t, uint64_t) -> uint64_t { return 0; });
+    ASSERT_EQ(0, constant.getReducerBucket("anything"));
+}
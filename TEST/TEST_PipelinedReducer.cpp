@@ -0,0 +1,123 @@
+#include "../include/ProcessOrchestrator.h"
+#include "../include/IntermediateFormat.h"
+#include "../include/Logger.h"
+#include "../include/PartitionManifest.h"
+#include "TEST_Test_Framework.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// Stages one sorted partition per (reducer, records) pair and commits mapper
+// `mapperId`'s manifest, the way a mapper does when it finishes.
+static bool commitMapper(const std::string& tempDir, int mapperId, int numReducers,
+                         const std::map<int, std::vector<std::pair<std::string, int>>>& partitions) {
+    std::string error;
+    for (const auto& partition : partitions) {
+        IntermediateFormat::Writer writer(IntermediateFormat::DEFAULT_BLOCK_SIZE, IntermediateFormat::FLAG_SORTED);
+        for (const auto& record : partition.second) writer.add(record.first, record.second);
+        fs::path staging = fs::path(tempDir) / (PartitionManifest::partitionFileName(mapperId, partition.first) + PartitionManifest::STAGING_SUFFIX);
+        if (!IntermediateFormat::appendToFile(staging.string(), writer.finish(), error)) return false;
+    }
+    PartitionManifest manifest;
+    return PartitionManifest::commit(tempDir, mapperId, numReducers, manifest, error);
+}
+
+static std::map<std::string, long> readOutput(const fs::path& path) {
+    std::map<std::string, long> counts;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t colon = line.rfind(": ");
+        if (colon != std::string::npos) counts[line.substr(0, colon)] += std::stol(line.substr(colon + 2));
+    }
+    return counts;
+}
+
+TEST_CASE(PipelinedReducerTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_PipelinedReducer";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "temp");
+    const std::string tempDir = (dir / "temp").string();
+    const std::string outputDir = (dir / "output").string();
+    const fs::path resultPath = dir / "orphan_result.txt";
+    Logger::getInstance().configureLogFilePath((dir / "reducer.log").string());
+    const int numReducers = 2;
+
+    // A mapper that never commits: the reducer keeps waiting until its
+    // controller exits, then fails. Run in a grandchild whose parent exits,
+    // before this process starts any threads.
+    ASSERT_TRUE(commitMapper(tempDir, 0, numReducers, {{0, {{"apple", 1}}}}));
+    int ready[2];
+    ASSERT_EQ(0, pipe(ready));
+    pid_t controller = fork();
+    if (controller == 0) {
+        pid_t reducer = fork();
+        if (reducer == 0) {
+            ProcessOrchestratorDLL orphaned;
+            bool ok = orphaned.runPipelinedReducer((dir / "orphan").string(), tempDir, 0, 2);
+            std::ofstream(resultPath) << (ok ? "succeeded" : "failed");
+            _exit(0);
+        }
+        ssize_t written = write(ready[1], &reducer, sizeof(reducer));
+        (void)written;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200)); // Let the reducer start waiting
+        _exit(0);
+    }
+    pid_t orphan = -1;
+    ASSERT_TRUE(read(ready[0], &orphan, sizeof(orphan)) == static_cast<ssize_t>(sizeof(orphan)));
+    close(ready[0]);
+    close(ready[1]);
+    waitpid(controller, nullptr, 0);
+    for (int i = 0; i < 200 && !fs::exists(resultPath); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    std::this_thread::sleep_for(std::chrono::milliseconds(25)); // The result is written before _exit
+    std::string result;
+    std::ifstream(resultPath) >> result;
+    if (result.empty()) kill(orphan, SIGKILL);
+    ASSERT_TRUE(result == "failed");
+    ASSERT_TRUE(!fs::exists(dir / "orphan" / "reducer_0.txt"));
+
+    // Partitions are picked up as manifests commit; the reducer finishes only
+    // once every mapper has committed, whatever the commit order
+    ProcessOrchestratorDLL orchestrator;
+    std::atomic<bool> done{false};
+    bool succeeded = false;
+    std::thread reducer([&]() {
+        succeeded = orchestrator.runPipelinedReducer(outputDir, tempDir, 0, 3);
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE(!done.load()); // Mappers 1 and 2 have not committed
+
+    // Mapper 2 has nothing for reducer 0
+    ASSERT_TRUE(commitMapper(tempDir, 2, numReducers, {{1, {{"zebra", 9}}}}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE(!done.load());
+    ASSERT_TRUE(!fs::exists(fs::path(outputDir) / "reducer_0.txt"));
+
+    ASSERT_TRUE(commitMapper(tempDir, 1, numReducers, {{0, {{"apple", 2}, {"banana", 5}}}}));
+    reducer.join();
+    ASSERT_TRUE(succeeded);
+    std::map<std::string, long> counts = readOutput(fs::path(outputDir) / "reducer_0.txt");
+    ASSERT_EQ(static_cast<size_t>(2), counts.size());
+    ASSERT_EQ(3L, counts["apple"]);
+    ASSERT_EQ(5L, counts["banana"]);
+
+    // Reducer 1 sees only mapper 2's partition; all three manifests are already there
+    ASSERT_TRUE(orchestrator.runPipelinedReducer(outputDir, tempDir, 1, 3));
+    counts = readOutput(fs::path(outputDir) / "reducer_1.txt");
+    ASSERT_EQ(static_cast<size_t>(1), counts.size());
+    ASSERT_EQ(9L, counts["zebra"]);
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,84 @@
+#include "../include/ProcessLauncher.h"
+#include "TEST_Test_Framework.h"
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+// Runs fn in a forked child and reports how the child ended
+template <typename Fn>
+static ProcessLauncher::ExitStatus runInChild(Fn fn) {
+    ProcessLauncher::ExitStatus status;
+    pid_t pid = fork();
+    if (pid == 0) _exit(fn());
+    if (pid < 0) return status;
+    ProcessLauncher::waitAny(status);
+    return status;
+}
+
+TEST_CASE(ProcessLauncherTests) {
+    ASSERT_TRUE(ProcessLauncher::supported());
+
+    // Exit codes of spawned children are reported per pid
+    std::string error;
+    ProcessLauncher::ProcessId ok = ProcessLauncher::spawn("/bin/true", {}, error);
+    ProcessLauncher::ProcessId failed = ProcessLauncher::spawn("/bin/false", {}, error);
+    ProcessLauncher::ProcessId exits = ProcessLauncher::spawn("/bin/sh", {"-c", "exit 7"}, error);
+    ASSERT_TRUE(ok > 0 && failed > 0 && exits > 0);
+    std::map<ProcessLauncher::ProcessId, ProcessLauncher::ExitStatus> statuses;
+    ProcessLauncher::ExitStatus status;
+    while (ProcessLauncher::waitAny(status)) statuses[status.pid] = status;
+    ASSERT_EQ(static_cast<size_t>(3), statuses.size());
+    ASSERT_TRUE(statuses[ok].succeeded());
+    ASSERT_EQ(1, statuses[failed].exitCode);
+    ASSERT_TRUE(!statuses[failed].succeeded());
+    ASSERT_EQ(7, statuses[exits].exitCode);
+    ASSERT_TRUE(ProcessLauncher::describe(statuses[exits]).find("exited with code 7") != std::string::npos);
+    ASSERT_TRUE(!ProcessLauncher::waitAny(status)); // No children left
+
+    // A missing executable fails to spawn with a message
+    ASSERT_EQ(-1, ProcessLauncher::spawn("/nonexistent/worker", {}, error));
+    ASSERT_TRUE(error.find("/nonexistent/worker") != std::string::npos);
+
+    // A terminated child reports the signal
+    ProcessLauncher::ProcessId sleeper = ProcessLauncher::spawn("/bin/sleep", {"10"}, error);
+    ASSERT_TRUE(sleeper > 0);
+    ProcessLauncher::terminate(sleeper);
+    ASSERT_TRUE(ProcessLauncher::waitAny(status));
+    ASSERT_EQ(SIGTERM, status.signal);
+    ASSERT_TRUE(!status.succeeded());
+
+    // Limits are applied to the calling process: RLIMIT_AS makes a large allocation fail
+    status = runInChild([]() {
+        WorkerLimits limits;
+        limits.memoryBytes = 256ull * 1024 * 1024;
+        std::string limitError;
+        if (!ProcessLauncher::applyLimits(limits, limitError)) return 2;
+        struct rlimit applied{};
+        getrlimit(RLIMIT_AS, &applied);
+        if (applied.rlim_cur != limits.memoryBytes) return 3;
+        try {
+            volatile char* block = new char[512ull * 1024 * 1024];
+            block[0] = 1;
+            return 4; // The limit did not hold
+        } catch (const std::bad_alloc&) {
+            return 0;
+        }
+    });
+    ASSERT_TRUE(status.succeeded());
+
+    // RLIMIT_CPU stops a busy child with SIGXCPU (or SIGKILL at the hard limit)
+    status = runInChild([]() {
+        WorkerLimits limits;
+        limits.cpuSeconds = 1;
+        std::string limitError;
+        if (!ProcessLauncher::applyLimits(limits, limitError)) return 2;
+        volatile unsigned long spin = 0;
+        for (;;) ++spin;
+    });
+    ASSERT_TRUE(status.signal == SIGXCPU || status.signal == SIGKILL);
+    ASSERT_TRUE(status.cpuSeconds >= 0.9);
+
+    // No limits is a no-op
+    ASSERT_TRUE(ProcessLauncher::applyLimits(WorkerLimits(), error));
+}
@@ -0,0 +1,92 @@
+#include "../include/RangePartitioner.h"
+#include "../include/KeyValueBuffer.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE(RangePartitionerTests) {
+    // Zipf-like sample: "the" alone is about 40% of all records
+    KeyValueBuffer sample;
+    sample.add("the", 4000);
+    for (int i = 0; i < 600; ++i) sample.add("w" + std::to_string(1000 + i), 10);
+
+    const int reducers = 5;
+    RangePartitioner ranges = RangePartitioner::fromSample(reducers, sample);
+    ASSERT_TRUE(!ranges.empty());
+    ASSERT_EQ(static_cast<size_t>(reducers - 1), ranges.getBoundaries().size());
+    ASSERT_TRUE(std::is_sorted(ranges.getBoundaries().begin(), ranges.getBoundaries().end()));
+
+    // The hot key gets two reducers of its own and its records alternate between them
+    std::pair<uint32_t, uint32_t> span = ranges.getReducerSpan("the");
+    ASSERT_EQ(2u, span.second);
+    uint32_t first = ranges.getReducerBucket("the");
+    uint32_t second = ranges.getReducerBucket("the");
+    ASSERT_TRUE(first != second && first >= span.first && second < span.first + span.second);
+
+    // Buckets never decrease with the key, so reducer outputs concatenate in sorted order
+    KeyValueBuffer records;
+    for (const auto& record : sample) records.add(record.key(), record.value);
+    records.add("a", 1);
+    records.add("zzz", 1);
+    records.sortByKey();
+    std::vector<uint32_t> buckets;
+    ranges.getReducerBuckets(records, buckets);
+    bool ordered = true;
+    for (size_t i = 1; i < buckets.size(); ++i) {
+        ordered = ordered && (buckets[i] >= buckets[i - 1] || records[i].key() == records[i - 1].key());
+    }
+    ASSERT_TRUE(ordered);
+
+    // Interned keys bucket the same, hot keys still alternating
+    KeyValueBuffer interned;
+    interned.internKeys();
+    for (const auto& record : records) interned.add(record.key(), record.value);
+    interned.add("the", 1);
+    std::vector<uint32_t> internedBuckets;
+    ranges.getReducerBuckets(interned, internedBuckets);
+    bool same = internedBuckets.size() == records.size() + 1;
+    for (size_t i = 0; same && i < records.size(); ++i) {
+        same = internedBuckets[i] == buckets[i] || records[i].key() == "the";
+    }
+    ASSERT_TRUE(same);
+    size_t theRecord = 0;
+    while (records[theRecord].key() != "the") ++theRecord;
+    ASSERT_TRUE(internedBuckets.back() != internedBuckets[theRecord]);
+
+    // Replaying the sample, no reducer gets more than 1.25x the average weight
+    std::vector<double> load(reducers, 0.0);
+    double total = 0;
+    for (const auto& record : sample) {
+        for (int copy = 0; copy < record.value; ++copy) load[ranges.getReducerBucket(record.key())] += 1;
+        total += record.value;
+    }
+    ASSERT_TRUE(*std::max_element(load.begin(), load.end()) <= 1.25 * total / reducers);
+
+    // Boundaries survive a save/load round trip
+    std::string path = "TEST_RangePartitioner_boundaries.txt";
+    std::string error;
+    ASSERT_TRUE(ranges.save(path, error));
+    RangePartitioner loaded;
+    ASSERT_TRUE(RangePartitioner::load(path, loaded, error));
+    ASSERT_EQ(reducers, loaded.getNumReducers());
+    ASSERT_TRUE(loaded.getBoundaries() == ranges.getBoundaries());
+    std::remove(path.c_str());
+
+    // Without splitting, the hot key keeps one reducer and every record goes there
+    RangePartitioner whole = RangePartitioner::fromSample(reducers, sample, false);
+    ASSERT_TRUE(!whole.splitsHotKeys());
+    ASSERT_EQ(static_cast<size_t>(reducers - 1), whole.getBoundaries().size());
+    ASSERT_TRUE(std::is_sorted(whole.getBoundaries().begin(), whole.getBoundaries().end()));
+    ASSERT_EQ(1u, whole.getReducerSpan("the").second);
+    ASSERT_EQ(whole.getReducerBucket("the"), whole.getReducerBucket("the"));
+    ranges.setSplitHotKeys(false);
+    ASSERT_EQ(1u, ranges.getReducerSpan("the").second);
+    ASSERT_EQ(ranges.getReducerBucket("the"), ranges.getReducerBucket("the"));
+
+    // Nothing to plan from
+    ASSERT_TRUE(RangePartitioner::fromSample(reducers, KeyValueBuffer()).empty());
+    ASSERT_TRUE(RangePartitioner::fromSample(1, sample).empty());
+}
@@ -0,0 +1,100 @@
+#include "../include/ReducerOutputMerger.h"
+#include "TEST_Test_Framework.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::string readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+static void writeReducerOutput(const fs::path& path, const std::map<std::string, long long>& counts) {
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& entry : counts) out << entry.first << ": " << entry.second << "\n";
+}
+
+TEST_CASE(ReducerOutputMergerTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_ReducerOutputMerger";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // Disjoint reducer outputs, except "hot" which a range partitioner split over two of them
+    std::mt19937 rng(7);
+    const int reducers = 5;
+    std::vector<std::map<std::string, long long>> outputs(reducers);
+    std::map<std::string, long long> expected;
+    for (int i = 0; i < 4000; ++i) {
+        std::string key = "k" + std::to_string(rng() % 100000);
+        long long count = 1 + rng() % 50;
+        outputs[std::hash<std::string>()(key) % reducers][key] += count;
+        expected[key] += count;
+    }
+    outputs[1]["hot"] = 500;
+    outputs[2]["hot"] = 700;
+    expected["hot"] = 1200;
+    for (int r = 0; r < reducers; ++r) writeReducerOutput(dir / ("reducer_" + std::to_string(r) + ".txt"), outputs[r]);
+
+    std::string expectedOutput, expectedSummed;
+    for (const auto& entry : expected) {
+        expectedOutput += entry.first + ": " + std::to_string(entry.second) + "\n";
+        expectedSummed += "<\"" + entry.first + "\", " + std::to_string(entry.second) + ">\n";
+    }
+
+    // Small ranges and a small window force many tasks and several write waves
+    ThreadPool pool(4, 4);
+    std::string error;
+    {
+        ReducerOutputMerger merger;
+        for (int r = 0; r < reducers; ++r) ASSERT_TRUE(merger.addFile((dir / ("reducer_" + std::to_string(r) + ".txt")).string()));
+        ASSERT_TRUE(merger.mergeTo((dir / "output.txt").string(), (dir / "output_summed.txt").string(), pool, 3, error, 2048));
+        ASSERT_TRUE(merger.rangeCount() > 3);
+        ASSERT_EQ(expected.size(), merger.keyCount());
+    }
+    ASSERT_TRUE(readFile(dir / "output.txt") == expectedOutput);
+    ASSERT_TRUE(readFile(dir / "output_summed.txt") == expectedSummed);
+    ASSERT_TRUE(!fs::exists(dir / "output.txt.tmp"));
+
+    // One range covers everything when the inputs are small
+    {
+        ReducerOutputMerger merger;
+        for (int r = 0; r < reducers; ++r) ASSERT_TRUE(merger.addFile((dir / ("reducer_" + std::to_string(r) + ".txt")).string()));
+        ASSERT_TRUE(merger.mergeTo((dir / "output.txt").string(), (dir / "output_summed.txt").string(), pool, 4, error));
+        ASSERT_EQ(static_cast<size_t>(1), merger.rangeCount());
+    }
+    ASSERT_TRUE(readFile(dir / "output.txt") == expectedOutput);
+
+    // An unsorted input is detected and sorted in memory
+    {
+        std::ofstream out(dir / "reducer_5.txt", std::ios::binary);
+        out << "zeta: 2\nalpha: 3\nhot: 1\n";
+    }
+    {
+        ReducerOutputMerger merger;
+        for (int r = 0; r <= reducers; ++r) ASSERT_TRUE(merger.addFile((dir / ("reducer_" + std::to_string(r) + ".txt")).string()));
+        ASSERT_TRUE(merger.mergeTo((dir / "output.txt").string(), (dir / "output_summed.txt").string(), pool, 2, error, 2048));
+    }
+    std::string merged = readFile(dir / "output.txt");
+    ASSERT_TRUE(merged.rfind("alpha: 3\n", 0) == 0);
+    ASSERT_TRUE(merged.find("\nhot: 1201\n") != std::string::npos);
+    ASSERT_TRUE(merged.size() >= 8 && merged.compare(merged.size() - 8, 8, "zeta: 2\n") == 0);
+
+    // No inputs: both outputs exist and are empty
+    {
+        ReducerOutputMerger merger;
+        ASSERT_TRUE(merger.mergeTo((dir / "output.txt").string(), (dir / "output_summed.txt").string(), pool, 2, error));
+        ASSERT_EQ(static_cast<size_t>(0), merger.keyCount());
+    }
+    ASSERT_TRUE(readFile(dir / "output_summed.txt").empty());
+
+    pool.shutdown();
+    fs::remove_all(dir);
+}
@@ -0,0 +1,70 @@
+#include "../include/Reducer_DLL_so.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Records = std::vector<std::pair<std::string, int>>;
+
+static KeyValueBuffer randomRecords(size_t count, size_t distinctKeys, unsigned seed) {
+    std::mt19937 rng(seed);
+    KeyValueBuffer records;
+    records.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t id = rng() % distinctKeys;
+        // Mix short (small-string) and long keys
+        std::string key = (id % 7 == 0) ? "a-rather-long-key-that-spills-to-the-heap-" + std::to_string(id) : "k" + std::to_string(id);
+        records.add(key, static_cast<int>(rng() % 3) + 1);
+    }
+    records.add("", 5); // Empty keys are keys too
+    return records;
+}
+
+static std::map<std::string, int> referenceReduce(const KeyValueBuffer& records) {
+    std::map<std::string, int> reduced;
+    for (const auto& record : records) reduced[std::string(record.key())] += record.value;
+    return reduced;
+}
+
+TEST_CASE(ReducerTests) {
+    ReducerDLLso reducer;
+
+    // Below and above the parallel threshold, with one and several threads
+    for (size_t count : {size_t(1000), ReducerDLLso::PARALLEL_REDUCE_MIN_RECORDS * 4}) {
+        KeyValueBuffer records = randomRecords(count, count / 10, static_cast<unsigned>(count));
+        std::map<std::string, int> expected = referenceReduce(records);
+        for (size_t threads : {size_t(1), size_t(3), size_t(8)}) {
+            std::map<std::string, int> reduced;
+            reducer.reduce(records, reduced, threads, threads);
+            ASSERT_TRUE(reduced == expected);
+        }
+
+        // Growing threads (min < max) exercises the pool's on-demand workers
+        std::map<std::string, int> grown;
+        reducer.reduce(records, grown, 1, 6);
+        ASSERT_TRUE(grown == expected);
+
+        // Reducing into a non-empty map adds to existing counts
+        std::map<std::string, int> accumulated = {{"k1", 100}, {"zzz-only-here", 1}};
+        std::map<std::string, int> expectedAccumulated = expected;
+        expectedAccumulated["k1"] += 100;
+        expectedAccumulated["zzz-only-here"] += 1;
+        reducer.reduce(records, accumulated, 4, 4);
+        ASSERT_TRUE(accumulated == expectedAccumulated);
+
+        // Unsorted buffer output holds the same keys and sums; sorted output is in key order
+        KeyValueBuffer unsorted;
+        reducer.reduceToVector(records, unsorted, false, 4, 4);
+        ASSERT_EQ(expected.size(), unsorted.size());
+        Records sums;
+        for (const auto& record : unsorted) sums.emplace_back(std::string(record.key()), record.value);
+        std::sort(sums.begin(), sums.end());
+        ASSERT_TRUE(sums == Records(expected.begin(), expected.end()));
+        KeyValueBuffer sorted;
+        reducer.reduceToVector(records, sorted, true, 4, 4);
+        ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.key() < b.key(); }));
+    }
+}
@@ -0,0 +1,104 @@
+#include "../include/SortedRunMerger.h"
+#include "../include/IntermediateFormat.h"
+#include "../include/Reducer_DLL_so.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using Records = std::vector<std::pair<std::string, int>>;
+
+static std::string sortedSegment(Records records) {
+    std::sort(records.begin(), records.end());
+    IntermediateFormat::Writer writer(128, IntermediateFormat::FLAG_SORTED);
+    for (const auto& record : records) writer.add(record.first, record.second);
+    return writer.finish();
+}
+
+static std::vector<std::pair<std::string, long long>> mergeAll(SortedRunMerger& merger, bool& ok) {
+    std::vector<std::pair<std::string, long long>> merged;
+    ok = merger.merge([&merged](std::string_view key, long long sum) { merged.emplace_back(std::string(key), sum); });
+    return merged;
+}
+
+TEST_CASE(SortedRunMergerTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_SortedRunMerger";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // Random runs with many duplicate keys, spread over several files and segments
+    std::mt19937 rng(42);
+    std::map<std::string, long long> expected;
+    std::vector<std::string> paths;
+    std::string error;
+    for (int file = 0; file < 3; ++file) {
+        std::string path = (dir / ("partition_" + std::to_string(file) + ".txt")).string();
+        for (int run = 0; run < 4; ++run) {
+            Records records;
+            for (int i = 0; i < 500; ++i) {
+                std::string key = "k" + std::to_string(rng() % 300);
+                int count = static_cast<int>(rng() % 5) - 1;
+                records.emplace_back(key, count);
+                expected[key] += count;
+            }
+            ASSERT_TRUE(IntermediateFormat::appendToFile(path, sortedSegment(records), error));
+        }
+        ASSERT_TRUE(IntermediateFormat::appendToFile(path, sortedSegment({}), error));
+        paths.push_back(path);
+    }
+
+    // A legacy text partition is sorted in memory and merged with the rest
+    std::string textPath = (dir / "partition_text.txt").string();
+    {
+        std::ofstream text(textPath);
+        text << "zeta\t2\nk7\t10\nalpha\t1\nzeta\t3\n";
+    }
+    expected["zeta"] += 5;
+    expected["k7"] += 10;
+    expected["alpha"] += 1;
+    paths.push_back(textPath);
+
+    SortedRunMerger merger;
+    for (const auto& path : paths) ASSERT_TRUE(merger.addFile(path));
+    ASSERT_EQ(size_t(13), merger.runCount());
+
+    bool ok = false;
+    auto merged = mergeAll(merger, ok);
+    ASSERT_TRUE(ok);
+    ASSERT_TRUE((merged == std::vector<std::pair<std::string, long long>>(expected.begin(), expected.end())));
+
+    // A corrupt run is rejected when the file is added
+    std::string corrupt = sortedSegment({{"a", 1}, {"b", 2}});
+    corrupt[IntermediateFormat::HEADER_SIZE + 2] ^= 0x01;
+    std::string corruptPath = (dir / "partition_corrupt.txt").string();
+    ASSERT_TRUE(IntermediateFormat::appendToFile(corruptPath, corrupt, error));
+    SortedRunMerger rejecting;
+    ASSERT_TRUE(!rejecting.addFile(corruptPath));
+    ASSERT_EQ(size_t(0), rejecting.runCount());
+
+    // The reducer streams the merge into its "key: sum" output
+    std::string outputPath = (dir / "reducer_0.txt").string();
+    ReducerDLLso reducer;
+    ASSERT_TRUE(reducer.reduceSortedRuns(paths, outputPath));
+    std::ifstream output(outputPath);
+    std::string line;
+    size_t lines = 0;
+    bool matches = true;
+    auto it = expected.begin();
+    while (std::getline(output, line)) {
+        matches = matches && it != expected.end() && line == it->first + ": " + std::to_string(it->second);
+        ++lines;
+        if (it != expected.end()) ++it;
+    }
+    ASSERT_TRUE(matches);
+    ASSERT_EQ(expected.size(), lines);
+
+    fs::remove_all(dir);
+}
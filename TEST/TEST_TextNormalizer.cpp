@@ -0,0 +1,86 @@
+#include "../include/TextNormalizer.h"
+#include "../include/Tokenizer.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// The original Mapper::map pipeline: istringstream split, ispunct removal, tolower.
+static std::vector<std::string> referenceWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        while (iss >> word) {
+            word.erase(std::remove_if(word.begin(), word.end(), [](unsigned char c) {
+                return std::ispunct(c);
+            }), word.end());
+            std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) -> unsigned char {
+                return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+            });
+            if (!word.empty()) words.push_back(word);
+        }
+    }
+    return words;
+}
+
+static std::string normalizeWith(TextNormalizer::Kernel kernel, const std::string& text) {
+    std::string out(text.size(), '\0');
+    out.resize(TextNormalizer::normalizeWith(kernel, text.data(), text.size(), &out[0]));
+    return out;
+}
+
+static std::vector<std::string> tokenize(const std::string& text) {
+    std::vector<std::string> words;
+    Tokenizer::forEachWord(text, [&words](std::string_view word) { words.emplace_back(word); });
+    return words;
+}
+
+static void checkText(const std::string& label, const std::string& text) {
+    const std::vector<std::string> expected = referenceWords(text);
+    const std::string scalar = normalizeWith(TextNormalizer::Kernel::SCALAR, text);
+
+    ASSERT_TRUE(tokenize(text) == expected);
+    ASSERT_TRUE(tokenize(scalar) == expected);
+
+    for (TextNormalizer::Kernel kernel : {TextNormalizer::Kernel::SSE42, TextNormalizer::Kernel::AVX2}) {
+        if (!TextNormalizer::isSupported(kernel)) {
+            std::cout << "[SKIP] " << label << ": " << TextNormalizer::kernelName(kernel) << " not supported\n";
+            continue;
+        }
+        ASSERT_TRUE(normalizeWith(kernel, text) == scalar);
+    }
+}
+
+TEST_CASE(TextNormalizerTests) {
+    std::cout << "Active kernel: " << TextNormalizer::kernelName(TextNormalizer::activeKernel()) << "\n";
+
+    // Every byte value, at every alignment, so the vector tails are covered.
+    std::string allBytes;
+    for (int c = 0; c < 256; ++c) allBytes.push_back(static_cast<char>(c));
+    for (size_t offset = 0; offset < 33; ++offset) {
+        checkText("all-bytes+" + std::to_string(offset), allBytes.substr(offset) + "Don't STOP--now " + allBytes.substr(0, offset));
+    }
+
+    const char* inputDir = std::getenv("MAPREDUCE_TEST_INPUT");
+    fs::path inputFolder = inputDir ? fs::path(inputDir) : fs::path("inputFolder");
+    ASSERT_TRUE(fs::is_directory(inputFolder));
+    if (!fs::is_directory(inputFolder)) return;
+
+    for (const auto& entry : fs::directory_iterator(inputFolder)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".txt") continue;
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::cout << "Checking " << entry.path().filename().string() << " (" << text.size() << " bytes)\n";
+        checkText(entry.path().filename().string(), text);
+    }
+}
@@ -0,0 +1,208 @@
+#include "../include/ThreadPool.h"
+#include "TEST_Test_Framework.h"
+#include <atomic>
+#include <stdexcept>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Blocks until `target` tasks have signalled completion
+class Countdown {
+public:
+    explicit Countdown(size_t target) : remaining(target) {}
+    void done() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--remaining == 0) condition.notify_all();
+    }
+    bool wait(std::chrono::seconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, timeout, [this]() { return remaining == 0; });
+    }
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t remaining;
+};
+
+TEST_CASE(ThreadPoolTests) {
+    // Many small tasks from outside the pool
+    {
+        ThreadPool pool(4, 4);
+        const size_t tasks = 100000;
+        std::atomic<size_t> sum{0};
+        Countdown countdown(tasks);
+        for (size_t i = 0; i < tasks; ++i) {
+            pool.enqueueTask([&sum, &countdown, i]() { sum += i; countdown.done(); });
+        }
+        ASSERT_TRUE(countdown.wait(std::chrono::seconds(30)));
+        ASSERT_EQ(tasks * (tasks - 1) / 2, sum.load());
+    }
+
+    // Tasks that fan out more tasks land on the worker's own deque and get stolen
+    {
+        ThreadPool pool(2, 8);
+        const size_t parents = 64;
+        const size_t children = 500;
+        std::atomic<size_t> ran{0};
+        Countdown countdown(parents * children);
+        for (size_t p = 0; p < parents; ++p) {
+            pool.enqueueTask([&pool, &ran, &countdown]() {
+                for (size_t c = 0; c < children; ++c) {
+                    pool.enqueueTask([&ran, &countdown]() { ++ran; countdown.done(); });
+                }
+            });
+        }
+        ASSERT_TRUE(countdown.wait(std::chrono::seconds(30)));
+        ASSERT_EQ(parents * children, ran.load());
+        ASSERT_TRUE(pool.getActiveThreads() >= 2);
+    }
+
+    // Idle workers park and wake again for later work
+    {
+        ThreadPool pool(3, 3);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        Countdown countdown(1);
+        pool.enqueueTask([&countdown]() { countdown.done(); });
+        ASSERT_TRUE(countdown.wait(std::chrono::seconds(10)));
+    }
+
+    // submit() returns results and rethrows task exceptions to the waiter
+    {
+        ThreadPool pool(2, 4);
+        auto answer = pool.submit([]() { return 6 * 7; });
+        auto text = pool.submit([]() { return std::string("mapreduce"); });
+        auto failing = pool.submit([]() -> int { throw std::runtime_error("submit failure"); });
+        ASSERT_EQ(42, answer.get());
+        ASSERT_EQ(std::string("mapreduce"), text.get());
+        bool threw = false;
+        try {
+            failing.get();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        ASSERT_TRUE(threw);
+    }
+
+    // TaskGroup::wait() rethrows the first failure after all tasks finish
+    {
+        ThreadPool pool(3, 3);
+        std::atomic<int> finished{0};
+        TaskGroup group(pool);
+        for (int i = 0; i < 50; ++i) {
+            group.run([&finished, i]() {
+                if (i == 17) throw std::logic_error("group failure");
+                ++finished;
+            });
+        }
+        bool threw = false;
+        try {
+            group.wait();
+        } catch (const std::logic_error&) {
+            threw = true;
+        }
+        ASSERT_TRUE(threw);
+        ASSERT_EQ(49, finished.load());
+
+        // With nothing left to help with, wait() sleeps until the running task finishes
+        std::atomic<bool> started{false};
+        std::atomic<bool> released{false};
+        TaskGroup blocked(pool);
+        blocked.run([&started, &released]() {
+            started = true;
+            while (!released) std::this_thread::yield();
+        });
+        while (!started) std::this_thread::yield();
+        std::thread releaser([&released]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            released = true;
+        });
+        blocked.wait();
+        ASSERT_TRUE(released.load());
+        releaser.join();
+    }
+
+    // parallel_for covers every index exactly once, including from nested
+    // loops inside pool tasks (the waiting worker helps instead of blocking)
+    {
+        ThreadPool pool(2, 2);
+        std::vector<std::atomic<int>> hits(10007);
+        pool.parallel_for(0, hits.size(), 64, [&hits](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) ++hits[i];
+        });
+        bool allOnce = true;
+        for (const auto& hit : hits) allOnce = allOnce && hit.load() == 1;
+        ASSERT_TRUE(allOnce);
+
+        std::atomic<size_t> inner{0};
+        pool.parallel_for(0, 8, 1, [&pool, &inner](size_t, size_t) {
+            pool.parallel_for(0, 1000, 10, [&inner](size_t begin, size_t end) { inner += end - begin; });
+        });
+        ASSERT_EQ(size_t(8000), inner.load());
+
+        bool threw = false;
+        try {
+            pool.parallel_for(0, 100, 1, [](size_t begin, size_t) {
+                if (begin == 99) throw std::runtime_error("parallel_for failure");
+            });
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        ASSERT_TRUE(threw);
+    }
+
+    // Shutdown runs every queued task, and exceptions do not kill workers
+    {
+        std::atomic<size_t> ran{0};
+        {
+            ThreadPool pool(2, 2);
+            pool.enqueueTask([]() { throw std::runtime_error("expected test exception"); });
+            for (int i = 0; i < 1000; ++i) {
+                pool.enqueueTask([&ran]() { ++ran; });
+            }
+            pool.shutdown();
+            ASSERT_EQ(size_t(0), pool.getTasksInQueue());
+
+            // After shutdown, groups run inline and futures report a broken promise
+            TaskGroup late(pool);
+            late.run([&ran]() { ++ran; });
+            late.wait();
+            bool broken = false;
+            try {
+                pool.submit([]() { return 1; }).get();
+            } catch (const std::future_error&) {
+                broken = true;
+            }
+            ASSERT_TRUE(broken);
+        }
+        ASSERT_EQ(size_t(1001), ran.load());
+    }
+
+    // Work submitted from outside while the pool shuts down either runs or is
+    // refused; no future is left waiting on a task that never runs
+    bool settled = true;
+    for (int round = 0; round < 50 && settled; ++round) {
+        ThreadPool pool(2, 2);
+        std::atomic<bool> go{false};
+        std::vector<std::future<int>> futures[4];
+        std::vector<std::thread> producers;
+        for (auto& produced : futures) {
+            producers.emplace_back([&pool, &go, &produced]() {
+                while (!go) std::this_thread::yield();
+                for (int i = 0; i < 200; ++i) produced.push_back(pool.submit([i]() { return i; }));
+            });
+        }
+        go = true;
+        pool.shutdown();
+        for (std::thread& producer : producers) producer.join();
+        for (auto& produced : futures) {
+            for (auto& future : produced) {
+                settled = settled && future.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+            }
+        }
+    }
+    ASSERT_TRUE(settled);
+}
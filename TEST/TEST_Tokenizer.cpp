@@ -0,0 +1,84 @@
+#include "../include/Tokenizer.h"
+#include "TEST_Test_Framework.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The istringstream / ispunct / tolower pipeline the tokenizer replaced.
+static std::vector<std::string> referenceWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream iss(line);
+        std::string word;
+        while (iss >> word) {
+            word.erase(std::remove_if(word.begin(), word.end(), [](unsigned char c) { return std::ispunct(c); }), word.end());
+            std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) -> unsigned char {
+                return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+            });
+            if (!word.empty()) words.push_back(word);
+        }
+    }
+    return words;
+}
+
+static std::vector<std::string> tokenize(const std::string& text) {
+    std::vector<std::string> words;
+    Tokenizer::forEachWord(text, [&words](std::string_view word) { words.emplace_back(word); });
+    return words;
+}
+
+TEST_CASE(TokenizerTests) {
+    // Punctuation-only words yield no token, and punctuation never splits a word
+    std::string punctuation = "-- ... !?! (hello) don't e-mail, \"quoted\" ; ~";
+    ASSERT_TRUE(tokenize(punctuation) == referenceWords(punctuation));
+    ASSERT_TRUE((tokenize(punctuation) == std::vector<std::string>{"hello", "dont", "email", "quoted"}));
+    ASSERT_TRUE(tokenize("!!! ,,, ...").empty());
+
+    // Runs of mixed separators count as one
+    std::string separators = "\t\talpha \r\n\v\fBeta\n\n\n  gamma\v\f\r\tDELTA \t";
+    ASSERT_TRUE(tokenize(separators) == referenceWords(separators));
+    ASSERT_TRUE((tokenize(separators) == std::vector<std::string>{"alpha", "beta", "gamma", "delta"}));
+    ASSERT_TRUE(tokenize(" \t\r\n\v\f").empty());
+    ASSERT_TRUE(tokenize("").empty());
+
+    // Bytes >= 0x80 are kept as-is: neither separators, punctuation nor folded
+    std::string utf8 = "Caf\xC3\xA9 na\xC3\xAFve \xE2\x80\x94 \xFF\x80x \xC3\x89T\xC3\x89";
+    ASSERT_TRUE(tokenize(utf8) == referenceWords(utf8));
+    ASSERT_TRUE(tokenize(utf8)[0] == "caf\xC3\xA9");
+    std::string highBytes;
+    for (int c = 0x80; c < 0x100; ++c) highBytes += static_cast<char>(c);
+    ASSERT_TRUE((tokenize(highBytes) == std::vector<std::string>{highBytes}));
+
+    // A buffer without a trailing separator still yields its last word
+    ASSERT_TRUE((tokenize("one two Three") == std::vector<std::string>{"one", "two", "three"}));
+    ASSERT_TRUE((tokenize("last!") == std::vector<std::string>{"last"}));
+    ASSERT_TRUE(tokenize("trailing ...").size() == 1);
+
+    // Every single byte and every pair of bytes agrees with the original pipeline
+    bool allMatch = true;
+    for (int a = 0; a < 256; ++a) {
+        std::string one(1, static_cast<char>(a));
+        allMatch = allMatch && tokenize(one) == referenceWords(one);
+        for (int b = 0; b < 256 && allMatch; b += 7) {
+            std::string two = one + static_cast<char>(b) + "Ab";
+            allMatch = allMatch && tokenize(two) == referenceWords(two);
+        }
+    }
+    ASSERT_TRUE(allMatch);
+
+    // Clean words are views into the buffer; rewritten ones come from the scratch buffer
+    std::string buffer = "plain Mixed";
+    Tokenizer tokenizer(buffer);
+    std::string_view token;
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_TRUE(token == "plain" && token.data() == buffer.data());
+    ASSERT_TRUE(tokenizer.next(token));
+    ASSERT_TRUE(token == "mixed" && token.data() != buffer.data() + 6);
+    ASSERT_TRUE(!tokenizer.next(token));
+    tokenizer.reset("again");
+    ASSERT_TRUE(tokenizer.next(token) && token == "again");
+}
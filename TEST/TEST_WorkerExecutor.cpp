@@ -0,0 +1,110 @@
+#include "../include/WorkerExecutor.h"
+#include "../include/Logger.h"
+#include "TEST_Test_Framework.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST_CASE(WorkerExecutorTests) {
+    fs::path dir = fs::temp_directory_path() / "TEST_WorkerExecutor";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "input");
+    std::string tempDir = (dir / "temp").string();
+    std::string outputDir = (dir / "output").string();
+    Logger::getInstance().configureLogFilePath((dir / "worker.log").string());
+
+    const int numMappers = 4;
+    const int numReducers = 2;
+    for (int m = 0; m < numMappers; ++m) {
+        std::ofstream((dir / "input" / ("part" + std::to_string(m) + ".txt")).string()) << "apple banana apple\ncherry\n";
+    }
+
+    std::mutex resultsMutex;
+    std::map<uint32_t, TaskResult> results;
+    size_t started = 0;
+    ProcessOrchestratorDLL orchestrator;
+    {
+        WorkerExecutor executor(
+            orchestrator, 2,
+            [&](uint32_t) {
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                ++started;
+            },
+            [&](uint32_t requestId, const TaskResult& result) {
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                results[requestId] = result;
+            });
+        ASSERT_EQ(static_cast<size_t>(2), executor.slotCount());
+
+        // Four map tasks share two slots; the optional thread pair is accepted
+        for (int m = 0; m < numMappers; ++m) {
+            std::string input = (dir / "input" / ("part" + std::to_string(m) + ".txt")).string();
+            executor.submit(m + 1, TaskAssignment{"map", {tempDir, std::to_string(m), std::to_string(numReducers), "1", "1", "unused.log", input}});
+        }
+        // Malformed and unknown tasks still get a result
+        executor.submit(90, TaskAssignment{"map", {tempDir, "9"}});
+        executor.submit(91, TaskAssignment{"sort", {}});
+        executor.drain();
+    }
+    ASSERT_EQ(static_cast<size_t>(numMappers + 2), started);
+    ASSERT_EQ(static_cast<size_t>(numMappers + 2), results.size());
+    for (int m = 0; m < numMappers; ++m) {
+        ASSERT_EQ(0, results[m + 1].exitCode);
+        ASSERT_EQ(PartitionManifest::path(tempDir, m), results[m + 1].manifestPath);
+        ASSERT_TRUE(PartitionManifest::isCommitted(tempDir, m));
+    }
+    ASSERT_EQ(1, results[90].exitCode);
+    ASSERT_TRUE(results[90].manifestPath.empty());
+    ASSERT_EQ(1, results[91].exitCode);
+
+    // Reducers run on the same kind of executor, without the thread pair
+    results.clear();
+    {
+        WorkerExecutor executor(orchestrator, 2, nullptr, [&](uint32_t requestId, const TaskResult& result) {
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            results[requestId] = result;
+        });
+        for (int r = 0; r < numReducers; ++r) {
+            executor.submit(r + 1, TaskAssignment{"reduce", {outputDir, tempDir, std::to_string(r), "unused.log"}});
+        }
+    } // The destructor drains
+
+    std::map<std::string, long> counts;
+    for (int r = 0; r < numReducers; ++r) {
+        ASSERT_EQ(0, results[r + 1].exitCode);
+        ASSERT_EQ((fs::path(outputDir) / ("reducer_" + std::to_string(r) + ".txt")).string(), results[r + 1].manifestPath);
+        std::ifstream in(results[r + 1].manifestPath);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t colon = line.rfind(": ");
+            if (colon != std::string::npos) counts[line.substr(0, colon)] += std::stol(line.substr(colon + 2));
+        }
+    }
+    ASSERT_EQ(static_cast<long>(2 * numMappers), counts["apple"]);
+    ASSERT_EQ(static_cast<long>(numMappers), counts["banana"]);
+    ASSERT_EQ(static_cast<long>(numMappers), counts["cherry"]);
+
+    // The first attempt to commit a reducer output wins; a slower attempt 0 never replaces it
+    std::string reducerOutput = (fs::path(outputDir) / "reducer_0.txt").string();
+    ProcessOrchestratorDLL::clearReducerOutputs(outputDir);
+    ASSERT_TRUE(!fs::exists(reducerOutput));
+    orchestrator.setTaskAttempt(1);
+    ASSERT_TRUE(orchestrator.runReducer(outputDir, tempDir, 0, 1, 1));
+    { std::ofstream(reducerOutput, std::ios::app) << "backup committed\n"; }
+    orchestrator.setTaskAttempt(0);
+    ASSERT_TRUE(orchestrator.runReducer(outputDir, tempDir, 0, 1, 1));
+    std::ifstream committed(reducerOutput);
+    std::string committedText((std::istreambuf_iterator<char>(committed)), std::istreambuf_iterator<char>());
+    ASSERT_TRUE(committedText.find("backup committed") != std::string::npos);
+    size_t outputFiles = 0;
+    for (const auto& entry : fs::directory_iterator(outputDir)) outputFiles += entry.path().filename().string().rfind("reducer_0", 0) == 0;
+    ASSERT_EQ(static_cast<size_t>(1), outputFiles); // No staged copy left behind
+
+    fs::remove_all(dir);
+}
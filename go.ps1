@@ -107,11 +107,11 @@ $includeSearchPaths = @(
 )
 $srcDir = "src"
 $outputMapperDLL = "MapperLib.dll"
-$mapperSources = "$srcDir/Mapper_DLL_so.cpp"
+$mapperSources = "$srcDir/Mapper_DLL_so.cpp $srcDir/TextNormalizer.cpp"
 $projectMapperLibFileMSVC = "MapperLib.lib"
 $projectMapperLibFileGPP = "libMapperLib.dll.a"
 $outputReducerDLL = "ReducerLib.dll"
-$reducerSources = "$srcDir/Reducer_DLL_so.cpp"
+$reducerSources = "$srcDir/Reducer_DLL_so.cpp $srcDir/ThreadPool.cpp"
 $projectReducerLibFileMSVC = "ReducerLib.lib"
 $projectReducerLibFileGPP = "libReducerLib.dll.a"
 $outputBinary = "MapReduce.exe"
@@ -122,7 +122,8 @@ $executableSources = @(
     "$srcDir/ProcessOrchestrator.cpp",
     "$srcDir/socket_client.cpp",
     "$srcDir/ThreadPool.cpp",
-    "$srcDir/worker_stub.cpp"
+    "$srcDir/worker_stub.cpp",
+    "$srcDir/WorkerExecutor.cpp"
 )
 
 $useMSVC = $false
@@ -13,8 +13,9 @@ COLOR_NC='\033[0m' # No Color
 PROJECT_INCLUDE_DIR="include"
 SRC_DIR="src"
 
-MAPPER_SOURCES="$SRC_DIR/Mapper_DLL_so.cpp"
-REDUCER_SOURCES="$SRC_DIR/Reducer_DLL_so.cpp" # Corrected typo from Reducerr
+MAPPER_SOURCES="$SRC_DIR/Mapper_DLL_so.cpp $SRC_DIR/TextNormalizer.cpp"
+REDUCER_SOURCES="$SRC_DIR/Reducer_DLL_so.cpp $SRC_DIR/ThreadPool.cpp" # Corrected typo from Reducerr
+PLUGIN_SOURCES="$SRC_DIR/FrequentWordsPlugin.cpp" # Example plugin_library, loaded at run time (not linked)
 # Ensure these additional source files exist in your src/ directory
 EXECUTABLE_SOURCES=(
     "$SRC_DIR/main.cpp"
@@ -24,6 +25,7 @@ EXECUTABLE_SOURCES=(
     "$SRC_DIR/socket_client.cpp"
     "$SRC_DIR/ThreadPool.cpp"
     "$SRC_DIR/worker_stub.cpp"
+    "$SRC_DIR/WorkerExecutor.cpp"
 )
 
 OUTPUT_BINARY_NAME="MapReduce" # Changed from mapreduce_controller to match .exe
@@ -32,20 +34,22 @@ OUTPUT_BINARY_NAME="MapReduce" # Changed from mapreduce_controller to match .exe
 if [[ "$(uname)" == "Darwin" ]]; then
     OUTPUT_MAPPER_LIB_NAME="MapperLib.dylib"
     OUTPUT_REDUCER_LIB_NAME="ReducerLib.dylib"
+    OUTPUT_PLUGIN_NAME="FrequentWordsPlugin.dylib"
 else
     OUTPUT_MAPPER_LIB_NAME="MapperLib.so"
     OUTPUT_REDUCER_LIB_NAME="ReducerLib.so"
+    OUTPUT_PLUGIN_NAME="FrequentWordsPlugin.so"
 fi
 
 # Compiler and Linker flags
 # -fPIC is necessary for shared libraries.
 # -Wall -Wextra -O2 are good general flags.
-# -pthread for thread support
+# -pthread for thread support, -ldl for loading plugin_library with dlopen
 # Define DLL_so_EXPORTS when building the shared libraries themselves
 CXX_COMMON_FLAGS="-std=c++17 -Wall -Wextra -O2 -pthread"
 CXX_SHARED_LIB_FLAGS="$CXX_COMMON_FLAGS -fPIC -DDLL_so_EXPORTS"
 CXX_EXECUTABLE_FLAGS="$CXX_COMMON_FLAGS"
-LD_FLAGS="-pthread"
+LD_FLAGS="-pthread -ldl"
 INCLUDE_PATHS="-I$PROJECT_INCLUDE_DIR -I$SRC_DIR" # Assuming headers might also be in src or root
 
 # --- Helper Functions ---
@@ -165,8 +169,9 @@ if [ $CUSTOM_LIBS_PROVIDED -ne 0 ]; then # Building project's libs
 else
     print_message "$COLOR_DARK_YELLOW" "  - Skipping cleanup of project-specific shared libraries as user is providing them."
 fi
-# Always clean the main executable and object files
+# Always clean the main executable, the example plugin and object files
 clean_file "$OUTPUT_BINARY_NAME"
+clean_file "$OUTPUT_PLUGIN_NAME"
 find . -maxdepth 1 -name "*.o" -exec rm -f {} \; # Clean .o files in current dir
 
 if $USE_CMAKE; then
@@ -228,6 +233,10 @@ if $USE_GPP; then
         RPath_Setting="-Wl,-rpath,'\$ORIGIN'"
     fi
 
+    print_message "$COLOR_CYAN" "Compiling example plugin $OUTPUT_PLUGIN_NAME..."
+    CMD_PLUGIN="g++ $CXX_SHARED_LIB_FLAGS -shared -o $OUTPUT_PLUGIN_NAME $PLUGIN_SOURCES $INCLUDE_PATHS"
+    execute_command $CMD_PLUGIN || { print_message "$COLOR_RED" "ERROR: g++ failed to compile $OUTPUT_PLUGIN_NAME. Exiting."; exit 1; }
+
     print_message "$COLOR_CYAN" "Compiling $OUTPUT_BINARY_NAME..."
     # Convert array of executable sources to string
     SOURCES_STRING="${EXECUTABLE_SOURCES[*]}"
@@ -235,6 +244,7 @@ if $USE_GPP; then
     execute_command $CMD_BINARY || { print_message "$COLOR_RED" "ERROR: g++ failed to compile $OUTPUT_BINARY_NAME. Exiting."; exit 1; }
     
     print_message "$COLOR_GREEN" "  - Executable Binary: ./$OUTPUT_BINARY_NAME"
+    print_message "$COLOR_GREEN" "  - Example plugin: ./$OUTPUT_PLUGIN_NAME (plugin_library=./$OUTPUT_PLUGIN_NAME in config.txt)"
     print_message "$COLOR_GREEN" "Build completed successfully using g++!"
     exit 0
 
@@ -0,0 +1,156 @@
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "IntermediateFormat.h" // Varint and zigzag helpers
+
+// Record layout of Logger's binary (deferred-format) output. A log call stores
+// only its call site's format id and its raw arguments; format strings are
+// written once per file, and text is rendered offline by
+// `MapReduce decode-log`.
+//
+//   file    := session*
+//   session := MAGIC record*                       (ids restart in every session)
+//   record  := 'F' id line file signature format   (varint ints, varint-length strings)
+//            | 'P' prefix                          (prefix of the messages that follow)
+//            | 'M' id level micros payload         (micros since the epoch; payload is varint-length)
+//
+// A payload holds one value per signature character: 'i' zigzag varint,
+// 'u' varint, 'd' IEEE-754 bits as 8 little-endian bytes, 's' varint length
+// plus bytes. Format id 0 is the plain log(message) call: its payload is the
+// message text itself.
+class BinaryLog {
+public:
+    static constexpr char MAGIC[8] = {'M', 'R', 'B', 'L', 'O', 'G', '0', '1'};
+    static constexpr char FORMAT_RECORD = 'F';
+    static constexpr char PREFIX_RECORD = 'P';
+    static constexpr char MESSAGE_RECORD = 'M';
+    static constexpr uint32_t PLAIN_FORMAT_ID = 0;
+
+    static constexpr char SIGNED_ARG = 'i';
+    static constexpr char UNSIGNED_ARG = 'u';
+    static constexpr char DOUBLE_ARG = 'd';
+    static constexpr char STRING_ARG = 's';
+
+    template <typename T>
+    static constexpr char argType() {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            return UNSIGNED_ARG;
+        } else if constexpr (std::is_same_v<U, char>) {
+            return STRING_ARG;
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            return SIGNED_ARG;
+        } else if constexpr (std::is_integral_v<U>) {
+            return UNSIGNED_ARG;
+        } else if constexpr (std::is_floating_point_v<U>) {
+            return DOUBLE_ARG;
+        } else {
+            static_assert(std::is_convertible_v<const U&, std::string_view>, "Log arguments must be numbers or strings");
+            return STRING_ARG;
+        }
+    }
+
+    template <typename... Args>
+    static std::string signature() {
+        return std::string{argType<Args>()...};
+    }
+
+    template <typename T>
+    static void appendArg(std::string& out, const T& value) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, char>) {
+            IntermediateFormat::putVarint(out, 1);
+            out.push_back(value);
+        } else if constexpr (std::is_same_v<U, bool> || (std::is_integral_v<U> && !std::is_signed_v<U>)) {
+            IntermediateFormat::putVarint(out, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_integral_v<U>) {
+            IntermediateFormat::putVarint(out, IntermediateFormat::zigzagEncode(static_cast<int64_t>(value)));
+        } else if constexpr (std::is_floating_point_v<U>) {
+            double number = static_cast<double>(value);
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            char bytes[8];
+            IntermediateFormat::putFixed(bytes, bits);
+            out.append(bytes, sizeof(bytes));
+        } else {
+            putString(out, std::string_view(value));
+        }
+    }
+
+    template <typename... Args>
+    static void appendArgs(std::string& out, const Args&... args) {
+        (appendArg(out, args), ...);
+    }
+
+    static void putString(std::string& out, std::string_view text) {
+        IntermediateFormat::putVarint(out, text.size());
+        out.append(text.data(), text.size());
+    }
+
+    static bool getString(std::string_view in, size_t& pos, std::string_view& text) {
+        uint64_t length = 0;
+        if (!IntermediateFormat::getVarint(in, pos, length) || length > in.size() - pos) return false;
+        text = in.substr(pos, static_cast<size_t>(length));
+        pos += static_cast<size_t>(length);
+        return true;
+    }
+
+    // Appends `format` with each "{}" replaced by the next argument. Missing
+    // arguments leave "{}"; surplus arguments are ignored. Returns false if
+    // the payload does not match the signature.
+    static bool render(std::string_view format, std::string_view signature, std::string_view payload, std::string& out) {
+        size_t pos = 0;
+        size_t argIndex = 0;
+        size_t start = 0;
+        for (size_t brace = format.find("{}"); brace != std::string_view::npos; brace = format.find("{}", start)) {
+            out.append(format.data() + start, brace - start);
+            start = brace + 2;
+            if (argIndex >= signature.size()) {
+                out += "{}";
+                continue;
+            }
+            if (!renderArg(signature[argIndex++], payload, pos, out)) return false;
+        }
+        out.append(format.data() + start, format.size() - start);
+        return true;
+    }
+
+private:
+    static bool renderArg(char type, std::string_view payload, size_t& pos, std::string& out) {
+        uint64_t value = 0;
+        switch (type) {
+            case SIGNED_ARG:
+                if (!IntermediateFormat::getVarint(payload, pos, value)) return false;
+                out += std::to_string(IntermediateFormat::zigzagDecode(value));
+                return true;
+            case UNSIGNED_ARG:
+                if (!IntermediateFormat::getVarint(payload, pos, value)) return false;
+                out += std::to_string(value);
+                return true;
+            case DOUBLE_ARG: {
+                if (payload.size() - pos < 8) return false;
+                uint64_t bits = IntermediateFormat::getFixed<uint64_t>(payload.data() + pos);
+                pos += 8;
+                double number;
+                std::memcpy(&number, &bits, sizeof(number));
+                out += std::to_string(number);
+                return true;
+            }
+            case STRING_ARG: {
+                std::string_view text;
+                if (!getString(payload, pos, text)) return false;
+                out.append(text.data(), text.size());
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+};
+
+#endif // BINARY_LOG_H
@@ -0,0 +1,95 @@
+#ifndef COMBINER_H
+#define COMBINER_H
+
+#include "KeyValueBuffer.h"
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// In-mapper combiner: pre-aggregates {word, count} records per key before they
+// reach the partitioner. Keys are interned in the output buffer's
+// KeyDictionary and partial counts are kept by key ID, so adding to a key seen
+// before is an array update rather than a hash and a string compare. The count
+// table is bounded by an approximate memory budget; once it is exceeded the
+// partial aggregates are flushed to the output buffer and the table starts
+// over. Reducers sum counts anyway, so a key flushed more than once is still
+// reduced correctly.
+//
+// Key IDs belong to the output buffer, so every call must pass the same one
+// and the combiner must be flushed before that buffer's clearKeys().
+class Combiner {
+public:
+    static constexpr size_t DEFAULT_MEMORY_BUDGET_BYTES = 64 * 1024 * 1024;
+
+    struct Stats {
+        size_t inputRecords = 0;  // Records offered to add()
+        size_t outputRecords = 0; // Records written by flush()
+        size_t flushes = 0;       // Number of non-empty flushes (budget-triggered or final)
+    };
+
+    explicit Combiner(size_t memoryBudgetBytes = DEFAULT_MEMORY_BUDGET_BYTES)
+        : memoryBudget(memoryBudgetBytes), memoryUsed(0) {}
+
+    void setMemoryBudget(size_t memoryBudgetBytes) { memoryBudget = memoryBudgetBytes; }
+    size_t getMemoryBudget() const { return memoryBudget; }
+    size_t getMemoryUsed() const { return memoryUsed; }
+    const Stats& getStats() const { return stats; }
+
+    // Adds `count` to `key`, interning it in `out` (whose keys are switched to
+    // interned if they are not yet). Flushes into `out` first if the budget is
+    // exhausted.
+    void add(std::string_view key, int count, KeyValueBuffer& out) {
+        out.internKeys();
+        add(out.intern(key), count, out);
+    }
+
+    // Adds `count` to the key with ID keyId in out's dictionary.
+    void add(uint32_t keyId, int count, KeyValueBuffer& out) {
+        ++stats.inputRecords;
+        if (keyId >= entryOf.size()) entryOf.resize(std::max<size_t>(keyId + 1, entryOf.size() * 2), 0);
+        uint32_t entry = entryOf[keyId];
+        if (entry != 0) {
+            entries[entry - 1].count += count;
+            return;
+        }
+        if (memoryUsed + ENTRY_FOOTPRINT > memoryBudget && !entries.empty()) {
+            flush(out);
+        }
+        entries.push_back(Entry{keyId, count});
+        entryOf[keyId] = static_cast<uint32_t>(entries.size());
+        memoryUsed += ENTRY_FOOTPRINT;
+    }
+
+    // Moves all partial aggregates into `out` and empties the table.
+    void flush(KeyValueBuffer& out) {
+        if (entries.empty()) return;
+        out.reserve(out.size() + entries.size());
+        stats.outputRecords += entries.size();
+        ++stats.flushes;
+        for (const Entry& entry : entries) {
+            out.addInterned(entry.keyId, entry.count);
+            entryOf[entry.keyId] = 0;
+        }
+        entries.clear();
+        memoryUsed = 0;
+    }
+
+private:
+    struct Entry {
+        uint32_t keyId;
+        int count;
+    };
+
+    // An entry plus its slot in entryOf. The key bytes are in the output
+    // buffer's dictionary and count against the mapper's spill budget.
+    static constexpr size_t ENTRY_FOOTPRINT = sizeof(Entry) + sizeof(uint32_t);
+
+    std::vector<Entry> entries;     // In order of first appearance since the last flush
+    std::vector<uint32_t> entryOf;  // By key ID: index in entries + 1, 0 if absent
+    size_t memoryBudget;
+    size_t memoryUsed;
+    Stats stats;
+};
+
+#endif // COMBINER_H
@@ -4,6 +4,11 @@
 #include <string>
 #include <unordered_map>
 #include <optional>
+#include <cstdint>
+#include "IntermediateFormat.h"
+#include "RangePartitioner.h"
+#include "Logger.h"
+#include "ProcessLauncher.h"
 
 class ConfigManager {
 public:
@@ -16,6 +21,47 @@ public:
     std::optional<size_t> getReducerMinThreads() const;
     std::optional<size_t> getReducerMaxThreads() const;
 
+    // Get in-mapper combiner configuration
+    std::optional<bool> getCombinerEnabled() const;
+    std::optional<size_t> getCombinerMemoryBudget() const;
+
+    // Get mapper spill budget in bytes (0 disables spilling)
+    std::optional<size_t> getMapperSpillBudget() const;
+
+    // Get the partition hash seed (must match across all mappers of a job)
+    std::optional<uint64_t> getPartitionHashSeed() const;
+
+    // Get the partitioning scheme ("hash" or "range")
+    std::optional<PartitionScheme> getPartitionScheme() const;
+
+    // Get the input bytes sampled per split to plan range partitions
+    std::optional<size_t> getPartitionSampleBytes() const;
+
+    // Get input split size in bytes (0 keeps whole files)
+    std::optional<size_t> getInputSplitSize() const;
+
+    // Get partition file encoding ("binary" or "text")
+    std::optional<IntermediateEncoding> getIntermediateEncoding() const;
+
+    // Get mapper output layout ("per_reducer" or "indexed")
+    std::optional<IntermediateLayout> getIntermediateLayout() const;
+
+    // Get logging configuration
+    std::optional<bool> getLogAsync() const;
+    std::optional<Logger::Level> getLogLevel() const; // "debug", "info", "warning" or "error"
+    std::optional<bool> getLogConsole() const;
+    std::optional<Logger::OutputFormat> getLogFormat() const; // "text" or "binary"
+
+    // Get where the controller runs workers ("threads" or "processes")
+    std::optional<ExecutionMode> getExecutionMode() const;
+
+    // Get per-worker-process resource limits (0 = unlimited)
+    std::optional<uint64_t> getWorkerCpuSeconds() const;
+    std::optional<uint64_t> getWorkerMemoryBytes() const;
+
+    // Get the map/reduce plugin shared library (see MapReducePlugin.h)
+    std::optional<std::string> getPluginLibrary() const;
+
     // Get file naming conventions
     std::string getIntermediateFileFormat() const;
     std::string getOutputFileFormat() const;
@@ -27,6 +73,22 @@ public:
     void setReducerMaxThreads(size_t maxThreads);
     void setIntermediateFileFormat(const std::string& format);
     void setOutputFileFormat(const std::string& format);
+    void setCombinerEnabled(bool enabled);
+    void setCombinerMemoryBudget(size_t bytes);
+    void setInputSplitSize(size_t bytes);
+    void setMapperSpillBudget(size_t bytes);
+    void setPartitionHashSeed(uint64_t seed);
+    void setPartitionScheme(PartitionScheme scheme);
+    void setPartitionSampleBytes(size_t bytes);
+    void setIntermediateEncoding(IntermediateEncoding encoding);
+    void setIntermediateLayout(IntermediateLayout layout);
+    void setLogAsync(bool enabled);
+    void setLogConsole(bool enabled);
+    void setLogFormat(Logger::OutputFormat format);
+    void setExecutionMode(ExecutionMode mode);
+    void setWorkerCpuSeconds(uint64_t seconds);
+    void setWorkerMemoryBytes(uint64_t bytes);
+    void setPluginLibrary(const std::string& path);
 
 private:
     std::unordered_map<std::string, std::string> config;
@@ -36,6 +98,9 @@ private:
 
     // Helper to parse size_t safely
     static std::optional<size_t> parseSizeT(const std::string& value);
+
+    // Helper to parse true/false, yes/no, on/off, 1/0
+    static std::optional<bool> parseBool(const std::string& value);
 };
 
 #endif // CONFIG_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,591 @@
+#ifndef CONTROLLER_SERVICE_H
+#define CONTROLLER_SERVICE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "FrameProtocol.h"
+#include "Logger.h"
+
+// Controller side of the socket deployment (Linux, epoll). Accepts any number
+// of worker_stub connections on one port and runs a single-threaded event loop
+// over them. Each worker announces how many tasks it runs at once (REGISTER),
+// and queued tasks are dispatched whenever a worker has a free slot, spreading
+// them one per worker per pass.
+//
+// Tasks are submitted in stages: tasks of a later stage are only dispatched
+// once every task of the earlier stages has succeeded (reducers after all
+// mappers). Each dispatch gets a fresh request ID. When a worker disconnects,
+// or has not been heard from (heartbeats included) for heartbeatTimeout, it is
+// dropped and its running tasks go back to the front of their queue for
+// another worker; a task that reports a non-zero exit fails the run.
+//
+// Workers report each running task's progress in their heartbeats. Once a
+// stage has nothing left to hand out, a free slot is used for a speculative
+// backup copy of the stage's slowest task whose progress rate (fraction done
+// per second) is below slowFraction of the stage's median rate. Whichever copy
+// finishes first completes the task; the other copy's result is ignored. Every
+// copy carries its own attempt number, so the copies commit their output under
+// different names and the first commit wins (see PartitionManifest).
+class ControllerService {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct TaskOutcome {
+        uint32_t requestId;
+        TaskAssignment task;
+        TaskResult result;
+        std::string worker;
+        bool backup; // Finished by a speculative copy
+    };
+
+    struct Policy {
+        std::chrono::milliseconds heartbeatTimeout{10000};
+        bool speculate = true;
+        double slowFraction = 0.5;
+        std::chrono::milliseconds minRuntime{2000}; // Before a task may be judged slow
+    };
+
+    ControllerService() = default;
+    ~ControllerService() { close(); }
+    ControllerService(const ControllerService&) = delete;
+    ControllerService& operator=(const ControllerService&) = delete;
+
+    // Listens on `port` (0 picks a free one; see port()).
+    bool listen(uint16_t port, std::string& error) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (epollFd < 0 || listenFd < 0) {
+            error = std::string("socket setup failed: ") + std::strerror(errno);
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listenFd, SOMAXCONN) < 0) {
+            error = "could not listen on port " + std::to_string(port) + ": " + std::strerror(errno);
+            return false;
+        }
+        socklen_t length = sizeof(address);
+        getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+        boundPort = ntohs(address.sin_port);
+        return addToLoop(listenFd, EPOLLIN, error);
+    }
+
+    uint16_t port() const { return boundPort; }
+
+    // Holds dispatching until this many workers have registered, so the first
+    // tasks are not all handed to whichever worker connects first.
+    void setMinWorkers(size_t count) { minWorkers = count; }
+
+    void setPolicy(const Policy& newPolicy) { policy = newPolicy; }
+    const Policy& getPolicy() const { return policy; }
+
+    void submit(const TaskAssignment& task) {
+        if (stages.empty()) stages.emplace_back();
+        tasks.push_back(Task{task, stages.size() - 1});
+        stages.back().pending.push_back(tasks.size() - 1);
+        ++stages.back().remaining;
+    }
+
+    // Tasks submitted after this call wait for all tasks submitted before it.
+    void nextStage() {
+        if (!stages.empty() && stages.back().remaining > 0) stages.emplace_back();
+    }
+
+    // Calls onReadable() from the loop whenever `fd` is readable (e.g. stdin).
+    bool watch(int fd, std::function<void()> onReadable, std::string& error) {
+        watched[fd] = std::move(onReadable);
+        return addToLoop(fd, EPOLLIN, error);
+    }
+
+    // Runs the loop until every submitted task has succeeded (true), or until a
+    // task failed and the tasks still running have reported (false).
+    bool runUntilDone(std::string& error) {
+        while (!finished()) {
+            if (!pollOnce(tickMs(), error)) return false;
+        }
+        if (failed) error = failure;
+        return !failed;
+    }
+
+    // Runs the loop until stop() is called, e.g. by a watched descriptor.
+    bool serve(std::string& error) {
+        stopping = false;
+        while (!stopping) {
+            if (!pollOnce(tickMs(), error)) return false;
+        }
+        return true;
+    }
+
+    void stop() { stopping = true; }
+
+    // Asks every worker to exit once its running tasks have reported.
+    void shutdownWorkers() {
+        for (auto& entry : workers) {
+            queueFrame(entry.second, FrameType::SHUTDOWN, 0, {});
+        }
+        // Best effort: give each worker's queued frames one blocking attempt
+        for (auto& entry : workers) {
+            int flags = fcntl(entry.first, F_GETFL, 0);
+            fcntl(entry.first, F_SETFL, flags & ~O_NONBLOCK);
+            flush(entry.second);
+        }
+    }
+
+    void close() {
+        for (auto& entry : workers) ::close(entry.first);
+        workers.clear();
+        if (listenFd >= 0) ::close(listenFd);
+        if (epollFd >= 0) ::close(epollFd);
+        listenFd = epollFd = -1;
+    }
+
+    size_t workerCount() const { return workers.size(); }
+    size_t runningCount() const { return running.size(); }
+    size_t pendingCount() const {
+        size_t count = 0;
+        for (const auto& stage : stages) count += stage.pending.size();
+        return count;
+    }
+    const std::vector<TaskOutcome>& outcomes() const { return completed; }
+    size_t backupsLaunched() const { return backups; }
+
+    // One line per connected worker: name, slots, and each running task's progress
+    std::vector<std::string> describeWorkers() const {
+        std::vector<std::string> lines;
+        for (const auto& entry : workers) {
+            const Worker& worker = entry.second;
+            std::string line = worker.name + ": " + std::to_string(worker.running.size()) + "/" + std::to_string(worker.slots) +
+                               " slots busy" + (worker.registered ? "" : " (not registered)");
+            for (uint32_t requestId : worker.running) {
+                const Attempt& attempt = running.at(requestId);
+                line += " #" + std::to_string(requestId) + " " + tasks[attempt.task].assignment.command;
+                if (attempt.progress.total > 0) line += " " + std::to_string(100 * attempt.progress.done / attempt.progress.total) + "%";
+                if (attempt.backup) line += " (backup)";
+            }
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+private:
+    static constexpr int LOOP_TICK_MS = 1000;
+    static constexpr int MAX_EVENTS = 64;
+
+    struct Worker {
+        int fd = -1;
+        std::string name;
+        uint32_t slots = 0;
+        bool registered = false;
+        FrameReader reader;
+        std::string outbox; // Frames not yet accepted by the socket
+        bool writeArmed = false;
+        std::set<uint32_t> running;
+        Clock::time_point lastHeard;
+    };
+
+    // A submitted task, however many copies of it have been dispatched.
+    struct Task {
+        TaskAssignment assignment;
+        size_t stage;
+        uint32_t attempts = 0;     // Copies dispatched so far; the next copy's attempt number
+        size_t copiesRunning = 0;
+        bool done = false;
+        bool backedUp = false;
+    };
+
+    // One dispatched copy of a task, by request ID.
+    struct Attempt {
+        size_t task;
+        int workerFd;
+        Clock::time_point started;
+        TaskProgress progress;
+        bool backup;
+    };
+
+    struct Stage {
+        std::deque<size_t> pending;      // Task indices
+        size_t remaining = 0;            // Tasks of this stage not yet succeeded
+        std::vector<double> doneRates;   // 1 / seconds, of the copies that finished
+    };
+
+    int tickMs() const {
+        return static_cast<int>(std::clamp<long long>(policy.heartbeatTimeout.count() / 4, 10, LOOP_TICK_MS));
+    }
+
+    // Fraction of the task done per second. Without a progress report the
+    // copy is assumed to finish right now, an upper bound on its rate.
+    static double progressRate(const Attempt& attempt, Clock::time_point now) {
+        double seconds = std::chrono::duration<double>(now - attempt.started).count();
+        double fraction = attempt.progress.total > 0 ? static_cast<double>(attempt.progress.done) / static_cast<double>(attempt.progress.total) : 1.0;
+        return seconds > 0 ? fraction / seconds : 0.0;
+    }
+
+    bool finished() const {
+        if (failed) return running.empty();
+        for (const auto& stage : stages) {
+            if (stage.remaining > 0) return false;
+        }
+        return true;
+    }
+
+    bool addToLoop(int fd, uint32_t events, std::string& error) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            error = std::string("epoll_ctl failed: ") + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    bool pollOnce(int timeoutMs, std::string& error) {
+        epoll_event events[MAX_EVENTS];
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+        if (count < 0) {
+            if (errno == EINTR) return true;
+            error = std::string("epoll_wait failed: ") + std::strerror(errno);
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptWorkers();
+                continue;
+            }
+            auto watchedIt = watched.find(fd);
+            if (watchedIt != watched.end()) {
+                watchedIt->second();
+                continue;
+            }
+            auto it = workers.find(fd);
+            if (it == workers.end()) continue; // Closed earlier in this batch
+            if ((events[i].events & EPOLLOUT) && !flush(it->second)) {
+                disconnect(fd, "write failed");
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readWorker(fd);
+        }
+        dropSilentWorkers();
+        dispatch();
+        return true;
+    }
+
+    // A worker that sends nothing, not even heartbeats, is presumed dead.
+    void dropSilentWorkers() {
+        Clock::time_point now = Clock::now();
+        for (auto it = workers.begin(); it != workers.end();) {
+            int fd = it->first;
+            Clock::duration silence = now - (it++)->second.lastHeard; // disconnect() erases the entry
+            if (silence > policy.heartbeatTimeout) {
+                disconnect(fd, "no heartbeat for " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(silence).count()) + " ms");
+            }
+        }
+    }
+
+    void acceptWorkers() {
+        while (true) {
+            sockaddr_in address{};
+            socklen_t length = sizeof(address);
+            int fd = accept4(listenFd, reinterpret_cast<sockaddr*>(&address), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN: no more pending connections
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            std::string error;
+            if (!addToLoop(fd, EPOLLIN, error)) {
+                Logger::getInstance().log("Controller: " + error, Logger::Level::ERROR);
+                ::close(fd);
+                continue;
+            }
+            char host[INET_ADDRSTRLEN] = "?";
+            inet_ntop(AF_INET, &address.sin_addr, host, sizeof(host));
+            Worker& worker = workers[fd];
+            worker.fd = fd;
+            worker.name = std::string(host) + ":" + std::to_string(ntohs(address.sin_port));
+            worker.lastHeard = Clock::now();
+            LOG_INFO("Controller: worker {} connected.", worker.name);
+        }
+    }
+
+    void readWorker(int fd) {
+        Worker& worker = workers[fd];
+        std::string error;
+        while (true) {
+            FrameReader::ReadResult result = worker.reader.readFrom(fd, error);
+            if (result == FrameReader::ReadResult::WOULD_BLOCK) break;
+            if (result != FrameReader::ReadResult::DATA) {
+                disconnect(fd, result == FrameReader::ReadResult::CLOSED ? "connection closed" : error);
+                return;
+            }
+            worker.lastHeard = Clock::now();
+            Frame frame;
+            while (worker.reader.nextFrame(frame, error)) handleFrame(worker, frame);
+            if (!error.empty()) {
+                disconnect(fd, error);
+                return;
+            }
+        }
+    }
+
+    void handleFrame(Worker& worker, const Frame& frame) {
+        switch (frame.type) {
+            case FrameType::REGISTER: {
+                WorkerInfo info;
+                if (!FrameProtocol::decode(frame.payload, info)) break;
+                worker.slots = info.slots > 0 ? info.slots : 1;
+                if (!info.name.empty()) worker.name = info.name + " (" + worker.name + ")";
+                worker.registered = true;
+                LOG_INFO("Controller: worker {} registered with {} slots.", worker.name, worker.slots);
+                break;
+            }
+            case FrameType::RESULT_MANIFEST: {
+                auto it = running.find(frame.requestId);
+                if (it == running.end()) break; // Reassigned after a disconnect
+                TaskResult result;
+                if (!FrameProtocol::decode(frame.payload, result)) result.exitCode = -1;
+                finishTask(worker, it, result);
+                break;
+            }
+            case FrameType::STATUS:
+                LOG_DEBUG("Controller: {} #{}: {}", worker.name, frame.requestId, frame.payload);
+                break;
+            case FrameType::PROGRESS: {
+                TaskProgress progress;
+                if (FrameProtocol::decode(frame.payload, progress)) {
+                    LOG_DEBUG("Controller: {} #{}: {}/{}", worker.name, frame.requestId, progress.done, progress.total);
+                    updateProgress(worker, frame.requestId, progress);
+                }
+                break;
+            }
+            case FrameType::HEARTBEAT: {
+                WorkerHeartbeat heartbeat;
+                if (!FrameProtocol::decode(frame.payload, heartbeat)) break;
+                for (const auto& task : heartbeat.tasks) updateProgress(worker, task.first, task.second);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void updateProgress(const Worker& worker, uint32_t requestId, const TaskProgress& progress) {
+        auto it = running.find(requestId);
+        if (it != running.end() && it->second.workerFd == worker.fd) it->second.progress = progress;
+    }
+
+    void finishTask(Worker& worker, std::map<uint32_t, Attempt>::iterator it, const TaskResult& result) {
+        uint32_t requestId = it->first;
+        Attempt attempt = it->second;
+        running.erase(it);
+        worker.running.erase(requestId);
+        Task& task = tasks[attempt.task];
+        --task.copiesRunning;
+        if (task.done) {
+            LOG_INFO("Controller: {} finished #{} ({}) after another copy; result ignored.", worker.name, requestId, task.assignment.command);
+            return;
+        }
+        if (result.exitCode != 0) {
+            if (task.copiesRunning > 0) {
+                Logger::getInstance().log("Controller: #" + std::to_string(requestId) + " " + task.assignment.command + " failed on " +
+                                          worker.name + "; another copy is still running.", Logger::Level::WARNING);
+                return;
+            }
+            if (!failed) {
+                failed = true;
+                failure = task.assignment.command + " task failed on " + worker.name + " with exit code " + std::to_string(result.exitCode);
+                Logger::getInstance().log("Controller: " + failure, Logger::Level::ERROR);
+            }
+            return;
+        }
+        task.done = true;
+        Stage& stage = stages[task.stage];
+        --stage.remaining;
+        double seconds = std::chrono::duration<double>(Clock::now() - attempt.started).count();
+        stage.doneRates.push_back(seconds > 0 ? 1.0 / seconds : 0.0);
+        LOG_INFO("Controller: {} finished #{} ({}{}); published {}.", worker.name, requestId, task.assignment.command,
+                 attempt.backup ? ", backup copy" : "", result.manifestPath);
+        completed.push_back(TaskOutcome{requestId, task.assignment, result, worker.name, attempt.backup});
+    }
+
+    void disconnect(int fd, const std::string& reason) {
+        auto it = workers.find(fd);
+        if (it == workers.end()) return;
+        Worker& worker = it->second;
+        Logger::getInstance().log("Controller: worker " + worker.name + " disconnected (" + reason + "); " +
+                                  std::to_string(worker.running.size()) + " task(s) were running on it.", Logger::Level::WARNING);
+        for (uint32_t requestId : worker.running) {
+            auto attempt = running.find(requestId);
+            if (attempt == running.end()) continue;
+            size_t taskIndex = attempt->second.task;
+            running.erase(attempt);
+            // Requeue unless another copy is still running or already succeeded
+            Task& task = tasks[taskIndex];
+            if (--task.copiesRunning == 0 && !task.done) stages[task.stage].pending.push_front(taskIndex);
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        workers.erase(it);
+    }
+
+    // Index of the first stage that still has tasks to succeed.
+    size_t activeStage() const {
+        size_t index = 0;
+        while (index + 1 < stages.size() && stages[index].remaining == 0) ++index;
+        return index;
+    }
+
+    void dispatch() {
+        if (failed || stages.empty()) return;
+        if (!dispatchStarted) {
+            size_t registered = 0;
+            for (const auto& entry : workers) registered += entry.second.registered ? 1 : 0;
+            if (registered < std::max<size_t>(minWorkers, 1)) return;
+            dispatchStarted = true;
+        }
+        size_t stageIndex = activeStage();
+        Stage& stage = stages[stageIndex];
+        bool assigned = true;
+        while (assigned && !stage.pending.empty()) {
+            assigned = false;
+            for (auto& entry : workers) {
+                Worker& worker = entry.second;
+                if (!worker.registered || worker.running.size() >= worker.slots || stage.pending.empty()) continue;
+                size_t taskIndex = stage.pending.front();
+                stage.pending.pop_front();
+                startCopy(worker, taskIndex, false);
+                assigned = true;
+            }
+        }
+        if (policy.speculate && stage.pending.empty()) speculate(stageIndex);
+        for (auto it = workers.begin(); it != workers.end();) {
+            int fd = (it++)->first; // disconnect() may erase the current entry
+            if (!flush(workers[fd])) disconnect(fd, "write failed");
+        }
+    }
+
+    void startCopy(Worker& worker, size_t taskIndex, bool backup) {
+        Task& task = tasks[taskIndex];
+        uint32_t requestId = nextRequestId++;
+        TaskAssignment assignment = task.assignment;
+        assignment.attempt = task.attempts++;
+        queueFrame(worker, FrameType::JOB_ASSIGNMENT, requestId, FrameProtocol::encode(assignment));
+        LOG_INFO("Controller: #{} {} task{} sent to {}.", requestId, assignment.command,
+                 backup ? " (backup copy, attempt " + std::to_string(assignment.attempt) + ")" : "", worker.name);
+        worker.running.insert(requestId);
+        running[requestId] = Attempt{taskIndex, worker.fd, Clock::now(), TaskProgress{}, backup};
+        ++task.copiesRunning;
+    }
+
+    // Tail of a stage: gives free slots to backup copies of stragglers, the
+    // slowest first, each on a worker other than the one running it.
+    void speculate(size_t stageIndex) {
+        Clock::time_point now = Clock::now();
+        std::vector<double> rates = stages[stageIndex].doneRates;
+        std::vector<std::pair<double, uint32_t>> candidates; // (rate, request ID)
+        for (const auto& entry : running) {
+            const Attempt& attempt = entry.second;
+            const Task& task = tasks[attempt.task];
+            if (task.stage != stageIndex || task.done) continue;
+            double rate = progressRate(attempt, now);
+            if (attempt.progress.total > 0) rates.push_back(rate);
+            if (!task.backedUp && task.copiesRunning == 1 && now - attempt.started >= policy.minRuntime) {
+                candidates.emplace_back(rate, entry.first);
+            }
+        }
+        if (candidates.empty() || rates.size() < 2) return;
+        std::nth_element(rates.begin(), rates.begin() + static_cast<std::ptrdiff_t>(rates.size() / 2), rates.end());
+        const double median = rates[rates.size() / 2];
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const auto& candidate : candidates) {
+            if (candidate.first >= policy.slowFraction * median) break;
+            const Attempt& straggler = running.at(candidate.second);
+            Worker* target = nullptr;
+            for (auto& entry : workers) {
+                Worker& worker = entry.second;
+                if (worker.registered && worker.fd != straggler.workerFd && worker.running.size() < worker.slots) {
+                    target = &worker;
+                    break;
+                }
+            }
+            if (target == nullptr) return;
+            size_t taskIndex = straggler.task;
+            Logger::getInstance().log("Controller: #" + std::to_string(candidate.second) + " " + tasks[taskIndex].assignment.command +
+                                      " is a straggler (" + std::to_string(candidate.first) + "/s against a median of " +
+                                      std::to_string(median) + "/s); starting a backup copy.", Logger::Level::WARNING);
+            tasks[taskIndex].backedUp = true;
+            ++backups;
+            startCopy(*target, taskIndex, true);
+        }
+    }
+
+    void queueFrame(Worker& worker, FrameType type, uint32_t requestId, std::string_view payload) {
+        FrameProtocol::appendFrame(worker.outbox, type, requestId, payload);
+    }
+
+    // Writes as much of the outbox as the socket takes and waits for EPOLLOUT
+    // only while something is left. Returns false if the connection failed.
+    bool flush(Worker& worker) {
+        const int fd = worker.fd;
+        size_t written = 0;
+        while (written < worker.outbox.size()) {
+            ssize_t sent = ::send(fd, worker.outbox.data() + written, worker.outbox.size() - written, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            written += static_cast<size_t>(sent);
+        }
+        worker.outbox.erase(0, written);
+        bool wantWrite = !worker.outbox.empty();
+        if (wantWrite != worker.writeArmed) {
+            epoll_event event{};
+            event.events = static_cast<uint32_t>(wantWrite ? EPOLLIN | EPOLLOUT : EPOLLIN);
+            event.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+            worker.writeArmed = wantWrite;
+        }
+        return true;
+    }
+
+    int epollFd = -1;
+    int listenFd = -1;
+    uint16_t boundPort = 0;
+    size_t minWorkers = 1;
+    Policy policy;
+    size_t backups = 0;
+    bool dispatchStarted = false;
+    bool stopping = false;
+    bool failed = false;
+    std::string failure;
+    uint32_t nextRequestId = 1;
+    std::map<int, Worker> workers; // By socket
+    std::map<int, std::function<void()>> watched;
+    std::vector<Task> tasks;               // In submission order
+    std::map<uint32_t, Attempt> running;   // By request ID
+    std::vector<Stage> stages;
+    std::vector<TaskOutcome> completed;
+};
+
+#endif // CONTROLLER_SERVICE_H
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 #include <iostream>
@@ -8,6 +9,9 @@
 #include <sstream> // Required for std::stringstream
 #include "ERROR_Handler.h"
 #include "Logger.h"
+#include "MappedFile.h"
+#include "IntermediateFormat.h"
+#include "KeyValueBuffer.h"
 
 namespace fs = std::filesystem;
 class FileHandler {
@@ -203,18 +207,24 @@ public:
         return true;
     }
 
-    static bool read_mapped_data(const std::string &filename, std::vector<std::pair<std::string, int>> &mapped_data) {
+    static bool read_mapped_data(const std::string &filename, KeyValueBuffer &mapped_data) {
         Logger::getInstance().log("Attempting to read mapped data from file: " + filename);
     
-        std::ifstream infile(filename);
-        if (!infile) {
-            ErrorHandler::reportError("Could not open file " + filename + " for reading.");
+        MappedFile infile;
+        if (!infile.open(filename)) {
             return false;
         }
+
+        // Binary partition files are detected by their magic number; anything
+        // else is parsed as the original `word\tcount` text layout.
+        if (IntermediateFormat::isBinary(infile.view())) {
+            return read_binary_mapped_data(filename, infile.view(), mapped_data);
+        }
     
         std::string line;
         int line_number = 0;
-        while (std::getline(infile, line)) {
+        for (std::string_view line_view : infile.lines()) {
+            line.assign(line_view.data(), line_view.size());
             line_number++;
             //Logger::getInstance().log("Processing line " + std::to_string(line_number) + ": " + line);
     
@@ -242,27 +252,27 @@ public:
                         try {
                             count = std::stoi(count_str);
                             if (!word.empty()) { // Ensure word is not empty after trimming
-                                mapped_data.emplace_back(word, count);
+                                mapped_data.add(word, count);
                             } else {
-                                Logger::getInstance().log("WARNING: Word became empty after trimming on line " + std::to_string(line_number) + ": " + line);
+                                LOG_WARNING("Word became empty after trimming on line {}: {}", line_number, line);
                             }
                         } catch (const std::invalid_argument&) {
                             // Removed variable 'ia' here
-                            Logger::getInstance().log("WARNING: Invalid number format for count on line " + std::to_string(line_number) + " ('" + count_str + "'): " + line);
+                            LOG_WARNING("Invalid number format for count on line {} ('{}'): {}", line_number, count_str, line);
                         } catch (const std::out_of_range&) {
                             // Removed variable 'oor' here
-                            Logger::getInstance().log("WARNING: Count out of range on line " + std::to_string(line_number) + " ('" + count_str + "'): " + line);
+                            LOG_WARNING("Count out of range on line {} ('{}'): {}", line_number, count_str, line);
                         }
                     } else {
-                         Logger::getInstance().log("WARNING: Empty count string on line " + std::to_string(line_number) + ": " + line);
+                         LOG_WARNING("Empty count string on line {}: {}", line_number, line);
                     }
                 } catch (const std::exception &e) { // Catch other potential exceptions like std::out_of_range from substr
-                    Logger::getInstance().log("ERROR: Exception while processing line " + std::to_string(line_number) + ": " + line + ". Exception: " + e.what());
+                    LOG_ERROR("Exception while processing line {}: {}. Exception: {}", line_number, line, e.what());
                 }
             } else {
                 // Log if line is not empty but no tab was found
                 if (!line.empty() && line.find_first_not_of(" \t\n\r\f\v") != std::string::npos) { // Check if line is not just whitespace
-                   Logger::getInstance().log("WARNING: Skipped malformed line (no tab separator found) " + std::to_string(line_number) + ": " + line);
+                   LOG_WARNING("Skipped malformed line (no tab separator found) {}: {}", line_number, line);
                 }
             }
         }
@@ -270,9 +280,9 @@ public:
         infile.close();
     
         if (mapped_data.empty() && line_number > 0) { // Also check if any lines were processed
-            Logger::getInstance().log("WARNING: No valid data found in file: " + filename + " after processing " + std::to_string(line_number) + " lines.");
+            LOG_WARNING("No valid data found in file: {} after processing {} lines.", filename, line_number);
         } else if (!mapped_data.empty()) {
-            Logger::getInstance().log("Successfully read " + std::to_string(mapped_data.size()) + " entries from file: " + filename);
+            LOG_INFO("Successfully read {} entries from file: {}", mapped_data.size(), filename);
         } else {
              // File might be empty or contain only whitespace lines
             Logger::getInstance().log("File was empty or contained no processable data: " + filename);
@@ -280,4 +290,21 @@ public:
     
         return true;
     }
+
+private:
+    static bool read_binary_mapped_data(const std::string &filename, std::string_view bytes, KeyValueBuffer &mapped_data) {
+        const size_t initial_size = mapped_data.size();
+        std::string error;
+        bool ok = IntermediateFormat::forEachRecord(bytes, [&mapped_data](std::string_view word, int count) {
+            mapped_data.add(word, count);
+        }, error);
+        if (!ok) {
+            // Drop the partial read so a corrupt partition is never half-reduced.
+            mapped_data.truncate(initial_size);
+            ErrorHandler::reportError("Corrupt intermediate file " + filename + ": " + error);
+            return false;
+        }
+        LOG_INFO("Successfully read {} entries from binary file: {}", mapped_data.size() - initial_size, filename);
+        return true;
+    }
 };
\ No newline at end of file
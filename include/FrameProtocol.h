@@ -0,0 +1,423 @@
+#ifndef FRAME_PROTOCOL_H
+#define FRAME_PROTOCOL_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Controller/worker wire protocol
+// -------------------------------
+// Every message is one frame: a 16-byte header followed by payloadLength bytes,
+// so long commands are never truncated and back-to-back messages never merge.
+//
+// Frame header (little-endian):
+//   u32 magic          'M' 'R' 'F' 'P'
+//   u8  version        FrameProtocol::VERSION
+//   u8  type           FrameType
+//   u16 reserved       0
+//   u32 requestId      Task the frame belongs to; 0 for connection-level frames
+//   u32 payloadLength  At most FrameProtocol::MAX_PAYLOAD
+//
+// Request IDs let several tasks be in flight on one connection: the controller
+// picks a fresh ID for every JOB_ASSIGNMENT and the worker tags each STATUS,
+// PROGRESS and RESULT_MANIFEST of that task with it.
+//
+// Payload strings are a u32 length followed by the bytes.
+enum class FrameType : uint8_t {
+    JOB_ASSIGNMENT = 1,  // TaskAssignment, controller -> worker
+    STATUS = 2,          // Free text
+    HEARTBEAT = 3,       // WorkerHeartbeat, worker -> controller every HEARTBEAT_INTERVAL_MS, and in reply to an (empty) probe
+    PROGRESS = 4,        // TaskProgress
+    RESULT_MANIFEST = 5, // TaskResult, worker -> controller once a task ends
+    SHUTDOWN = 6,        // Empty, controller -> worker
+    REGISTER = 7         // WorkerInfo, worker -> controller right after connecting
+};
+
+// "map" or "reduce" plus the arguments of `MapReduce mapper|reducer`.
+// `attempt` numbers the copies of one task (reassignments, speculative backups),
+// so concurrent copies stage their output under different names.
+struct TaskAssignment {
+    std::string command;
+    std::vector<std::string> args;
+    uint32_t attempt = 0;
+};
+
+// What a worker offers: how many tasks it runs at once, and a name for logs.
+struct WorkerInfo {
+    uint32_t slots = 1;
+    std::string name;
+};
+
+// `done` and `total` are in the task's input unit (see TaskCounters); 0/0
+// means the worker cannot tell. `records` counts records emitted so far.
+struct TaskProgress {
+    uint64_t done = 0;
+    uint64_t total = 0;
+    uint64_t records = 0;
+};
+
+// Liveness plus the progress of every task running on the worker.
+struct WorkerHeartbeat {
+    std::vector<std::pair<uint32_t, TaskProgress>> tasks; // By request ID
+};
+
+// How a task ended and what it published: the mapper's partition manifest or
+// the reducer's output file. Empty if the task failed before publishing.
+struct TaskResult {
+    int32_t exitCode = 0;
+    std::string manifestPath;
+};
+
+struct Frame {
+    FrameType type = FrameType::STATUS;
+    uint32_t requestId = 0;
+    std::string_view payload; // Points into the FrameReader's buffer; see FrameReader
+};
+
+class FrameProtocol {
+public:
+    static constexpr uint32_t MAGIC = 0x5046524D; // "MRFP" read as little-endian u32
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr uint32_t MAX_PAYLOAD = 64 * 1024 * 1024;
+    static constexpr int HEARTBEAT_INTERVAL_MS = 1000;
+
+    static void encodeHeader(char* out, FrameType type, uint32_t requestId, uint32_t payloadLength) {
+        putU32(out, MAGIC);
+        out[4] = static_cast<char>(VERSION);
+        out[5] = static_cast<char>(type);
+        out[6] = 0;
+        out[7] = 0;
+        putU32(out + 8, requestId);
+        putU32(out + 12, payloadLength);
+    }
+
+    // Appends a whole frame to `out`, for senders that queue output on
+    // non-blocking sockets.
+    static void appendFrame(std::string& out, FrameType type, uint32_t requestId, std::string_view payload) {
+        char header[HEADER_SIZE];
+        encodeHeader(header, type, requestId, static_cast<uint32_t>(payload.size()));
+        out.append(header, HEADER_SIZE);
+        out.append(payload.data(), payload.size());
+    }
+
+    // Sends one frame with a single scatter-gather call (sendmsg, the socket
+    // form of writev): the header and the caller's payload go out without
+    // being copied into one buffer. Partial writes are resumed.
+    static bool sendFrame(int fd, FrameType type, uint32_t requestId, std::string_view payload, std::string& error) {
+        if (payload.size() > MAX_PAYLOAD) {
+            error = "frame payload of " + std::to_string(payload.size()) + " bytes exceeds the limit";
+            return false;
+        }
+        char header[HEADER_SIZE];
+        encodeHeader(header, type, requestId, static_cast<uint32_t>(payload.size()));
+        struct iovec parts[2];
+        parts[0].iov_base = header;
+        parts[0].iov_len = HEADER_SIZE;
+        parts[1].iov_base = const_cast<char*>(payload.data());
+        parts[1].iov_len = payload.size();
+        struct iovec* next = parts;
+        int remaining = payload.empty() ? 1 : 2;
+        while (remaining > 0) {
+            struct msghdr message{};
+            message.msg_iov = next;
+            message.msg_iovlen = static_cast<size_t>(remaining);
+            ssize_t sent = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                error = std::string("send failed: ") + std::strerror(errno);
+                return false;
+            }
+            size_t left = static_cast<size_t>(sent);
+            while (remaining > 0 && left >= next->iov_len) {
+                left -= next->iov_len;
+                ++next;
+                --remaining;
+            }
+            if (remaining > 0) {
+                next->iov_base = static_cast<char*>(next->iov_base) + left;
+                next->iov_len -= left;
+            }
+        }
+        return true;
+    }
+
+    static std::string encode(const TaskAssignment& task) {
+        std::string out;
+        putString(out, task.command);
+        putU32(out, static_cast<uint32_t>(task.args.size()));
+        for (const auto& arg : task.args) putString(out, arg);
+        putU32(out, task.attempt);
+        return out;
+    }
+
+    static std::string encode(const WorkerInfo& worker) {
+        std::string out;
+        putU32(out, worker.slots);
+        putString(out, worker.name);
+        return out;
+    }
+
+    static std::string encode(const TaskProgress& progress) {
+        std::string out;
+        putProgress(out, progress);
+        return out;
+    }
+
+    static std::string encode(const WorkerHeartbeat& heartbeat) {
+        std::string out;
+        putU32(out, static_cast<uint32_t>(heartbeat.tasks.size()));
+        for (const auto& task : heartbeat.tasks) {
+            putU32(out, task.first);
+            putProgress(out, task.second);
+        }
+        return out;
+    }
+
+    static std::string encode(const TaskResult& result) {
+        std::string out;
+        putU32(out, static_cast<uint32_t>(result.exitCode));
+        putString(out, result.manifestPath);
+        return out;
+    }
+
+    static bool decode(std::string_view in, TaskAssignment& task) {
+        size_t pos = 0;
+        uint32_t count = 0;
+        task = TaskAssignment();
+        if (!getString(in, pos, task.command) || !getU32(in, pos, count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            std::string arg;
+            if (!getString(in, pos, arg)) return false;
+            task.args.push_back(std::move(arg));
+        }
+        if (pos < in.size() && !getU32(in, pos, task.attempt)) return false; // Absent before attempts existed
+        return pos == in.size();
+    }
+
+    static bool decode(std::string_view in, WorkerInfo& worker) {
+        size_t pos = 0;
+        return getU32(in, pos, worker.slots) && getString(in, pos, worker.name) && pos == in.size();
+    }
+
+    static bool decode(std::string_view in, TaskProgress& progress) {
+        size_t pos = 0;
+        return getProgress(in, pos, progress) && pos == in.size();
+    }
+
+    static bool decode(std::string_view in, WorkerHeartbeat& heartbeat) {
+        size_t pos = 0;
+        uint32_t count = 0;
+        heartbeat = WorkerHeartbeat();
+        if (!in.empty() && !getU32(in, pos, count)) return false; // An empty payload is a heartbeat without tasks
+        for (uint32_t i = 0; i < count; ++i) {
+            std::pair<uint32_t, TaskProgress> task;
+            if (!getU32(in, pos, task.first) || !getProgress(in, pos, task.second)) return false;
+            heartbeat.tasks.push_back(task);
+        }
+        return pos == in.size();
+    }
+
+    static bool decode(std::string_view in, TaskResult& result) {
+        size_t pos = 0;
+        uint32_t exitCode = 0;
+        if (!getU32(in, pos, exitCode) || !getString(in, pos, result.manifestPath)) return false;
+        result.exitCode = static_cast<int32_t>(exitCode);
+        return pos == in.size();
+    }
+
+    static const char* typeName(FrameType type) {
+        switch (type) {
+            case FrameType::JOB_ASSIGNMENT: return "job";
+            case FrameType::STATUS: return "status";
+            case FrameType::HEARTBEAT: return "heartbeat";
+            case FrameType::PROGRESS: return "progress";
+            case FrameType::RESULT_MANIFEST: return "result";
+            case FrameType::SHUTDOWN: return "shutdown";
+            case FrameType::REGISTER: return "register";
+        }
+        return "unknown";
+    }
+
+    static void putU32(char* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    static uint32_t getU32(const char* in) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+        return value;
+    }
+
+private:
+    static void putU32(std::string& out, uint32_t value) {
+        char bytes[4];
+        putU32(bytes, value);
+        out.append(bytes, 4);
+    }
+    static void putU64(std::string& out, uint64_t value) {
+        putU32(out, static_cast<uint32_t>(value));
+        putU32(out, static_cast<uint32_t>(value >> 32));
+    }
+    static void putProgress(std::string& out, const TaskProgress& progress) {
+        putU64(out, progress.done);
+        putU64(out, progress.total);
+        putU64(out, progress.records);
+    }
+    static void putString(std::string& out, std::string_view value) {
+        putU32(out, static_cast<uint32_t>(value.size()));
+        out.append(value.data(), value.size());
+    }
+
+    static bool getU32(std::string_view in, size_t& pos, uint32_t& value) {
+        if (in.size() - pos < 4) return false;
+        value = getU32(in.data() + pos);
+        pos += 4;
+        return true;
+    }
+    static bool getU64(std::string_view in, size_t& pos, uint64_t& value) {
+        uint32_t low = 0, high = 0;
+        if (!getU32(in, pos, low) || !getU32(in, pos, high)) return false;
+        value = (static_cast<uint64_t>(high) << 32) | low;
+        return true;
+    }
+    static bool getProgress(std::string_view in, size_t& pos, TaskProgress& progress) {
+        return getU64(in, pos, progress.done) && getU64(in, pos, progress.total) && getU64(in, pos, progress.records);
+    }
+    static bool getString(std::string_view in, size_t& pos, std::string& value) {
+        uint32_t length = 0;
+        if (!getU32(in, pos, length) || in.size() - pos < length) return false;
+        value.assign(in.data() + pos, length);
+        pos += length;
+        return true;
+    }
+};
+
+// Reassembles frames from a stream socket. Each readFrom() is one readv into
+// the free tail of the buffer plus a 64 KiB overflow area, so whatever the
+// kernel has queued (several coalesced frames, or part of one) is taken in a
+// single call without growing the buffer up front. Once a header announces a
+// large payload, the buffer is grown to fit it and the rest is read in place.
+// Payload views handed out by nextFrame() stay valid until the next readFrom().
+class FrameReader {
+public:
+    enum class ReadResult { DATA, WOULD_BLOCK, CLOSED, FAILED };
+
+    static constexpr size_t OVERFLOW_SIZE = 64 * 1024;
+
+    ReadResult readFrom(int fd, std::string& error) {
+        compact();
+        size_t wanted = pendingFrameSize();
+        if (wanted > buffer.size() - start) buffer.resize(start + wanted);
+
+        char overflow[OVERFLOW_SIZE];
+        struct iovec parts[2];
+        parts[0].iov_base = buffer.data() + end;
+        parts[0].iov_len = buffer.size() - end;
+        parts[1].iov_base = overflow;
+        parts[1].iov_len = sizeof(overflow);
+        ssize_t received;
+        do {
+            received = ::readv(fd, parts, 2);
+        } while (received < 0 && errno == EINTR);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return ReadResult::WOULD_BLOCK;
+            error = std::string("read failed: ") + std::strerror(errno);
+            return ReadResult::FAILED;
+        }
+        if (received == 0) return ReadResult::CLOSED;
+
+        size_t count = static_cast<size_t>(received);
+        size_t inPlace = std::min(count, parts[0].iov_len);
+        end += inPlace;
+        if (count > inPlace) {
+            buffer.resize(end);
+            buffer.insert(buffer.end(), overflow, overflow + (count - inPlace));
+            end = buffer.size();
+        }
+        return ReadResult::DATA;
+    }
+
+    // Pops the next complete frame. Returns false with `error` empty when more
+    // bytes are needed, or with `error` set when the stream is not this protocol.
+    bool nextFrame(Frame& frame, std::string& error) {
+        if (end - start < FrameProtocol::HEADER_SIZE) return false;
+        const char* header = buffer.data() + start;
+        if (FrameProtocol::getU32(header) != FrameProtocol::MAGIC) {
+            error = "bad frame magic";
+            return false;
+        }
+        if (static_cast<uint8_t>(header[4]) != FrameProtocol::VERSION) {
+            error = "unsupported frame version " + std::to_string(static_cast<unsigned>(static_cast<uint8_t>(header[4])));
+            return false;
+        }
+        uint32_t payloadLength = FrameProtocol::getU32(header + 12);
+        if (payloadLength > FrameProtocol::MAX_PAYLOAD) {
+            error = "frame payload of " + std::to_string(payloadLength) + " bytes exceeds the limit";
+            return false;
+        }
+        if (end - start < FrameProtocol::HEADER_SIZE + payloadLength) return false;
+
+        frame.type = static_cast<FrameType>(static_cast<uint8_t>(header[5]));
+        frame.requestId = FrameProtocol::getU32(header + 8);
+        frame.payload = std::string_view(header + FrameProtocol::HEADER_SIZE, payloadLength);
+        start += FrameProtocol::HEADER_SIZE + payloadLength;
+        return true;
+    }
+
+    // Blocks until a whole frame has arrived. Returns false on close or error
+    // (`error` stays empty on an orderly close between frames).
+    bool receive(int fd, Frame& frame, std::string& error) {
+        while (true) {
+            if (nextFrame(frame, error)) return true;
+            if (!error.empty()) return false;
+            switch (readFrom(fd, error)) {
+                case ReadResult::DATA:
+                    break;
+                case ReadResult::CLOSED:
+                    if (end != start) error = "connection closed inside a frame";
+                    return false;
+                case ReadResult::WOULD_BLOCK:
+                case ReadResult::FAILED:
+                    return false;
+            }
+        }
+    }
+
+    size_t buffered() const { return end - start; }
+
+private:
+    // Moves unread bytes to the front; only done before reading, never while
+    // views from nextFrame() may still be in use by the caller.
+    void compact() {
+        if (start == 0) return;
+        std::memmove(buffer.data(), buffer.data() + start, end - start);
+        end -= start;
+        start = 0;
+    }
+
+    // Bytes needed to finish the frame at the front (at least a header's worth).
+    size_t pendingFrameSize() const {
+        size_t size = FrameProtocol::HEADER_SIZE;
+        if (end - start >= FrameProtocol::HEADER_SIZE) {
+            uint32_t payloadLength = FrameProtocol::getU32(buffer.data() + start + 12);
+            if (payloadLength <= FrameProtocol::MAX_PAYLOAD) size += payloadLength;
+        }
+        return std::max(size, static_cast<size_t>(4096));
+    }
+
+    std::vector<char> buffer;
+    size_t start = 0;
+    size_t end = 0;
+};
+
+#endif // FRAME_PROTOCOL_H
@@ -0,0 +1,78 @@
+#ifndef HASH_AGGREGATION_TABLE_H
+#define HASH_AGGREGATION_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Open-addressing (linear probing) table that sums counts per key. Keys are
+// stored as views, so the caller keeps the key bytes alive for the table's
+// lifetime. Slots are one flat array, so lookups touch one or two cache
+// lines instead of walking tree or list nodes.
+class HashAggregationTable {
+public:
+    explicit HashAggregationTable(size_t expectedKeys = 0) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * MAX_LOAD_NUMERATOR < expectedKeys * MAX_LOAD_DENOMINATOR) capacity *= 2;
+        slots.resize(capacity);
+    }
+
+    // `hash` must be a hash of `key` that is well mixed in its low bits. It must
+    // not be the Partitioner's hash: every key a reducer sees shares that hash's
+    // high bits, so callers use a different seed (see ReducerDLLso).
+    void add(std::string_view key, uint64_t hash, long long count) {
+        size_t mask = slots.size() - 1;
+        for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (!slot.occupied) {
+                slot = Slot{key, hash, count, true};
+                if (++used * MAX_LOAD_DENOMINATOR > slots.size() * MAX_LOAD_NUMERATOR) grow();
+                return;
+            }
+            if (slot.hash == hash && slot.key == key) {
+                slot.count += count;
+                return;
+            }
+        }
+    }
+
+    size_t size() const { return used; }
+
+    // Calls fn(std::string_view key, long long count) for every key, in slot order.
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : slots) {
+            if (slot.occupied) fn(slot.key, slot.count);
+        }
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr size_t MAX_LOAD_NUMERATOR = 7; // Grow past 70% occupancy
+    static constexpr size_t MAX_LOAD_DENOMINATOR = 10;
+
+    struct Slot {
+        std::string_view key;
+        uint64_t hash = 0;
+        long long count = 0;
+        bool occupied = false;
+    };
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (!slot.occupied) continue;
+            size_t i = static_cast<size_t>(slot.hash) & mask;
+            while (slots[i].occupied) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t used = 0;
+};
+
+#endif // HASH_AGGREGATION_TABLE_H
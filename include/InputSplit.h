@@ -0,0 +1,120 @@
+#ifndef INPUT_SPLIT_H
+#define INPUT_SPLIT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "Logger.h"
+#include "MappedFile.h"
+
+// A byte range of one input file handed to a single mapper. Splits produced by
+// InputSplitPlanner always start at the beginning of a line and end just after
+// a '\n' (or at end of file), so a word never straddles two splits.
+struct InputSplit {
+    std::string filePath;
+    size_t offset = 0;
+    size_t length = 0;
+
+    // Encodes the split as "<path>@<offset>+<length>" for mapper command lines.
+    std::string toString() const {
+        return filePath + "@" + std::to_string(offset) + "+" + std::to_string(length);
+    }
+
+    // Parses toString() output. Anything else is treated as a plain path
+    // covering the whole file, so existing mapper command lines keep working.
+    static InputSplit parse(const std::string& spec) {
+        InputSplit split;
+        split.filePath = spec;
+        split.length = MappedFile::WHOLE_FILE;
+
+        size_t at = spec.rfind('@');
+        size_t plus = spec.rfind('+');
+        if (at == std::string::npos || plus == std::string::npos || plus < at + 2 || plus + 1 >= spec.size()) {
+            return split;
+        }
+        std::string offsetStr = spec.substr(at + 1, plus - at - 1);
+        std::string lengthStr = spec.substr(plus + 1);
+        auto isNumber = [](const std::string& s) {
+            return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char c) { return c >= '0' && c <= '9'; });
+        };
+        if (!isNumber(offsetStr) || !isNumber(lengthStr)) {
+            return split;
+        }
+        split.filePath = spec.substr(0, at);
+        split.offset = static_cast<size_t>(std::stoull(offsetStr));
+        split.length = static_cast<size_t>(std::stoull(lengthStr));
+        return split;
+    }
+};
+
+// Plans line-aligned byte-range splits over a set of input files and spreads
+// them across mappers by size, so a single large file no longer lands on one
+// mapper while the others sit idle.
+class InputSplitPlanner {
+public:
+    static constexpr size_t DEFAULT_SPLIT_SIZE = 32 * 1024 * 1024;
+
+    // Cuts every file into splits of about splitSize bytes. A splitSize of 0
+    // keeps whole files. Each cut is moved forward to just past the next '\n'.
+    static std::vector<InputSplit> plan(const std::vector<std::string>& filePaths, size_t splitSize) {
+        std::vector<InputSplit> splits;
+        for (const auto& path : filePaths) {
+            std::error_code ec;
+            size_t fileSize = static_cast<size_t>(std::filesystem::file_size(path, ec));
+            if (ec) {
+                Logger::getInstance().log("InputSplitPlanner: Could not stat " + path + ": " + ec.message(), Logger::Level::ERROR);
+                continue;
+            }
+            if (splitSize == 0 || fileSize <= splitSize) {
+                splits.push_back({path, 0, fileSize});
+                continue;
+            }
+
+            // Only the pages around each cut point are touched.
+            MappedFile file;
+            if (!file.open(path)) continue;
+            std::string_view text = file.view();
+
+            size_t start = 0;
+            while (start < fileSize) {
+                size_t end = fileSize;
+                if (fileSize - start > splitSize) {
+                    size_t newline = text.find('\n', start + splitSize - 1);
+                    end = (newline == std::string_view::npos) ? fileSize : newline + 1;
+                }
+                splits.push_back({path, start, end - start});
+                start = end;
+            }
+        }
+        return splits;
+    }
+
+    // Assigns splits to numMappers mappers, largest first onto the least-loaded
+    // mapper. Splits of the same file stay in file order within a mapper.
+    static std::vector<std::vector<InputSplit>> assign(std::vector<InputSplit> splits, int numMappers) {
+        std::vector<std::vector<InputSplit>> assignments(numMappers > 0 ? numMappers : 0);
+        if (assignments.empty()) return assignments;
+
+        std::stable_sort(splits.begin(), splits.end(), [](const InputSplit& a, const InputSplit& b) {
+            return a.length > b.length;
+        });
+        std::vector<size_t> load(assignments.size(), 0);
+        for (auto& split : splits) {
+            size_t target = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+            load[target] += split.length;
+            assignments[target].push_back(std::move(split));
+        }
+        for (auto& mapperSplits : assignments) {
+            std::sort(mapperSplits.begin(), mapperSplits.end(), [](const InputSplit& a, const InputSplit& b) {
+                return a.filePath != b.filePath ? a.filePath < b.filePath : a.offset < b.offset;
+            });
+        }
+        return assignments;
+    }
+};
+
+#endif // INPUT_SPLIT_H
@@ -65,12 +65,16 @@ int runInteractiveWorkflow() {
         return 1; // Failure
     }
 
+    // validate_directory also lists the folder it validates; keep those listings
+    // away from the input file list so the output/temp checks do not replace it.
+    std::vector<std::string> validated_folder_listing;
+
     std::string output_folder_path;
     std::cout << "Enter the folder path for the output directory: ";
     std::getline(std::cin, output_folder_path);
     std::string default_output_path = blank_folder_path + "outputFolder";
     // This call uses the original 4-argument validate_directory
-    if (!FileHandler::validate_directory(output_folder_path, input_file_paths_interactive, default_output_path, true)) {
+    if (!FileHandler::validate_directory(output_folder_path, validated_folder_listing, default_output_path, true)) {
         Logger::getInstance().log("Invalid output folder path. Exiting.");
         return 1; // Failure
     }
@@ -81,7 +85,7 @@ int runInteractiveWorkflow() {
     std::getline(std::cin, temp_folder_path);
     std::string default_temp_path = blank_folder_path + "tempFolder";
     // This call uses the original 4-argument validate_directory
-    if (!FileHandler::validate_directory(temp_folder_path, input_file_paths_interactive, default_temp_path, true)) {
+    if (!FileHandler::validate_directory(temp_folder_path, validated_folder_listing, default_temp_path, true)) {
         Logger::getInstance().log("Invalid temporary folder path. Exiting.");
         return 1; // Failure
     }
@@ -92,12 +96,6 @@ int runInteractiveWorkflow() {
     std::cout << "Temporary Folder: " << temp_folder_path << std::endl;
     std::cout << "\nAll folder paths validated successfully. Proceeding with MapReduce...\n";
 
-    std::vector<std::string> extracted_lines;
-    // input_file_paths_interactive should be populated by your original FileHandler::validate_directory
-    for (const auto &file_path_from_interactive_input : input_file_paths_interactive) { 
-        FileHandler::read_file(file_path_from_interactive_input, extracted_lines);
-    }
-
     // MAP PHASE (Interactive - updated logic to match Mapper_DLL_so.h)
     // This uses the map and exportMappedData methods from the Mapper class
     std::string mapped_file_path = temp_folder_path + os_slash_type + "mapped_temp.txt";
@@ -110,11 +108,12 @@ int runInteractiveWorkflow() {
     Mapper mapper(logger, errorHandler);
 
     // Prepare intermediate data structure
-    std::vector<std::pair<std::string, int>> intermediateData;
+    KeyValueBuffer intermediateData;
 
-    // Process each line from extracted_lines
-    for (const std::string& line : extracted_lines) {
-        mapper.map("documentId_placeholder", line, intermediateData); // Provide a placeholder document ID
+    // Map each input file directly from its memory mapping
+    // input_file_paths_interactive should be populated by your original FileHandler::validate_directory
+    for (const auto &file_path_from_interactive_input : input_file_paths_interactive) {
+        mapper.mapFile(file_path_from_interactive_input, intermediateData);
     }
 
     // Export mapped data to the mapped_file_path
@@ -126,7 +125,7 @@ int runInteractiveWorkflow() {
     logger.log("Interactive Mode: Map phase produced intermediate file: " + mapped_file_path);
 
     // REDUCE PHASE
-    std::vector<std::pair<std::string, int>> mapped_data;
+    KeyValueBuffer mapped_data;
     if (!FileHandler::read_mapped_data(mapped_file_path, mapped_data)) {
         Logger::getInstance().log("ERROR: Failed to read mapped data from " + mapped_file_path + ". Exiting.\n");
         return 1; // Failure
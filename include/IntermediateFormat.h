@@ -0,0 +1,481 @@
+#ifndef INTERMEDIATE_FORMAT_H
+#define INTERMEDIATE_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #include <fstream>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// Encoding of the intermediate partition files written by mappers.
+// TEXT is the original "word\tcount\n" layout and is kept for debugging.
+enum class IntermediateEncoding {
+    BINARY,
+    TEXT
+};
+
+// How a mapper lays out its partitions on disk.
+// PER_REDUCER writes one file per reducer. INDEXED appends every reducer's
+// segment to a single spill file per mapper and records each segment's
+// offset and length, so a mapper holds one file descriptor whatever the
+// reducer count and a reducer reads only its own byte ranges.
+enum class IntermediateLayout {
+    PER_REDUCER,
+    INDEXED
+};
+
+// Binary intermediate format
+// --------------------------
+// A file is one or more segments; every export appends exactly one segment.
+//
+// Segment header (32 bytes, little-endian):
+//   u32 magic        'M' 'R' 'I' 'F'
+//   u16 version      IntermediateFormat::VERSION (MIN_VERSION and up are read)
+//   u16 flags        FLAG_SORTED if records are in ascending key order,
+//                    FLAG_DICTIONARY if keys are dictionary-encoded
+//   u64 recordCount  records in all blocks of the segment
+//   u32 blockCount
+//   u64 payloadSize  bytes of block data following the header
+//   u32 checksum     CRC-32 of the payload
+//
+// Block: varint recordCount, varint byteSize, then byteSize bytes of records.
+// Record: varint keyLength, key bytes, zigzag varint count.
+//
+// With FLAG_DICTIONARY (version 2) the payload starts with the segment's key
+// dictionary, before the first block: varint keyCount, varint byteSize, then
+// keyCount entries of varint keyLength and key bytes. A record is then a
+// varint index into the dictionary and a zigzag varint count, so each distinct
+// key is written once per segment however many records carry it.
+struct Crc32Table {
+    uint32_t entries[256];
+};
+
+constexpr Crc32Table buildCrc32Table() {
+    Crc32Table table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table.entries[i] = crc;
+    }
+    return table;
+}
+
+inline constexpr Crc32Table CRC32_TABLE = buildCrc32Table();
+
+class IntermediateFormat {
+public:
+    static constexpr uint32_t MAGIC = 0x4649524D; // "MRIF" read as little-endian u32
+    static constexpr uint16_t VERSION = 2;
+    static constexpr uint16_t MIN_VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    static constexpr uint16_t FLAG_SORTED = 0x1;
+    static constexpr uint16_t FLAG_DICTIONARY = 0x2;
+
+    static uint32_t crc32(const char* data, size_t size, uint32_t crc = 0) {
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc = CRC32_TABLE.entries[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    static void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // Returns false on truncated or over-long input.
+    static bool getVarint(std::string_view in, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            unsigned char byte = static_cast<unsigned char>(in[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    static uint64_t zigzagEncode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t zigzagDecode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    template <typename T>
+    static void putFixed(char* out, T value) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out[i] = static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF);
+        }
+    }
+
+    template <typename T>
+    static T getFixed(const char* in) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+        }
+        return static_cast<T>(value);
+    }
+
+    // True if `bytes` starts with a binary segment header.
+    static bool isBinary(std::string_view bytes) {
+        return bytes.size() >= 4 && getFixed<uint32_t>(bytes.data()) == MAGIC;
+    }
+
+    // Builds one segment in memory. Records are grouped into blocks of about
+    // blockSize bytes. finish() returns the complete segment, header first.
+    // With FLAG_DICTIONARY a record whose key equals the previous record's
+    // reuses its dictionary entry, so a sorted segment stores each key once.
+    class Writer {
+    public:
+        explicit Writer(size_t blockSize = DEFAULT_BLOCK_SIZE, uint16_t segmentFlags = 0)
+            : targetBlockSize(blockSize), flags(segmentFlags), records(0), blocks(0), blockRecords(0), dictionaryKeys(0) {}
+
+        void add(std::string_view key, int count) {
+            if ((flags & FLAG_DICTIONARY) != 0) {
+                if (dictionaryKeys == 0 || key != std::string_view(dictionary).substr(lastKeyOffset)) {
+                    putVarint(dictionary, key.size());
+                    lastKeyOffset = dictionary.size();
+                    dictionary.append(key.data(), key.size());
+                    ++dictionaryKeys;
+                }
+                putVarint(block, dictionaryKeys - 1);
+            } else {
+                putVarint(block, key.size());
+                block.append(key.data(), key.size());
+            }
+            putVarint(block, zigzagEncode(count));
+            ++blockRecords;
+            ++records;
+            if (block.size() >= targetBlockSize) flushBlock();
+        }
+
+        uint64_t recordCount() const { return records; }
+
+        const std::string& finish() {
+            flushBlock();
+            std::string prefix; // The dictionary, ahead of the blocks
+            if ((flags & FLAG_DICTIONARY) != 0) {
+                putVarint(prefix, dictionaryKeys);
+                putVarint(prefix, dictionary.size());
+                prefix.append(dictionary);
+            }
+            segment.resize(HEADER_SIZE + prefix.size() + payload.size());
+            char* header = &segment[0];
+            putFixed<uint32_t>(header, MAGIC);
+            putFixed<uint16_t>(header + 4, VERSION);
+            putFixed<uint16_t>(header + 6, flags);
+            putFixed<uint64_t>(header + 8, records);
+            putFixed<uint32_t>(header + 16, blocks);
+            putFixed<uint64_t>(header + 20, prefix.size() + payload.size());
+            putFixed<uint32_t>(header + 28, crc32(payload.data(), payload.size(), crc32(prefix.data(), prefix.size())));
+            if (!prefix.empty()) std::memcpy(header + HEADER_SIZE, prefix.data(), prefix.size());
+            if (!payload.empty()) std::memcpy(header + HEADER_SIZE + prefix.size(), payload.data(), payload.size());
+            return segment;
+        }
+
+    private:
+        void flushBlock() {
+            if (blockRecords == 0) return;
+            putVarint(payload, blockRecords);
+            putVarint(payload, block.size());
+            payload.append(block);
+            block.clear();
+            blockRecords = 0;
+            ++blocks;
+        }
+
+        size_t targetBlockSize;
+        uint16_t flags;
+        uint64_t records;
+        uint32_t blocks;
+        uint64_t blockRecords;
+        uint64_t dictionaryKeys;
+        size_t lastKeyOffset = 0; // Of the newest dictionary key's bytes
+        std::string block;
+        std::string payload;
+        std::string dictionary;
+        std::string segment;
+    };
+
+    // One validated segment: header fields plus a view of its block data.
+    struct Segment {
+        uint16_t flags = 0;
+        uint64_t recordCount = 0;
+        uint32_t blockCount = 0;
+        std::string_view payload;
+
+        bool isSorted() const { return (flags & FLAG_SORTED) != 0; }
+        bool hasDictionary() const { return (flags & FLAG_DICTIONARY) != 0; }
+    };
+
+    // Reads the segment starting at `pos` and advances `pos` past it. The header
+    // and payload checksum are verified; records are not decoded.
+    static bool readSegment(std::string_view bytes, size_t& pos, Segment& segment, std::string& error) {
+        if (bytes.size() - pos < HEADER_SIZE) {
+            error = "truncated segment header at offset " + std::to_string(pos);
+            return false;
+        }
+        const char* header = bytes.data() + pos;
+        if (getFixed<uint32_t>(header) != MAGIC) {
+            error = "bad magic number at offset " + std::to_string(pos);
+            return false;
+        }
+        uint16_t version = getFixed<uint16_t>(header + 4);
+        if (version < MIN_VERSION || version > VERSION) {
+            error = "unsupported format version " + std::to_string(version);
+            return false;
+        }
+        uint64_t payloadSize = getFixed<uint64_t>(header + 20);
+        if (payloadSize > bytes.size() - pos - HEADER_SIZE) {
+            error = "truncated segment payload at offset " + std::to_string(pos);
+            return false;
+        }
+        segment.flags = getFixed<uint16_t>(header + 6);
+        segment.recordCount = getFixed<uint64_t>(header + 8);
+        segment.blockCount = getFixed<uint32_t>(header + 16);
+        segment.payload = bytes.substr(pos + HEADER_SIZE, payloadSize);
+        if (crc32(segment.payload.data(), segment.payload.size()) != getFixed<uint32_t>(header + 28)) {
+            error = "checksum mismatch in segment at offset " + std::to_string(pos);
+            return false;
+        }
+        pos += HEADER_SIZE + payloadSize;
+        return true;
+    }
+
+    // Decodes the records of one segment in order. Keys are views into the
+    // segment's payload, so the cursor holds no per-record memory; a
+    // dictionary-encoded segment costs one view per dictionary key.
+    class RecordCursor {
+    public:
+        RecordCursor() = default;
+        explicit RecordCursor(const Segment& source) : segment(source) {}
+
+        // Returns false at the end of the segment or on corrupt data; failed()
+        // tells the two apart.
+        bool next(std::string_view& key, int& count) {
+            if (segment.hasDictionary() && !dictionaryRead && !readDictionary()) {
+                corrupt = true;
+                return false;
+            }
+            while (blockRemaining == 0) {
+                if (blocksRead == segment.blockCount) {
+                    if (recordsRead != segment.recordCount || pos != segment.payload.size()) corrupt = true;
+                    return false;
+                }
+                uint64_t blockSize = 0;
+                if (!getVarint(segment.payload, pos, blockRemaining) || !getVarint(segment.payload, pos, blockSize) ||
+                    blockSize > segment.payload.size() - pos) {
+                    corrupt = true;
+                    return false;
+                }
+                blockEnd = pos + static_cast<size_t>(blockSize);
+                ++blocksRead;
+            }
+            std::string_view block = segment.payload.substr(0, blockEnd);
+            uint64_t keyLength = 0;
+            uint64_t value = 0;
+            if (segment.hasDictionary()) {
+                uint64_t index = 0;
+                if (!getVarint(block, pos, index) || index >= dictionary.size()) {
+                    corrupt = true;
+                    return false;
+                }
+                key = dictionary[static_cast<size_t>(index)];
+            } else {
+                if (!getVarint(block, pos, keyLength) || keyLength > block.size() - pos) {
+                    corrupt = true;
+                    return false;
+                }
+                key = block.substr(pos, static_cast<size_t>(keyLength));
+                pos += static_cast<size_t>(keyLength);
+            }
+            if (!getVarint(block, pos, value)) {
+                corrupt = true;
+                return false;
+            }
+            count = static_cast<int>(zigzagDecode(value));
+            ++recordsRead;
+            if (--blockRemaining == 0 && pos != blockEnd) {
+                corrupt = true;
+                return false;
+            }
+            return true;
+        }
+
+        bool failed() const { return corrupt; }
+
+    private:
+        // Leaves pos at the first block.
+        bool readDictionary() {
+            dictionaryRead = true;
+            uint64_t keyCount = 0;
+            uint64_t byteSize = 0;
+            if (!getVarint(segment.payload, pos, keyCount) || !getVarint(segment.payload, pos, byteSize) ||
+                byteSize > segment.payload.size() - pos || keyCount > byteSize) {
+                return false;
+            }
+            std::string_view keys = segment.payload.substr(0, pos + static_cast<size_t>(byteSize));
+            dictionary.reserve(static_cast<size_t>(keyCount));
+            for (uint64_t i = 0; i < keyCount; ++i) {
+                uint64_t keyLength = 0;
+                if (!getVarint(keys, pos, keyLength) || keyLength > keys.size() - pos) return false;
+                dictionary.push_back(keys.substr(pos, static_cast<size_t>(keyLength)));
+                pos += static_cast<size_t>(keyLength);
+            }
+            return pos == keys.size();
+        }
+
+        Segment segment;
+        std::vector<std::string_view> dictionary; // Keys of a dictionary-encoded segment, by index
+        bool dictionaryRead = false;
+        size_t pos = 0;
+        size_t blockEnd = 0;
+        uint64_t blockRemaining = 0;
+        uint32_t blocksRead = 0;
+        uint64_t recordsRead = 0;
+        bool corrupt = false;
+    };
+
+    // Decodes every segment in `bytes`, calling fn(std::string_view key, int count)
+    // per record. Each segment's checksum is verified before any of its records are
+    // delivered. On failure returns false with a description in `error`.
+    template <typename Fn>
+    static bool forEachRecord(std::string_view bytes, Fn&& fn, std::string& error) {
+        size_t pos = 0;
+        while (pos < bytes.size()) {
+            size_t segmentStart = pos;
+            Segment segment;
+            if (!readSegment(bytes, pos, segment, error)) return false;
+            RecordCursor cursor(segment);
+            std::string_view key;
+            int count = 0;
+            while (cursor.next(key, count)) {
+                fn(key, count);
+            }
+            if (cursor.failed()) {
+                error = "corrupt record data in segment at offset " + std::to_string(segmentStart);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Appends segments to one file through a single open descriptor, so a
+    // mapper writing many segments pays for one open/close, not one per segment.
+    // offset() is where the next append() will start.
+    class Appender {
+    public:
+        Appender() = default;
+        ~Appender() {
+            std::string ignored;
+            close(ignored);
+        }
+        Appender(const Appender&) = delete;
+        Appender& operator=(const Appender&) = delete;
+
+        bool open(const std::string& filePath, std::string& error) {
+            path = filePath;
+        #ifdef _WIN32
+            out.open(path, std::ios::binary | std::ios::app);
+            if (!out) {
+                error = "could not open " + path;
+                return false;
+            }
+            out.seekp(0, std::ios::end);
+            position = static_cast<uint64_t>(out.tellp());
+        #else
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (fd < 0) {
+                error = "could not open " + path + ": " + std::strerror(errno);
+                return false;
+            }
+            off_t end = ::lseek(fd, 0, SEEK_END);
+            position = end < 0 ? 0 : static_cast<uint64_t>(end);
+        #endif
+            return true;
+        }
+
+        uint64_t offset() const { return position; }
+
+        // Writes `bytes` with O_APPEND where the platform allows, so concurrent
+        // writers appending whole segments do not interleave records.
+        bool append(std::string_view bytes, std::string& error) {
+        #ifdef _WIN32
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            if (out.fail()) {
+                error = "could not write " + path;
+                return false;
+            }
+        #else
+            size_t written = 0;
+            while (written < bytes.size()) {
+                ssize_t n = ::write(fd, bytes.data() + written, bytes.size() - written);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    error = "could not write " + path + ": " + std::strerror(errno);
+                    return false;
+                }
+                written += static_cast<size_t>(n);
+            }
+        #endif
+            position += bytes.size();
+            return true;
+        }
+
+        bool close(std::string& error) {
+        #ifdef _WIN32
+            if (!out.is_open()) return true;
+            out.close();
+            if (out.fail()) {
+                error = "could not write " + path;
+                return false;
+            }
+        #else
+            if (fd < 0) return true;
+            int result = ::close(fd);
+            fd = -1;
+            if (result != 0) {
+                error = "could not close " + path + ": " + std::strerror(errno);
+                return false;
+            }
+        #endif
+            return true;
+        }
+
+    private:
+        std::string path;
+        uint64_t position = 0;
+    #ifdef _WIN32
+        std::ofstream out;
+    #else
+        int fd = -1;
+    #endif
+    };
+
+    // Appends `bytes` to `path` in a single O_APPEND write where the platform allows,
+    // so concurrent mappers appending whole segments do not interleave records.
+    static bool appendToFile(const std::string& path, const std::string& bytes, std::string& error) {
+        Appender appender;
+        return appender.open(path, error) && appender.append(bytes, error) && appender.close(error);
+    }
+};
+
+#endif // INTERMEDIATE_FORMAT_H
@@ -0,0 +1,127 @@
+#ifndef KEY_DICTIONARY_H
+#define KEY_DICTIONARY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "StableHash.h"
+
+// Bump allocator for key bytes. Chunks never move, so views of stored keys stay
+// valid until reset(), which keeps the first chunk for reuse.
+class KeyArena {
+public:
+    static constexpr size_t CHUNK_SIZE = 256 * 1024; // Keys longer than this get a chunk of their own
+
+    std::string_view store(std::string_view key) {
+        if (key.empty()) return std::string_view();
+        if (remaining < key.size()) {
+            size_t size = std::max(CHUNK_SIZE, key.size());
+            chunks.push_back(Chunk{std::unique_ptr<char[]>(new char[size]), size});
+            cursor = chunks.back().bytes.get();
+            remaining = size;
+        }
+        char* stored = cursor;
+        std::memcpy(stored, key.data(), key.size());
+        cursor += key.size();
+        remaining -= key.size();
+        bytesStored += key.size();
+        return std::string_view(stored, key.size());
+    }
+
+    size_t bytesUsed() const { return bytesStored; } // Key bytes stored since the last reset()
+
+    void reset() {
+        if (chunks.size() > 1 || (!chunks.empty() && chunks[0].size != CHUNK_SIZE)) chunks.clear();
+        cursor = chunks.empty() ? nullptr : chunks[0].bytes.get();
+        remaining = chunks.empty() ? 0 : CHUNK_SIZE;
+        bytesStored = 0;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> bytes;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    char* cursor = nullptr;
+    size_t remaining = 0; // Free bytes after cursor in the current chunk
+    size_t bytesStored = 0;
+};
+
+// Interning dictionary for one mapper's keys. Each distinct key is stored once
+// and gets a dense ID in order of first appearance, along with its StableHash
+// under the dictionary's seed. With the job's partition seed, that cached hash
+// is the one Partitioner would compute, so a key is hashed once per mapper
+// however often it occurs. IDs and key views stay valid until clear().
+class KeyDictionary {
+public:
+    explicit KeyDictionary(uint64_t hashSeed = 0) : hashSeed(hashSeed) {}
+    KeyDictionary(const KeyDictionary&) = delete;
+    KeyDictionary& operator=(const KeyDictionary&) = delete;
+
+    uint32_t intern(std::string_view key) {
+        const uint64_t hash = StableHash::hash(key, hashSeed);
+        if ((keys.size() + 1) * 4 > slots.size() * 3) grow();
+        const size_t mask = slots.size() - 1;
+        for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+            uint32_t slot = slots[i];
+            if (slot == 0) {
+                uint32_t id = static_cast<uint32_t>(keys.size());
+                keys.push_back(arena.store(key));
+                hashes.push_back(hash);
+                slots[i] = id + 1;
+                return id;
+            }
+            if (hashes[slot - 1] == hash && keys[slot - 1] == key) return slot - 1;
+        }
+    }
+
+    std::string_view key(uint32_t id) const { return keys[id]; }
+    uint64_t hash(uint32_t id) const { return hashes[id]; }
+    size_t size() const { return keys.size(); }
+    uint64_t seed() const { return hashSeed; }
+
+    size_t memoryUsed() const {
+        return arena.bytesUsed() + keys.size() * (sizeof(std::string_view) + sizeof(uint64_t)) + slots.size() * sizeof(uint32_t);
+    }
+
+    // IDs of all keys in ascending byte order of key.
+    std::vector<uint32_t> sortedIds() const {
+        std::vector<uint32_t> ids(keys.size());
+        for (uint32_t id = 0; id < ids.size(); ++id) ids[id] = id;
+        std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+        return ids;
+    }
+
+    void clear() {
+        keys.clear();
+        hashes.clear();
+        slots.clear();
+        arena.reset();
+    }
+
+private:
+    void grow() {
+        std::vector<uint32_t> grown(std::max<size_t>(slots.size() * 2, 1024), 0);
+        const size_t mask = grown.size() - 1;
+        for (uint32_t id = 0; id < keys.size(); ++id) {
+            size_t i = static_cast<size_t>(hashes[id]) & mask;
+            while (grown[i] != 0) i = (i + 1) & mask;
+            grown[i] = id + 1;
+        }
+        slots.swap(grown);
+    }
+
+    uint64_t hashSeed;
+    KeyArena arena;
+    std::vector<std::string_view> keys; // By ID
+    std::vector<uint64_t> hashes;       // By ID
+    std::vector<uint32_t> slots;        // Open addressing, ID + 1; 0 is empty
+};
+
+#endif // KEY_DICTIONARY_H
@@ -0,0 +1,148 @@
+#ifndef KEY_VALUE_BUFFER_H
+#define KEY_VALUE_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "KeyDictionary.h"
+
+// Intermediate {key, count} records, as mappers emit, partition and spill them
+// and reducers aggregate them. Key bytes are bump-allocated into arena chunks
+// that never move; each record is a 16-byte {key pointer, length, count} entry
+// in one contiguous vector. Adding a record is a copy into the current chunk
+// plus a vector append, never an allocation per key, and clear() keeps the
+// first chunk and the record capacity for the next batch.
+//
+// After internKeys(), keys go into a KeyDictionary instead: each distinct key
+// is stored once, and every record also carries its key's ID (keyId()), which
+// the combiner and partitioners work on. clear() keeps the dictionary, so IDs
+// stay valid across spills; clearKeys() drops it as well.
+//
+// Keys (and the string_views handed out for them) stay valid until clear(),
+// or clearKeys() for interned keys; truncate() past them does not free their
+// bytes. Move-only.
+class KeyValueBuffer {
+public:
+    static constexpr size_t CHUNK_SIZE = KeyArena::CHUNK_SIZE;
+
+    struct Record {
+        const char* keyData;
+        uint32_t keyLength;
+        int value;
+
+        std::string_view key() const { return std::string_view(keyData, keyLength); }
+    };
+
+    KeyValueBuffer() = default;
+    KeyValueBuffer(KeyValueBuffer&&) noexcept = default;
+    KeyValueBuffer& operator=(KeyValueBuffer&&) noexcept = default;
+    KeyValueBuffer(const KeyValueBuffer&) = delete;
+    KeyValueBuffer& operator=(const KeyValueBuffer&) = delete;
+
+    void add(std::string_view key, int value) {
+        if (dictionary) {
+            addInterned(dictionary->intern(key), value);
+            return;
+        }
+        std::string_view stored = arena.store(key);
+        records.push_back(Record{stored.data(), static_cast<uint32_t>(stored.size()), value});
+    }
+
+    // Switches to interned keys hashed with hashSeed; records already added are
+    // interned too. No-op if keys are already interned.
+    void internKeys(uint64_t hashSeed = 0) {
+        if (dictionary) return;
+        dictionary = std::make_unique<KeyDictionary>(hashSeed);
+        keyIds.reserve(records.capacity());
+        for (Record& record : records) {
+            uint32_t id = dictionary->intern(record.key());
+            record.keyData = dictionary->key(id).data();
+            keyIds.push_back(id);
+        }
+        arena.reset();
+    }
+
+    bool internsKeys() const { return dictionary != nullptr; }
+    const KeyDictionary* keyDictionary() const { return dictionary.get(); } // Null unless interned
+
+    // Interned keys only: the ID of `key`, adding it to the dictionary if new.
+    uint32_t intern(std::string_view key) { return dictionary->intern(key); }
+
+    // Interned keys only: adds a record for a key already in the dictionary.
+    void addInterned(uint32_t keyId, int value) {
+        std::string_view key = dictionary->key(keyId);
+        records.push_back(Record{key.data(), static_cast<uint32_t>(key.size()), value});
+        keyIds.push_back(keyId);
+    }
+
+    uint32_t keyId(size_t i) const { return keyIds[i]; } // Interned keys only
+
+    void reserve(size_t recordCount) {
+        records.reserve(recordCount);
+        if (dictionary) keyIds.reserve(recordCount);
+    }
+
+    size_t size() const { return records.size(); }
+    bool empty() const { return records.empty(); }
+    const Record& operator[](size_t i) const { return records[i]; }
+    const Record* data() const { return records.data(); }
+    std::vector<Record>::const_iterator begin() const { return records.begin(); }
+    std::vector<Record>::const_iterator end() const { return records.end(); }
+
+    // Bytes held for the records added since the last clear(): record entries
+    // plus key bytes, or the whole dictionary for interned keys. What a spill
+    // budget is measured against.
+    size_t memoryUsed() const {
+        return records.size() * sizeof(Record) + keyIds.size() * sizeof(uint32_t) + arena.bytesUsed() +
+               (dictionary ? dictionary->memoryUsed() : 0);
+    }
+
+    // Sorts records [first, size()) by key bytes; equal keys keep no particular order.
+    void sortByKey(size_t first = 0) {
+        first = std::min(first, records.size());
+        if (!dictionary) {
+            std::sort(records.begin() + static_cast<std::ptrdiff_t>(first), records.end(),
+                      [](const Record& a, const Record& b) { return a.key() < b.key(); });
+            return;
+        }
+        // Key IDs move with their records
+        std::vector<std::pair<Record, uint32_t>> sorted;
+        sorted.reserve(records.size() - first);
+        for (size_t i = first; i < records.size(); ++i) sorted.emplace_back(records[i], keyIds[i]);
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first.key() < b.first.key(); });
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            records[first + i] = sorted[i].first;
+            keyIds[first + i] = sorted[i].second;
+        }
+    }
+
+    // Drops the records from `count` on. Their key bytes stay in the arena.
+    void truncate(size_t count) {
+        if (count < records.size()) records.resize(count);
+        if (count < keyIds.size()) keyIds.resize(count);
+    }
+
+    void clear() {
+        records.clear();
+        keyIds.clear();
+        arena.reset();
+    }
+
+    // clear(), and forget every interned key. Invalidates key IDs.
+    void clearKeys() {
+        clear();
+        if (dictionary) dictionary->clear();
+    }
+
+private:
+    KeyArena arena;
+    std::vector<Record> records;
+    std::unique_ptr<KeyDictionary> dictionary; // Set once keys are interned
+    std::vector<uint32_t> keyIds;              // Per record, for interned keys
+};
+
+#endif // KEY_VALUE_BUFFER_H
@@ -1,13 +1,32 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <iostream>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 #include <chrono>
-#include <ctime>   // For std::time_t, std::tm
-#include <iomanip> // For std::put_time
-#include <sstream> // For std::ostringstream for timestamp
+#include <ctime>   // For std::time_t, std::tm, std::strftime
+#include "BinaryLog.h"
 
+// Process-wide logger. By default every call formats and writes its line
+// synchronously under a mutex. In async mode (setAsync(true)) log() only copies
+// the message into a lock-free ring owned by the calling thread; a background
+// writer drains all rings, formats timestamps (cached per second) and writes
+// and flushes in batches. Messages below the minimum level are dropped before
+// any formatting in both modes.
+//
+// The LOG_DEBUG/LOG_INFO/LOG_WARNING/LOG_ERROR macros below take a "{}" format
+// string and raw arguments. They compile to nothing below LOG_COMPILE_LEVEL
+// and otherwise capture the arguments unformatted; the text is rendered by the
+// writer, or, with setOutputFormat(OutputFormat::BINARY), never in-process:
+// records go to "<log file>.bin" for `MapReduce decode-log`.
 class Logger {
 public:
     enum class Level {
@@ -17,6 +36,26 @@ public:
         WARNING
     };
 
+    enum class OutputFormat {
+        TEXT,  // "[timestamp] [LEVEL] prefix message" lines in the log file
+        BINARY // BinaryLog records in "<log file>.bin"
+    };
+
+    static constexpr size_t RING_CAPACITY = 1024;                          // Pending messages per thread in async mode
+    static constexpr std::chrono::milliseconds WRITER_INTERVAL{20};        // Longest an async message waits to be written
+    static constexpr const char* BINARY_LOG_SUFFIX = ".bin";
+
+    // One per LOG_* call site (a constant-initialized static). Its format id is
+    // assigned on first use and never changes.
+    struct CallSite {
+        constexpr CallSite(Level siteLevel, const char* siteFile, int siteLine)
+            : level(siteLevel), file(siteFile), line(siteLine), id(0) {}
+        Level level;
+        const char* file;
+        int line;
+        std::atomic<uint32_t> id;
+    };
+
     static Logger& getInstance() {
         static Logger instance; // Meyers' Singleton
         return instance;
@@ -26,12 +65,14 @@ public:
     Logger& operator=(const Logger&) = delete;
 
     void configureLogFilePath(const std::string& path) {
+        flush(); // Pending async messages belong to the previous file
         std::lock_guard<std::mutex> lock(mutex_);
         if (logFile_.is_open()) {
             logFile_.close();
         }
-        logFilePath_ = path; 
-        logFile_.open(path, std::ios::app); 
+        closeBinaryFile();
+        logFilePath_ = path;
+        logFile_.open(path, std::ios::app);
         if (!logFile_) {
             std::cerr << "[LOGGER_ERROR] Could not open log file for writing: " << path << std::endl;
         } else {
@@ -41,48 +82,236 @@ public:
     }
 
     void setPrefix(const std::string& prefix) {
+        flush(); // Pending async messages keep the prefix they were logged under
         std::lock_guard<std::mutex> lock(mutex_);
         logPrefix_ = prefix;
     }
 
-    void log(const std::string& message, Level level = Level::INFO) {
+    // Severity order is DEBUG < INFO < WARNING < ERROR. Defaults to DEBUG (log everything).
+    void setMinimumLevel(Level level) { minimumSeverity_.store(severity(level), std::memory_order_relaxed); }
+
+    // Lets callers skip building a message that would be dropped.
+    bool isEnabled(Level level) const { return severity(level) >= minimumSeverity_.load(std::memory_order_relaxed); }
+
+    // Also echo every line to std::cout (the default). The echo is always text,
+    // so turn it off to keep BINARY output free of formatting work.
+    void setConsoleOutput(bool enabled) { consoleOutput_.store(enabled, std::memory_order_relaxed); }
+
+    void setOutputFormat(OutputFormat format) {
+        flush();
         std::lock_guard<std::mutex> lock(mutex_);
-        std::string levelStr = getLevelString(level);
-        // Use public getTimestamp() for formatting
-        std::string fullMessage = "[" + getTimestamp() + "] [" + levelStr + "] " + logPrefix_ + message;
-        
-        if (logFile_.is_open()) {
-            logFile_ << fullMessage << std::endl;
-        } else {
-            std::cerr << "[LOG_TO_CERR] " << fullMessage << std::endl;
+        outputFormat_ = format;
+    }
+
+    // Starts or stops the background writer. Stopping writes everything still pending.
+    void setAsync(bool enabled) {
+        std::lock_guard<std::mutex> lock(asyncControlMutex_);
+        if (enabled == async_.load(std::memory_order_relaxed)) return;
+        if (enabled) {
+            {
+                std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+                stopWriter_ = false;
+            }
+            writerThread_ = std::thread([this]() { writerLoop(); });
+            async_.store(true, std::memory_order_release);
+            return;
+        }
+        async_.store(false, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in logAsync
+        {
+            std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+            stopWriter_ = true;
         }
-        std::cout << fullMessage << std::endl;
+        wakeCondition_.notify_all();
+        writerThread_.join(); // The writer drains every ring before it exits
+        // A producer that saw async_ still set may have pushed after that last
+        // pass; either this drain sees its message or the producer sees async_
+        // cleared and drains its ring itself.
+        drainPending();
+    }
+
+    bool isAsync() const { return async_.load(std::memory_order_acquire); }
+
+    // Blocks until every message this thread logged so far is written and the file is flushed.
+    void flush() {
+        if (!async_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (logFile_.is_open()) logFile_.flush();
+            if (binaryFile_.is_open()) binaryFile_.flush();
+            return;
+        }
+        std::unique_lock<std::mutex> wakeLock(wakeMutex_);
+        uint64_t ticket = ++flushRequested_;
+        wakeCondition_.notify_all();
+        flushedCondition_.wait(wakeLock, [this, ticket]() { return flushCompleted_ >= ticket || stopWriter_; });
+    }
+
+    void log(const std::string& message, Level level = Level::INFO) {
+        if (!isEnabled(level)) return;
+        submit(BinaryLog::PLAIN_FORMAT_ID, level, message);
+    }
+
+    // Backend of the LOG_* macros; call those instead. Arguments are numbers or
+    // strings and are stored unformatted.
+    template <typename... Args>
+    void logFormat(CallSite& site, const char* format, const Args&... args) {
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0) id = registerFormat(site, format, BinaryLog::signature<Args...>());
+        thread_local std::string payload;
+        payload.clear();
+        BinaryLog::appendArgs(payload, args...);
+        submit(id, site.level, payload);
     }
 
     // Made public for use in main.cpp SUCCESS file. Consider alternatives for better encapsulation.
     std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto in_time_t = std::chrono::system_clock::to_time_t(now);
-        std::ostringstream ss;
-        std::tm timeinfo{}; // Value-initialize
-        #ifdef _WIN32
-            localtime_s(&timeinfo, &in_time_t);
-        #else
-            localtime_r(&in_time_t, &timeinfo); // POSIX version
-        #endif
-        ss << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S");
-        return ss.str();
+        return formatTime(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    }
+
+    // Renders a binary log as the text lines the TEXT format would have written.
+    static bool decodeBinaryLog(std::string_view bytes, std::string& out, std::string& error) {
+        struct Format {
+            std::string signature;
+            std::string text;
+        };
+        const std::string_view magic(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+        std::vector<Format> formats;
+        std::string_view prefix;
+        std::string timestamp;
+        std::time_t timestampSecond = -1;
+        size_t pos = 0;
+        while (pos < bytes.size()) {
+            if (bytes.substr(pos, magic.size()) == magic) {
+                pos += magic.size(); // New session: ids restart
+                formats.assign(1, Format{std::string(1, BinaryLog::STRING_ARG), "{}"});
+                prefix = std::string_view();
+                continue;
+            }
+            if (formats.empty()) {
+                error = "missing header at offset " + std::to_string(pos);
+                return false;
+            }
+            const size_t recordStart = pos;
+            char tag = bytes[pos++];
+            uint64_t id = 0;
+            bool ok = true;
+            if (tag == BinaryLog::FORMAT_RECORD) {
+                uint64_t line = 0;
+                std::string_view file, signature, text;
+                ok = IntermediateFormat::getVarint(bytes, pos, id) && IntermediateFormat::getVarint(bytes, pos, line) &&
+                     BinaryLog::getString(bytes, pos, file) && BinaryLog::getString(bytes, pos, signature) &&
+                     BinaryLog::getString(bytes, pos, text) && id > 0 && id < (1u << 24);
+                if (ok) {
+                    if (formats.size() <= id) formats.resize(static_cast<size_t>(id) + 1);
+                    formats[id] = Format{std::string(signature), std::string(text)};
+                }
+            } else if (tag == BinaryLog::PREFIX_RECORD) {
+                ok = BinaryLog::getString(bytes, pos, prefix);
+            } else if (tag == BinaryLog::MESSAGE_RECORD) {
+                uint64_t levelValue = 0, micros = 0;
+                std::string_view payload;
+                ok = IntermediateFormat::getVarint(bytes, pos, id) && IntermediateFormat::getVarint(bytes, pos, levelValue) &&
+                     IntermediateFormat::getVarint(bytes, pos, micros) && BinaryLog::getString(bytes, pos, payload) &&
+                     id < formats.size() && !formats[id].text.empty() && levelValue <= static_cast<uint64_t>(Level::WARNING);
+                if (ok) {
+                    std::time_t seconds = static_cast<std::time_t>(micros / 1000000);
+                    if (seconds != timestampSecond) {
+                        timestampSecond = seconds;
+                        timestamp = formatTime(seconds);
+                    }
+                    beginLine(out, timestamp, static_cast<Level>(levelValue), prefix);
+                    if (id == BinaryLog::PLAIN_FORMAT_ID) {
+                        out.append(payload.data(), payload.size());
+                    } else {
+                        ok = BinaryLog::render(formats[id].text, formats[id].signature, payload, out);
+                    }
+                    out += '\n';
+                }
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                error = "corrupt record at offset " + std::to_string(recordStart);
+                return false;
+            }
+        }
+        return true;
     }
 
 private:
-    Logger() {} 
+    struct Entry {
+        std::chrono::system_clock::time_point time;
+        Level level = Level::INFO;
+        uint32_t formatId = BinaryLog::PLAIN_FORMAT_ID;
+        std::string data; // Message text, or encoded arguments; assigned in place so a slot reuses its capacity
+    };
+
+    // Single-producer (the owning thread), single-consumer (the writer) ring.
+    struct Ring {
+        std::vector<Entry> slots = std::vector<Entry>(RING_CAPACITY);
+        alignas(64) std::atomic<size_t> head{0}; // Next slot the writer reads
+        alignas(64) std::atomic<size_t> tail{0}; // Next slot the owner fills
+        std::atomic<bool> orphaned{false};       // Owner thread exited; drop the ring once drained
+    };
+
+    struct RingHandle {
+        std::shared_ptr<Ring> ring;
+        ~RingHandle() {
+            if (ring) ring->orphaned.store(true, std::memory_order_release);
+        }
+    };
+
+    struct FormatInfo {
+        std::string file;
+        int line = 0;
+        std::string signature;
+        std::string text;
+    };
+
+    Logger() : formats_(1, FormatInfo{"", 0, std::string(1, BinaryLog::STRING_ARG), "{}"}) {}
     ~Logger() {
+        setAsync(false);
         if (logFile_.is_open()) {
             logFile_.close();
         }
+        closeBinaryFile();
+    }
+
+    void submit(uint32_t formatId, Level level, const std::string& data) {
+        if (async_.load(std::memory_order_acquire)) {
+            logAsync(formatId, level, data);
+            return;
+        }
+        logSync(formatId, level, data);
     }
 
-    std::string getLevelString(Level level) { // Keep private if only used by log()
+    void logSync(uint32_t formatId, Level level, const std::string& data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        appendRecord(std::chrono::system_clock::now(), level, formatId, data);
+        writeBuffered();
+    }
+
+    uint32_t registerFormat(CallSite& site, const char* format, std::string signature) {
+        std::lock_guard<std::mutex> lock(formatsMutex_);
+        uint32_t id = site.id.load(std::memory_order_relaxed);
+        if (id != 0) return id; // Another thread registered this site first
+        id = static_cast<uint32_t>(formats_.size());
+        formats_.push_back(FormatInfo{site.file, site.line, std::move(signature), format});
+        site.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    static int severity(Level level) {
+        switch (level) {
+            case Level::DEBUG: return 0;
+            case Level::INFO: return 1;
+            case Level::WARNING: return 2;
+            case Level::ERROR: return 3;
+            default: return 1;
+        }
+    }
+
+    static const char* getLevelString(Level level) { // Keep private if only used by log()
         switch (level) {
             case Level::INFO: return "INFO";
             case Level::DEBUG: return "DEBUG";
@@ -92,8 +321,287 @@ private:
         }
     }
 
+    static std::string formatTime(std::time_t seconds) {
+        std::tm timeinfo{}; // Value-initialize
+        #ifdef _WIN32
+            localtime_s(&timeinfo, &seconds);
+        #else
+            localtime_r(&seconds, &timeinfo); // POSIX version
+        #endif
+        char buffer[32];
+        size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+        return std::string(buffer, length);
+    }
+
+    // Appends "[timestamp] [LEVEL] prefix"; the message and '\n' follow.
+    static void beginLine(std::string& out, std::string_view timestamp, Level level, std::string_view prefix) {
+        out += '[';
+        out.append(timestamp.data(), timestamp.size());
+        out += "] [";
+        out += getLevelString(level);
+        out += "] ";
+        out.append(prefix.data(), prefix.size());
+    }
+
+    // Adds one record to the pending text and/or binary output. Caller holds mutex_.
+    void appendRecord(std::chrono::system_clock::time_point time, Level level, uint32_t formatId, const std::string& data) {
+        const bool binary = outputFormat_ == OutputFormat::BINARY;
+        if (binary) appendBinaryRecord(time, level, formatId, data);
+        if (binary && !consoleOutput_.load(std::memory_order_relaxed)) return;
+
+        std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+        if (seconds != cachedSecond_ || cachedTimestamp_.empty()) {
+            cachedSecond_ = seconds;
+            cachedTimestamp_ = formatTime(seconds);
+        }
+        beginLine(textBuffer_, cachedTimestamp_, level, logPrefix_);
+        if (formatId == BinaryLog::PLAIN_FORMAT_ID) {
+            textBuffer_ += data;
+        } else {
+            std::lock_guard<std::mutex> formatsLock(formatsMutex_);
+            const FormatInfo& format = formats_[formatId];
+            BinaryLog::render(format.text, format.signature, data, textBuffer_);
+        }
+        textBuffer_ += '\n';
+    }
+
+    // Caller holds mutex_.
+    void appendBinaryRecord(std::chrono::system_clock::time_point time, Level level, uint32_t formatId, const std::string& data) {
+        if (binaryWrittenFormats_.empty()) {
+            binaryBuffer_.append(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+            binaryWrittenFormats_.assign(1, true); // The plain format is implicit
+            binaryPrefix_.clear();
+        }
+        if (formatId >= binaryWrittenFormats_.size() || !binaryWrittenFormats_[formatId]) {
+            std::lock_guard<std::mutex> formatsLock(formatsMutex_);
+            const FormatInfo& format = formats_[formatId];
+            binaryBuffer_ += BinaryLog::FORMAT_RECORD;
+            IntermediateFormat::putVarint(binaryBuffer_, formatId);
+            IntermediateFormat::putVarint(binaryBuffer_, static_cast<uint64_t>(format.line));
+            BinaryLog::putString(binaryBuffer_, format.file);
+            BinaryLog::putString(binaryBuffer_, format.signature);
+            BinaryLog::putString(binaryBuffer_, format.text);
+            if (binaryWrittenFormats_.size() <= formatId) binaryWrittenFormats_.resize(formatId + 1, false);
+            binaryWrittenFormats_[formatId] = true;
+        }
+        if (binaryPrefix_ != logPrefix_) {
+            binaryPrefix_ = logPrefix_;
+            binaryBuffer_ += BinaryLog::PREFIX_RECORD;
+            BinaryLog::putString(binaryBuffer_, binaryPrefix_);
+        }
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+        binaryBuffer_ += BinaryLog::MESSAGE_RECORD;
+        IntermediateFormat::putVarint(binaryBuffer_, formatId);
+        IntermediateFormat::putVarint(binaryBuffer_, static_cast<uint64_t>(level));
+        IntermediateFormat::putVarint(binaryBuffer_, static_cast<uint64_t>(micros > 0 ? micros : 0));
+        BinaryLog::putString(binaryBuffer_, data);
+    }
+
+    // Writes and flushes the pending output. Caller holds mutex_.
+    void writeBuffered() {
+        if (!binaryBuffer_.empty()) {
+            if (!binaryFile_.is_open()) {
+                std::string path = (logFilePath_.empty() ? std::string("MapReduce.log") : logFilePath_) + BINARY_LOG_SUFFIX;
+                binaryFile_.open(path, std::ios::app | std::ios::binary);
+                if (!binaryFile_) std::cerr << "[LOGGER_ERROR] Could not open binary log file for writing: " << path << std::endl;
+            }
+            binaryFile_.write(binaryBuffer_.data(), static_cast<std::streamsize>(binaryBuffer_.size()));
+            binaryFile_.flush();
+            binaryBuffer_.clear();
+        }
+        if (textBuffer_.empty()) return;
+        if (outputFormat_ == OutputFormat::TEXT) {
+            if (logFile_.is_open()) {
+                logFile_.write(textBuffer_.data(), static_cast<std::streamsize>(textBuffer_.size()));
+                logFile_.flush();
+            } else {
+                std::cerr << "[LOG_TO_CERR] " << textBuffer_ << std::flush;
+            }
+        }
+        if (consoleOutput_.load(std::memory_order_relaxed)) {
+            std::cout.write(textBuffer_.data(), static_cast<std::streamsize>(textBuffer_.size()));
+            std::cout.flush();
+        }
+        textBuffer_.clear();
+    }
+
+    // Caller holds mutex_ (or is the destructor).
+    void closeBinaryFile() {
+        if (binaryFile_.is_open()) binaryFile_.close();
+        binaryWrittenFormats_.clear(); // The next file starts a new session
+    }
+
+    Ring& localRing() {
+        thread_local RingHandle handle;
+        if (!handle.ring) {
+            handle.ring = std::make_shared<Ring>();
+            std::lock_guard<std::mutex> lock(ringsMutex_); // Once per thread
+            rings_.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+    void logAsync(uint32_t formatId, Level level, const std::string& data) {
+        Ring& ring = localRing();
+        size_t tail = ring.tail.load(std::memory_order_relaxed);
+        while (tail - ring.head.load(std::memory_order_acquire) >= RING_CAPACITY) {
+            if (!async_.load(std::memory_order_acquire)) {
+                drainPending(); // The writer stopped while this ring was full; keep this thread's order
+                logSync(formatId, level, data);
+                return;
+            }
+            wakeWriter(); // Full: let the writer catch up rather than drop the message
+            std::this_thread::yield();
+        }
+        Entry& entry = ring.slots[tail % RING_CAPACITY];
+        entry.time = std::chrono::system_clock::now();
+        entry.level = level;
+        entry.formatId = formatId;
+        entry.data.assign(data);
+        ring.tail.store(tail + 1, std::memory_order_release);
+
+        // The writer may have stopped after this thread last saw async_ set
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!async_.load(std::memory_order_relaxed)) {
+            drainPending();
+            return;
+        }
+
+        // Errors are written promptly; otherwise only wake the writer once a ring is half full
+        if (level == Level::ERROR || tail + 1 - ring.head.load(std::memory_order_relaxed) == RING_CAPACITY / 2) {
+            wakeWriter();
+        }
+    }
+
+    void wakeWriter() {
+        {
+            std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+            wakeRequested_ = true;
+        }
+        wakeCondition_.notify_one();
+    }
+
+    // Writes every message pending when it starts, oldest first across threads.
+    // Returns false if there was nothing to write. Drains are serialized, so a
+    // ring has one consumer even when a producer drains after the writer stopped.
+    bool drainRings(std::vector<std::shared_ptr<Ring>>& snapshot, std::vector<std::pair<Ring*, size_t>>& tails,
+                    std::vector<const Entry*>& batch) {
+        std::lock_guard<std::mutex> drainLock(drainMutex_);
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            // Drop rings of exited threads that were fully drained on a previous pass
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+                return ring->orphaned.load(std::memory_order_acquire) &&
+                       ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+            }), rings_.end());
+            snapshot = rings_;
+        }
+        batch.clear();
+        tails.clear();
+        for (const auto& ring : snapshot) {
+            size_t head = ring->head.load(std::memory_order_relaxed);
+            size_t tail = ring->tail.load(std::memory_order_acquire);
+            if (head == tail) continue;
+            tails.emplace_back(ring.get(), tail);
+            for (size_t i = head; i != tail; ++i) batch.push_back(&ring->slots[i % RING_CAPACITY]);
+        }
+        if (batch.empty()) return false;
+        std::stable_sort(batch.begin(), batch.end(), [](const Entry* a, const Entry* b) { return a->time < b->time; });
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Entry* entry : batch) appendRecord(entry->time, entry->level, entry->formatId, entry->data);
+        for (const auto& ringTail : tails) ringTail.first->head.store(ringTail.second, std::memory_order_release);
+        writeBuffered();
+        return true;
+    }
+
+    // One drain pass outside the writer thread
+    void drainPending() {
+        std::vector<std::shared_ptr<Ring>> snapshot;
+        std::vector<std::pair<Ring*, size_t>> tails;
+        std::vector<const Entry*> batch;
+        drainRings(snapshot, tails, batch);
+    }
+
+    void writerLoop() {
+        std::vector<std::shared_ptr<Ring>> snapshot;
+        std::vector<std::pair<Ring*, size_t>> tails;
+        std::vector<const Entry*> batch;
+        std::unique_lock<std::mutex> wakeLock(wakeMutex_);
+        while (true) {
+            uint64_t flushTicket = flushRequested_;
+            bool stopping = stopWriter_;
+            wakeRequested_ = false;
+            wakeLock.unlock();
+            bool wrote = drainRings(snapshot, tails, batch);
+            snapshot.clear();
+            wakeLock.lock();
+            flushCompleted_ = flushTicket;
+            flushedCondition_.notify_all();
+            if (wrote) continue; // More may have arrived while writing
+            if (stopping) break;
+            wakeCondition_.wait_for(wakeLock, WRITER_INTERVAL, [this]() {
+                return stopWriter_ || wakeRequested_ || flushRequested_ > flushCompleted_;
+            });
+        }
+    }
+
     std::ofstream logFile_;
     std::string logFilePath_;
-    std::string logPrefix_;  
-    std::mutex mutex_;       
-};
\ No newline at end of file
+    std::string logPrefix_;
+    std::mutex mutex_; // Guards both files, the prefix, the output buffers and the timestamp cache
+    std::time_t cachedSecond_ = 0;
+    std::string cachedTimestamp_;
+    std::string textBuffer_;
+    OutputFormat outputFormat_ = OutputFormat::TEXT;
+
+    std::ofstream binaryFile_;
+    std::string binaryBuffer_;
+    std::vector<bool> binaryWrittenFormats_; // Format ids already defined in the current binary session
+    std::string binaryPrefix_;
+
+    std::mutex formatsMutex_;
+    std::vector<FormatInfo> formats_; // Indexed by format id; 0 is the plain log(message) format
+
+    std::atomic<int> minimumSeverity_{0};
+    std::atomic<bool> consoleOutput_{true};
+
+    std::atomic<bool> async_{false};
+    std::mutex asyncControlMutex_;
+    std::thread writerThread_;
+    std::mutex ringsMutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::mutex drainMutex_; // Held for a whole drainRings pass
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable flushedCondition_;
+    bool wakeRequested_ = false;
+    bool stopWriter_ = false;
+    uint64_t flushRequested_ = 0;
+    uint64_t flushCompleted_ = 0;
+};
+
+// Compile-time threshold of the LOG_* macros: 0 = DEBUG, 1 = INFO, 2 = WARNING,
+// 3 = ERROR. Calls below it compile to nothing, arguments included; build with
+// -DLOG_COMPILE_LEVEL=1 to strip DEBUG call sites.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+#define LOG_AT_(severityValue, levelValue, ...)                                                       \
+    do {                                                                                              \
+        if constexpr ((severityValue) >= LOG_COMPILE_LEVEL) {                                         \
+            Logger& logAtLogger_ = Logger::getInstance();                                             \
+            if (logAtLogger_.isEnabled(levelValue)) {                                                 \
+                static Logger::CallSite logAtSite_(levelValue, __FILE__, __LINE__);                   \
+                logAtLogger_.logFormat(logAtSite_, __VA_ARGS__);                                      \
+            }                                                                                         \
+        }                                                                                             \
+    } while (0)
+
+// LOG_INFO("Read {} entries from {}", count, path): each "{}" takes the next argument.
+#define LOG_DEBUG(...) LOG_AT_(0, Logger::Level::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT_(1, Logger::Level::INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT_(2, Logger::Level::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT_(3, Logger::Level::ERROR, __VA_ARGS__)
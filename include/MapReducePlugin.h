@@ -0,0 +1,192 @@
+#ifndef MAP_REDUCE_PLUGIN_H
+#define MAP_REDUCE_PLUGIN_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+    #include <dlfcn.h>
+    #include <unistd.h>
+#endif
+
+#include "PluginABI.h"
+
+// Output buffer a plugin emits into (see MrOutput). Keys are copied back to
+// back into one arena and records refer to them by offset, so a batch costs a
+// few vector appends rather than a string per record. clear() keeps the
+// capacity for the next batch.
+class PluginOutput {
+public:
+    PluginOutput() : output{this, &PluginOutput::emitRecord} {}
+    PluginOutput(const PluginOutput&) = delete;
+    PluginOutput& operator=(const PluginOutput&) = delete;
+
+    MrOutput* abi() { return &output; }
+
+    void clear() {
+        arena.clear();
+        records.clear();
+    }
+    size_t size() const { return records.size(); }
+    bool empty() const { return records.empty(); }
+    std::string_view key(size_t i) const { return std::string_view(arena.data() + records[i].keyOffset, records[i].keyLength); }
+    int64_t value(size_t i) const { return records[i].value; }
+
+    void add(std::string_view key, int64_t value) {
+        records.push_back(Record{arena.size(), static_cast<uint32_t>(key.size()), value});
+        arena.insert(arena.end(), key.begin(), key.end());
+    }
+
+private:
+    struct Record {
+        size_t keyOffset;
+        uint32_t keyLength;
+        int64_t value;
+    };
+
+    static int emitRecord(void* host, const char* key, uint32_t keyLength, int64_t value) {
+        if (host == nullptr || (key == nullptr && keyLength > 0)) return -1;
+        static_cast<PluginOutput*>(host)->add(std::string_view(key, keyLength), value);
+        return 0;
+    }
+
+    std::vector<char> arena;
+    std::vector<Record> records;
+    MrOutput output;
+};
+
+// A loaded plugin. load() dlopens a shared library and keeps it open for as
+// long as any task holds the returned pointer. Each build of a library is
+// loaded once per process: while the file is unchanged every task shares it,
+// and once the file is replaced the next load() picks up the new build while
+// running tasks finish on the old one, so user map functions can be swapped
+// without relinking or restarting MapReduce.
+class MapReducePlugin {
+public:
+    MapReducePlugin(const MapReducePlugin&) = delete;
+    MapReducePlugin& operator=(const MapReducePlugin&) = delete;
+
+    ~MapReducePlugin() {
+#ifndef _WIN32
+        if (handle != nullptr) dlclose(handle);
+#endif
+    }
+
+    static std::shared_ptr<const MapReducePlugin> load(const std::string& path, std::string& error) {
+        namespace fs = std::filesystem;
+#ifdef _WIN32
+        (void)path;
+        error = "plugins are only supported on POSIX systems";
+        return nullptr;
+#else
+        std::error_code ec;
+        fs::file_time_type modified = fs::last_write_time(path, ec);
+        if (ec) {
+            error = "cannot read plugin " + path + ": " + ec.message();
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        CacheEntry& cached = cache()[path];
+        if (std::shared_ptr<const MapReducePlugin> plugin = cached.plugin.lock()) {
+            if (cached.modified == modified) return plugin;
+        }
+
+        // dlopen hands back the image it already has for a path it has seen, so
+        // every build is opened through its own short-lived copy
+        static std::atomic<uint64_t> loads{0};
+        fs::path copy = fs::temp_directory_path(ec) /
+                        ("mr_plugin_" + std::to_string(getpid()) + "_" + std::to_string(loads.fetch_add(1)) + ".so");
+        if (ec || !fs::copy_file(path, copy, fs::copy_options::overwrite_existing, ec)) {
+            error = "cannot stage plugin " + path + ": " + ec.message();
+            return nullptr;
+        }
+        void* handle = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+        const char* dlError = handle == nullptr ? dlerror() : nullptr;
+        fs::remove(copy, ec); // The mapping outlives the file
+        if (handle == nullptr) {
+            error = "cannot load plugin " + path + ": " + (dlError != nullptr ? dlError : "unknown error");
+            return nullptr;
+        }
+        auto entry = reinterpret_cast<MrPluginEntry>(dlsym(handle, MR_PLUGIN_ENTRY_SYMBOL));
+        if (entry == nullptr) {
+            dlclose(handle);
+            error = "plugin " + path + " does not export " + MR_PLUGIN_ENTRY_SYMBOL;
+            return nullptr;
+        }
+        std::shared_ptr<MapReducePlugin> plugin = fromTable(entry(MR_PLUGIN_ABI_VERSION), error);
+        if (!plugin) {
+            dlclose(handle);
+            error = "plugin " + path + ": " + error;
+            return nullptr;
+        }
+        plugin->handle = handle;
+        plugin->libraryPath = path;
+        cached = CacheEntry{modified, plugin};
+        return plugin;
+#endif
+    }
+
+    // Wraps a table that is linked into the program rather than loaded.
+    static std::shared_ptr<MapReducePlugin> fromTable(const MrPlugin* table, std::string& error) {
+        if (table == nullptr) {
+            error = "no plugin table for ABI version " + std::to_string(MR_PLUGIN_ABI_VERSION);
+            return nullptr;
+        }
+        if (table->abi_version != MR_PLUGIN_ABI_VERSION) {
+            error = "built for plugin ABI version " + std::to_string(table->abi_version) + ", expected " +
+                    std::to_string(MR_PLUGIN_ABI_VERSION);
+            return nullptr;
+        }
+        if (table->map_batch == nullptr && table->reduce_batch == nullptr) {
+            error = "provides neither map_batch nor reduce_batch";
+            return nullptr;
+        }
+        return std::shared_ptr<MapReducePlugin>(new MapReducePlugin(*table));
+    }
+
+    const std::string& name() const { return pluginName; }
+    const std::string& path() const { return libraryPath; } // Empty unless loaded from a file
+    bool hasMap() const { return table.map_batch != nullptr; }
+    bool hasReduce() const { return table.reduce_batch != nullptr; }
+
+    // Appends what the plugin emits for `lines` to `out`.
+    bool mapBatch(std::string_view lines, PluginOutput& out) const {
+        return table.map_batch(lines.data(), lines.size(), out.abi()) == 0;
+    }
+
+    bool reduceBatch(const std::vector<MrRecord>& records, PluginOutput& out) const {
+        return table.reduce_batch(records.data(), records.size(), out.abi()) == 0;
+    }
+
+private:
+    struct CacheEntry {
+        std::filesystem::file_time_type modified;
+        std::weak_ptr<const MapReducePlugin> plugin;
+    };
+
+    explicit MapReducePlugin(const MrPlugin& pluginTable)
+        : table(pluginTable), pluginName(pluginTable.name != nullptr ? pluginTable.name : "unnamed") {}
+
+    static std::mutex& cacheMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+    static std::map<std::string, CacheEntry>& cache() {
+        static std::map<std::string, CacheEntry> entries; // By library path
+        return entries;
+    }
+
+    MrPlugin table;
+    std::string pluginName;
+    std::string libraryPath;
+    void* handle = nullptr;
+};
+
+#endif // MAP_REDUCE_PLUGIN_H
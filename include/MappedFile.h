@@ -0,0 +1,239 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include "ERROR_Handler.h"
+
+#ifdef _WIN32
+    #include <fstream>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Read-only, memory-mapped view of an input file. The mapping is advised as
+// sequential so the kernel reads ahead aggressively and can drop pages behind
+// the reader. Lines and blocks are handed out as string_views over the mapped
+// pages, so no per-line copies are made. Views are valid while the MappedFile
+// is open.
+// On Windows the file is read into a single owned buffer instead of mapped.
+class MappedFile {
+public:
+    // Iterates lines with std::getline semantics: '\n' is stripped, '\r' is kept,
+    // and a trailing newline does not produce an extra empty line.
+    class LineIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        LineIterator() : pos(std::string_view::npos) {}
+        explicit LineIterator(std::string_view text) : data(text), pos(0) { advance(); }
+
+        reference operator*() const { return current; }
+        pointer operator->() const { return &current; }
+        LineIterator& operator++() { advance(); return *this; }
+        LineIterator operator++(int) { LineIterator tmp = *this; advance(); return tmp; }
+        bool operator==(const LineIterator& other) const { return pos == other.pos; }
+        bool operator!=(const LineIterator& other) const { return pos != other.pos; }
+
+    private:
+        void advance() {
+            if (pos == std::string_view::npos || pos >= data.size()) {
+                pos = std::string_view::npos;
+                return;
+            }
+            size_t newline = data.find('\n', pos);
+            if (newline == std::string_view::npos) newline = data.size();
+            current = data.substr(pos, newline - pos);
+            pos = newline + 1;
+        }
+
+        std::string_view data;
+        std::string_view current;
+        size_t pos;
+    };
+
+    // Iterates consecutive blocks of roughly targetSize bytes. Each block ends
+    // just after a '\n' (or at end of file), so no word is split across blocks.
+    class BlockIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        BlockIterator() : targetSize(0), pos(std::string_view::npos) {}
+        BlockIterator(std::string_view text, size_t blockSize)
+            : data(text), targetSize(blockSize > 0 ? blockSize : 1), pos(0) { advance(); }
+
+        reference operator*() const { return current; }
+        pointer operator->() const { return &current; }
+        BlockIterator& operator++() { advance(); return *this; }
+        bool operator==(const BlockIterator& other) const { return pos == other.pos; }
+        bool operator!=(const BlockIterator& other) const { return pos != other.pos; }
+
+    private:
+        void advance() {
+            if (pos == std::string_view::npos || pos >= data.size()) {
+                pos = std::string_view::npos;
+                return;
+            }
+            size_t end = data.size();
+            if (data.size() - pos > targetSize) {
+                size_t newline = data.find('\n', pos + targetSize - 1);
+                end = (newline == std::string_view::npos) ? data.size() : newline + 1;
+            }
+            current = data.substr(pos, end - pos);
+            pos = end;
+        }
+
+        std::string_view data;
+        std::string_view current;
+        size_t targetSize;
+        size_t pos;
+    };
+
+    template <typename Iterator>
+    struct Range {
+        Iterator first;
+        Iterator last;
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+    };
+
+    static constexpr size_t WHOLE_FILE = static_cast<size_t>(-1);
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            std::swap(data, other.data);
+            std::swap(length, other.length);
+#ifndef _WIN32
+            std::swap(mappingBase, other.mappingBase);
+            std::swap(mappingLength, other.mappingLength);
+#else
+            std::swap(buffer, other.buffer);
+            data = buffer.data(); // A small-string buffer does not move with swap
+            other.data = other.buffer.data();
+#endif
+        }
+        return *this;
+    }
+
+    // Maps the whole file.
+    bool open(const std::string& filename) {
+        return open(filename, 0, WHOLE_FILE);
+    }
+
+    // Maps `rangeLength` bytes starting at `rangeOffset` (clamped to the file
+    // size). The mapping itself starts on a page boundary; view() starts exactly
+    // at rangeOffset.
+    bool open(const std::string& filename, size_t rangeOffset, size_t rangeLength) {
+        close();
+#ifdef _WIN32
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) {
+            ErrorHandler::reportError("Could not open file " + filename + " for reading.");
+            return false;
+        }
+        file.seekg(0, std::ios::end);
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        if (rangeOffset >= fileSize) return true;
+        size_t count = std::min(rangeLength, fileSize - rangeOffset);
+        buffer.resize(count);
+        file.seekg(static_cast<std::streamoff>(rangeOffset));
+        file.read(&buffer[0], static_cast<std::streamsize>(count));
+        data = buffer.data();
+        length = buffer.size();
+        return true;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            ErrorHandler::reportError("Could not open file " + filename + " for reading.");
+            return false;
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            ErrorHandler::reportError("Could not stat file " + filename + ": " + std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+        size_t fileSize = static_cast<size_t>(st.st_size);
+        if (rangeOffset >= fileSize) { // mmap rejects zero-length mappings; an empty view is fine
+            ::close(fd);
+            return true;
+        }
+        size_t count = std::min(rangeLength, fileSize - rangeOffset);
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t pageOffset = rangeOffset - rangeOffset % pageSize;
+
+        void* mapping = mmap(nullptr, count + (rangeOffset - pageOffset), PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(pageOffset));
+        int mapError = errno;
+        ::close(fd); // The mapping keeps its own reference to the file
+        if (mapping == MAP_FAILED) {
+            ErrorHandler::reportError("Could not memory-map file " + filename + ": " + std::strerror(mapError));
+            return false;
+        }
+        mappingBase = mapping;
+        mappingLength = count + (rangeOffset - pageOffset);
+        madvise(mappingBase, mappingLength, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapping) + (rangeOffset - pageOffset);
+        length = count;
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        buffer.clear();
+        buffer.shrink_to_fit();
+#else
+        if (mappingBase != nullptr) {
+            munmap(mappingBase, mappingLength);
+        }
+        mappingBase = nullptr;
+        mappingLength = 0;
+#endif
+        data = nullptr;
+        length = 0;
+    }
+
+    bool empty() const { return length == 0; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(data, length); }
+
+    Range<LineIterator> lines() const { return {LineIterator(view()), LineIterator()}; }
+    Range<BlockIterator> blocks(size_t targetSize) const { return {BlockIterator(view(), targetSize), BlockIterator()}; }
+
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::string buffer;
+#else
+    void* mappingBase = nullptr;
+    size_t mappingLength = 0;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -2,32 +2,156 @@
 #define MAPPER_DLL_SO_H
 
 #include "ExportDefinitions.h"
+#include "Tokenizer.h"
+#include "Combiner.h"
+#include "KeyValueBuffer.h"
+#include "InputSplit.h"
+#include "IntermediateFormat.h"
+#include "RangePartitioner.h"
+#include "MapReducePlugin.h"
+#include "TaskCounters.h"
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <utility>
 
 class Logger;
 class ErrorHandler;
 
 class DLL_so_EXPORT Mapper {
 public:
+    static constexpr size_t MAP_BLOCK_SIZE = 1024 * 1024;
+    static constexpr size_t DEFAULT_SPILL_BUDGET_BYTES = 256 * 1024 * 1024;
+
     Mapper(Logger& logger, ErrorHandler& errorHandler);
     ~Mapper();
 
-    void map(const std::string& documentId, const std::string& line, std::vector<std::pair<std::string, int>>& intermediateData);
+    // Compatibility wrapper: maps a single line through mapBuffer.
+    void map(const std::string& documentId, const std::string& line, KeyValueBuffer& intermediateData);
+
+    // Maps an arbitrary byte buffer (a line, a block or a whole file) using the
+    // table-driven Tokenizer. Newlines are treated as word separators. When the
+    // CPU has a vector TextNormalizer kernel, larger buffers are case-folded and
+    // stripped of punctuation in one SIMD pass before tokenizing. Keys are
+    // interned in intermediateData (KeyValueBuffer::internKeys) under the
+    // partition seed, so each distinct word is stored and hashed once.
+    void mapBuffer(const std::string& documentId, std::string_view buffer, KeyValueBuffer& intermediateData);
+
+    // Memory-maps filePath and maps it block by block (MAP_BLOCK_SIZE bytes, cut at
+    // line boundaries), so the file is never copied into per-line strings.
+    bool mapFile(const std::string& filePath, KeyValueBuffer& intermediateData);
+
+    // Same as mapFile but only maps the split's byte range of the file.
+    bool mapSplit(const InputSplit& split, KeyValueBuffer& intermediateData);
+
+    // Routes emitted words through an in-mapper Combiner bounded by memoryBudgetBytes.
+    // Callers must call flushCombiner() before exporting the intermediate data.
+    void enableCombiner(size_t memoryBudgetBytes = Combiner::DEFAULT_MEMORY_BUDGET_BYTES);
+    bool isCombinerEnabled() const { return combinerEnabled; }
+
+    // Moves any aggregates still held by the combiner into intermediateData and
+    // logs the record reduction. No-op when the combiner is disabled.
+    void flushCombiner(KeyValueBuffer& intermediateData);
+    const Combiner::Stats& getCombinerStats() const { return combiner.getStats(); }
+
+    // Bounds the intermediate data a mapper buffers. Once mapSplit has buffered
+    // more than memoryBudgetBytes (KeyValueBuffer::memoryUsed()), it exports the
+    // buffer to the spill target as one sorted run per partition and clears it,
+    // keeping its arena for the next records. Callers still export whatever
+    // remains at the end. A budget of 0, or no spill target, disables spilling.
+    void setSpillBudget(size_t memoryBudgetBytes) { spillMemoryBudget = memoryBudgetBytes; }
+    void setSpillTarget(const std::string& tempDir, int numReducers,
+                        const std::string& partitionFilePrefix, const std::string& partitionFileSuffix);
+    size_t getSpillCount() const { return spillCount; }
+
+    // Selects how exportPartitionedData encodes partition files. BINARY (the
+    // default) appends one checksummed, key-sorted IntermediateFormat segment per reducer;
+    // TEXT writes the original "word\tcount" lines.
+    void setIntermediateEncoding(IntermediateEncoding encoding) { intermediateEncoding = encoding; }
+    IntermediateEncoding getIntermediateEncoding() const { return intermediateEncoding; }
+
+    // One reducer's segment inside an indexed spill file.
+    struct SpillExtent {
+        int reducerId;
+        uint64_t offset;
+        uint64_t bytes;
+    };
+
+    // Sends every export, spills included, to the single file filePath instead
+    // of one file per reducer. Each export appends the non-empty reducers'
+    // sorted segments back to back through one descriptor and records where
+    // they landed in getSpillIndex(); the prefix and suffix passed to
+    // exportPartitionedData are then unused. Requires BINARY encoding. An empty
+    // path restores per-reducer files.
+    void setIndexedSpillFile(const std::string& filePath) {
+        indexedSpillPath = filePath;
+        spillIndex.clear();
+    }
+    const std::vector<SpillExtent>& getSpillIndex() const { return spillIndex; }
+
+    // Seed of the stable partition hash. Every mapper of a job must use the same
+    // seed. Set it before mapping so interned keys carry the partition hash.
+    void setPartitionSeed(uint64_t seed) { partitionSeed = seed; }
+
+    // Partition by sampled key ranges instead of by hash. Every mapper of a job
+    // must use the same boundaries. An empty RangePartitioner restores hashing.
+    void setRangePartitioner(const RangePartitioner& ranges) { rangePartitioner = ranges; }
+
+    // Reports mapped bytes and emitted words to `counters` (block by block) while
+    // mapSplit runs. Null stops reporting.
+    void setProgressCounters(TaskCounters* counters) { progress = counters; }
+
+    // Hands every buffer mapBuffer gets (whole lines) to the plugin's map_batch
+    // instead of the built-in tokenizer; its records then go through the
+    // combiner and partitioning as usual. Null, or a plugin without map_batch,
+    // restores the tokenizer. hasPluginError() reports a batch the plugin
+    // rejected; mapSplit also returns false for it.
+    void setPlugin(std::shared_ptr<const MapReducePlugin> mapPlugin) { plugin = std::move(mapPlugin); }
+    bool hasPluginError() const { return pluginError; }
 
     // Updated to accept partition file prefix and suffix
     bool exportPartitionedData(const std::string& tempDir, 
-                               const std::vector<std::pair<std::string, int>>& mappedData, 
+                               const KeyValueBuffer& mappedData, 
                                int numReducers,
                                const std::string& partitionFilePrefix,
                                const std::string& partitionFileSuffix);
 
-    bool exportMappedData(const std::string& filePath, const std::vector<std::pair<std::string, int>>& mappedData);
+    bool exportMappedData(const std::string& filePath, const KeyValueBuffer& mappedData);
 
 private:
+    void mapWithPlugin(std::string_view buffer, KeyValueBuffer& intermediateData);
+    void spillIfOverBudget(KeyValueBuffer& intermediateData);
+
+    bool exportBinaryPartitions(const std::string& tempDir,
+                                const KeyValueBuffer& mappedData,
+                                const std::vector<uint32_t>& recordBuckets,
+                                int numReducers,
+                                const std::string& partitionFilePrefix,
+                                const std::string& partitionFileSuffix);
+
     Logger& logger;
     ErrorHandler& errorHandler;
+    Tokenizer tokenizer; // Reused across calls so its scratch buffer is allocated once
+    std::string normalized; // Output buffer for TextNormalizer, reused across calls
+    Combiner combiner;
+    bool combinerEnabled = false;
+    IntermediateEncoding intermediateEncoding = IntermediateEncoding::BINARY;
+    uint64_t partitionSeed = 0;
+    RangePartitioner rangePartitioner; // Used instead of the hash when not empty
+
+    size_t spillMemoryBudget = DEFAULT_SPILL_BUDGET_BYTES;
+    std::string spillTempDir;
+    int spillNumReducers = 0;
+    std::string spillPrefix;
+    std::string spillSuffix;
+    size_t spillCount = 0;
+    std::string indexedSpillPath; // Empty: one file per reducer
+    std::vector<SpillExtent> spillIndex;
+    TaskCounters* progress = nullptr;
+    std::shared_ptr<const MapReducePlugin> plugin;
+    PluginOutput pluginOutput; // Reused across batches
+    bool pluginError = false;
 };
 
 #endif // MAPPER_DLL_SO_H
\ No newline at end of file
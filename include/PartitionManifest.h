@@ -0,0 +1,299 @@
+#ifndef PARTITION_MANIFEST_H
+#define PARTITION_MANIFEST_H
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Commit protocol for mapper output. Each mapper writes only its own files,
+// partition_m<mapper>_r<reducer>.txt, first under a ".tmp" staging name, so no
+// two mappers ever share a file. When the mapper is done, commit() renames the
+// staging files into place and then atomically writes
+// <tempDir>/manifests/mapper_<mapper>.manifest listing them. Reducers find
+// their inputs only through manifests, so they never see a partial or torn
+// file. A retried mapper simply overwrites its own files and manifest.
+//
+// Attempts: a speculative backup (or a reassigned task) runs the same mapper
+// again while the first copy may still be writing. Attempt k > 0 of mapper m
+// therefore stages and commits partition_m<m>a<k>_r<r>.txt, never touching
+// another attempt's files, and the first attempt to publish a manifest wins:
+// a later attempt finds it, deletes its own files and adopts the winner's
+// manifest. Only re-running attempt 0 over an attempt-0 manifest replaces it.
+//
+// With the indexed layout a mapper writes a single spill file,
+// partition_m<mapper>.spill, instead; the manifest is then its offset index,
+// with one entry per segment, so a reducer may have several entries (one per
+// spill) in the same file.
+//
+// Manifest layout (text):
+//   mapper <mapperId> reducers <numReducers> [attempt <attempt>]
+//   <reducerId>\t<file name relative to tempDir>\t<bytes>\t<offset>     (one per segment or file)
+class PartitionManifest {
+public:
+    static constexpr const char* MANIFEST_DIR = "manifests";
+    static constexpr const char* MANIFEST_SUFFIX = ".manifest";
+    static constexpr const char* PARTITION_SUFFIX = ".txt";
+    static constexpr const char* STAGING_SUFFIX = ".tmp";
+    static constexpr const char* SPILL_SUFFIX = ".spill";
+
+    // `bytes` bytes of fileName starting at `offset`; per-reducer files are
+    // listed whole, with offset 0.
+    struct Entry {
+        int reducerId = 0;
+        std::string fileName;
+        uint64_t bytes = 0;
+        uint64_t offset = 0;
+
+        bool inSpillFile() const {
+            const size_t suffixLength = std::char_traits<char>::length(SPILL_SUFFIX);
+            return fileName.size() >= suffixLength && fileName.compare(fileName.size() - suffixLength, suffixLength, SPILL_SUFFIX) == 0;
+        }
+    };
+
+    PartitionManifest() = default;
+    PartitionManifest(int mapperId, int numReducers) : mapperId(mapperId), numReducers(numReducers) {}
+
+    int getMapperId() const { return mapperId; }
+    int getNumReducers() const { return numReducers; }
+    uint32_t getAttempt() const { return attempt; }
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+    // Entries of `reducerId` in the order the mapper wrote them.
+    std::vector<Entry> entriesFor(int reducerId) const {
+        std::vector<Entry> found;
+        for (const Entry& entry : entries) {
+            if (entry.reducerId == reducerId) found.push_back(entry);
+        }
+        return found;
+    }
+
+    // File names are partitionPrefix(m, attempt) + r + PARTITION_SUFFIX; mappers
+    // write them with the staging suffix appended until commit().
+    static std::string partitionPrefix(int mapperId, uint32_t attempt = 0) { return mapperStem(mapperId, attempt) + "_r"; }
+    static std::string stagingSuffix() { return std::string(PARTITION_SUFFIX) + STAGING_SUFFIX; }
+    static std::string partitionFileName(int mapperId, int reducerId, uint32_t attempt = 0) {
+        return partitionPrefix(mapperId, attempt) + std::to_string(reducerId) + PARTITION_SUFFIX;
+    }
+    static std::string spillFileName(int mapperId, uint32_t attempt = 0) { return mapperStem(mapperId, attempt) + SPILL_SUFFIX; }
+
+    static std::string path(const std::string& tempDir, int mapperId) {
+        return (std::filesystem::path(tempDir) / MANIFEST_DIR / ("mapper_" + std::to_string(mapperId) + MANIFEST_SUFFIX)).string();
+    }
+
+    static bool isCommitted(const std::string& tempDir, int mapperId) {
+        std::error_code ec;
+        return std::filesystem::exists(path(tempDir, mapperId), ec);
+    }
+
+    // Drops staging files left by an earlier attempt of this mapper, so its
+    // spills do not append to them.
+    static void clearStaging(const std::string& tempDir, int mapperId, int numReducers, uint32_t attempt = 0) {
+        std::error_code ec;
+        for (int r = 0; r < numReducers; ++r) {
+            std::filesystem::remove(std::filesystem::path(tempDir) / (partitionFileName(mapperId, r, attempt) + STAGING_SUFFIX), ec);
+        }
+        std::filesystem::remove(std::filesystem::path(tempDir) / (spillFileName(mapperId, attempt) + STAGING_SUFFIX), ec);
+    }
+
+    // Removes every manifest and per-mapper partition file, so a new job never
+    // picks up the output of an earlier one.
+    static void clearJob(const std::string& tempDir) {
+        std::error_code ec;
+        std::filesystem::remove_all(std::filesystem::path(tempDir) / MANIFEST_DIR, ec);
+        for (std::filesystem::directory_iterator it(tempDir, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->path().filename().string().rfind("partition_m", 0) == 0) {
+                std::error_code removeError;
+                std::filesystem::remove(it->path(), removeError);
+            }
+        }
+    }
+
+    // Publishes mapper `mapperId`'s staged partitions. Missing staging files
+    // (no records for that reducer) are left out of the manifest. If another
+    // attempt published first, `manifest` is that attempt's (see getAttempt()).
+    static bool commit(const std::string& tempDir, int mapperId, int numReducers, PartitionManifest& manifest, std::string& error,
+                       uint32_t attempt = 0) {
+        namespace fs = std::filesystem;
+        manifest = PartitionManifest(mapperId, numReducers);
+        manifest.attempt = attempt;
+        std::error_code ec;
+        for (int r = 0; r < numReducers; ++r) {
+            std::string fileName = partitionFileName(mapperId, r, attempt);
+            fs::path finalPath = fs::path(tempDir) / fileName;
+            fs::path stagingPath = fs::path(tempDir) / (fileName + STAGING_SUFFIX);
+            if (!fs::exists(stagingPath, ec)) continue;
+            uint64_t bytes = static_cast<uint64_t>(fs::file_size(stagingPath, ec));
+            if (!ec) fs::rename(stagingPath, finalPath, ec);
+            if (ec) {
+                error = "could not commit " + stagingPath.string() + ": " + ec.message();
+                return false;
+            }
+            manifest.entries.push_back(Entry{r, fileName, bytes, 0});
+        }
+        return publish(tempDir, manifest, error);
+    }
+
+    // Publishes mapper `mapperId`'s staged indexed spill file. `segments` are
+    // the offsets and lengths the mapper recorded; their fileName is ignored.
+    static bool commitIndexed(const std::string& tempDir, int mapperId, int numReducers, const std::vector<Entry>& segments,
+                              PartitionManifest& manifest, std::string& error, uint32_t attempt = 0) {
+        namespace fs = std::filesystem;
+        manifest = PartitionManifest(mapperId, numReducers);
+        manifest.attempt = attempt;
+        std::string fileName = spillFileName(mapperId, attempt);
+        fs::path stagingPath = fs::path(tempDir) / (fileName + STAGING_SUFFIX);
+        std::error_code ec;
+        if (fs::exists(stagingPath, ec)) {
+            fs::rename(stagingPath, fs::path(tempDir) / fileName, ec);
+            if (ec) {
+                error = "could not commit " + stagingPath.string() + ": " + ec.message();
+                return false;
+            }
+        } else if (!segments.empty()) {
+            error = "missing spill file " + stagingPath.string();
+            return false;
+        }
+        for (Entry segment : segments) {
+            segment.fileName = fileName;
+            manifest.entries.push_back(std::move(segment));
+        }
+        return publish(tempDir, manifest, error);
+    }
+
+    static bool load(const std::string& manifestPath, PartitionManifest& manifest, std::string& error) {
+        std::ifstream in(manifestPath);
+        if (!in.is_open()) {
+            error = "could not open " + manifestPath;
+            return false;
+        }
+        std::string line;
+        std::string mapperWord, reducersWord, attemptWord;
+        PartitionManifest loaded;
+        if (!std::getline(in, line)) {
+            error = "invalid header in " + manifestPath;
+            return false;
+        }
+        std::istringstream header(line);
+        if (!(header >> mapperWord >> loaded.mapperId >> reducersWord >> loaded.numReducers) || mapperWord != "mapper" ||
+            reducersWord != "reducers" || ((header >> attemptWord) && (attemptWord != "attempt" || !(header >> loaded.attempt)))) {
+            error = "invalid header in " + manifestPath;
+            return false;
+        }
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            size_t firstTab = line.find('\t');
+            size_t secondTab = firstTab == std::string::npos ? std::string::npos : line.find('\t', firstTab + 1);
+            size_t thirdTab = secondTab == std::string::npos ? std::string::npos : line.find('\t', secondTab + 1);
+            if (thirdTab == std::string::npos) {
+                error = "invalid entry in " + manifestPath + ": " + line;
+                return false;
+            }
+            Entry entry;
+            try {
+                entry.reducerId = std::stoi(line.substr(0, firstTab));
+                entry.bytes = std::stoull(line.substr(secondTab + 1, thirdTab - secondTab - 1));
+                entry.offset = std::stoull(line.substr(thirdTab + 1));
+            } catch (const std::exception&) {
+                error = "invalid entry in " + manifestPath + ": " + line;
+                return false;
+            }
+            entry.fileName = line.substr(firstTab + 1, secondTab - firstTab - 1);
+            loaded.entries.push_back(std::move(entry));
+        }
+        manifest = std::move(loaded);
+        return true;
+    }
+
+    // Segments of `reducerId` from every committed mapper, in mapper order, with
+    // fileName resolved against tempDir.
+    static bool collectReducerInputs(const std::string& tempDir, int reducerId, std::vector<Entry>& inputs, std::string& error) {
+        namespace fs = std::filesystem;
+        std::vector<PartitionManifest> manifests;
+        std::error_code ec;
+        fs::path manifestDir = fs::path(tempDir) / MANIFEST_DIR;
+        if (!fs::exists(manifestDir, ec)) return true; // No mapper has committed
+        for (fs::directory_iterator it(manifestDir, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->path().extension() != MANIFEST_SUFFIX) continue; // Skips manifests being written
+            PartitionManifest manifest;
+            if (!load(it->path().string(), manifest, error)) return false;
+            manifests.push_back(std::move(manifest));
+        }
+        if (ec) {
+            error = "could not list " + manifestDir.string() + ": " + ec.message();
+            return false;
+        }
+        std::sort(manifests.begin(), manifests.end(),
+                  [](const PartitionManifest& a, const PartitionManifest& b) { return a.mapperId < b.mapperId; });
+        for (const PartitionManifest& manifest : manifests) {
+            for (Entry entry : manifest.entriesFor(reducerId)) {
+                entry.fileName = (fs::path(tempDir) / entry.fileName).string();
+                inputs.push_back(std::move(entry));
+            }
+        }
+        return true;
+    }
+
+private:
+    static std::string mapperStem(int mapperId, uint32_t attempt) {
+        return "partition_m" + std::to_string(mapperId) + (attempt > 0 ? "a" + std::to_string(attempt) : "");
+    }
+
+    // The manifest is the commit point: write it aside, then link it in. The
+    // link fails if another attempt already published; that attempt wins.
+    static bool publish(const std::string& tempDir, PartitionManifest& manifest, std::string& error) {
+        namespace fs = std::filesystem;
+        std::string manifestPath = path(tempDir, manifest.mapperId);
+        std::string pendingPath = manifestPath + (manifest.attempt > 0 ? ".a" + std::to_string(manifest.attempt) : "") + STAGING_SUFFIX;
+        std::error_code ec;
+        fs::create_directories(fs::path(manifestPath).parent_path(), ec);
+        std::ofstream out(pendingPath, std::ios::trunc);
+        out << "mapper " << manifest.mapperId << " reducers " << manifest.numReducers;
+        if (manifest.attempt > 0) out << " attempt " << manifest.attempt;
+        out << "\n";
+        for (const Entry& entry : manifest.entries) {
+            out << entry.reducerId << "\t" << entry.fileName << "\t" << entry.bytes << "\t" << entry.offset << "\n";
+        }
+        out.close();
+        if (out.fail()) {
+            error = "could not write " + pendingPath;
+            return false;
+        }
+        fs::create_hard_link(pendingPath, manifestPath, ec);
+        if (!ec) {
+            fs::remove(pendingPath, ec);
+            return true;
+        }
+        if (ec != std::errc::file_exists) {
+            error = "could not commit " + manifestPath + ": " + ec.message();
+            return false;
+        }
+
+        PartitionManifest published;
+        if (!load(manifestPath, published, error)) return false;
+        if (manifest.attempt == 0 && published.attempt == 0) {
+            fs::rename(pendingPath, manifestPath, ec); // A re-run of the mapper replaces its own output
+            if (ec) {
+                error = "could not commit " + manifestPath + ": " + ec.message();
+                return false;
+            }
+            return true;
+        }
+        // Another attempt committed first: keep its output, drop ours
+        fs::remove(pendingPath, ec);
+        for (const Entry& entry : manifest.entries) fs::remove(fs::path(tempDir) / entry.fileName, ec);
+        manifest = std::move(published);
+        return true;
+    }
+
+    int mapperId = -1;
+    int numReducers = 0;
+    uint32_t attempt = 0;
+    std::vector<Entry> entries;
+};
+
+#endif // PARTITION_MANIFEST_H
@@ -1,22 +1,66 @@
 #ifndef PARTITIONER_H
 #define PARTITIONER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <functional>
+#include <string_view>
+#include <vector>
+#include "KeyValueBuffer.h"
+#include "StableHash.h"
 
 class Partitioner {
 public:
+    // Any function of (bytes, length, seed) that is stable across builds and
+    // well mixed in its high 32 bits can be plugged in.
+    using HashFunction = uint64_t (*)(const void* data, size_t length, uint64_t seed);
+
+    static constexpr uint64_t DEFAULT_SEED = 0;
+
     // Constructor to initialize with the number of reducers
-    explicit Partitioner(int numReducers) : numReducers(numReducers) {}
+    explicit Partitioner(int numReducers, uint64_t seed = DEFAULT_SEED, HashFunction hashFunction = &defaultHash)
+        : numReducers(numReducers), seed(seed), hashFn(hashFunction) {}
 
     // Function to determine the reducer bucket for a given key
-    int getReducerBucket(const std::string& key) const {
-        std::hash<std::string> hashFn;
-        return hashFn(key) % numReducers;
+    int getReducerBucket(std::string_view key) const {
+        return static_cast<int>(StableHash::fastRange(hashFn(key.data(), key.size(), seed), static_cast<uint32_t>(numReducers)));
     }
 
+    // Buckets for many keys in one call: buckets[i] is the reducer of records[i].key().
+    // Interned keys hashed with this partitioner's seed and hash are not hashed
+    // again: their dictionary's cached hash is used.
+    void getReducerBuckets(const KeyValueBuffer& records, std::vector<uint32_t>& buckets) const {
+        buckets.resize(records.size());
+        const KeyDictionary* keys = records.keyDictionary();
+        if (keys != nullptr && keys->seed() == seed && hashFn == &defaultHash) {
+            const uint32_t range = static_cast<uint32_t>(numReducers);
+            for (size_t i = 0; i < records.size(); ++i) {
+                buckets[i] = StableHash::fastRange(keys->hash(records.keyId(i)), range);
+            }
+            return;
+        }
+        getReducerBuckets(records.data(), records.size(), buckets.data());
+    }
+
+    void getReducerBuckets(const KeyValueBuffer::Record* records, size_t count, uint32_t* buckets) const {
+        const uint32_t range = static_cast<uint32_t>(numReducers);
+        const HashFunction fn = hashFn;
+        for (size_t i = 0; i < count; ++i) {
+            buckets[i] = StableHash::fastRange(fn(records[i].keyData, records[i].keyLength, seed), range);
+        }
+    }
+
+    int getNumReducers() const { return numReducers; }
+    uint64_t getSeed() const { return seed; }
+
 private:
+    static uint64_t defaultHash(const void* data, size_t length, uint64_t hashSeed) {
+        return StableHash::hash(data, length, hashSeed);
+    }
+
     int numReducers; // Number of reducers
+    uint64_t seed;
+    HashFunction hashFn;
 };
 
-#endif // PARTITIONER_H
\ No newline at end of file
+#endif // PARTITIONER_H
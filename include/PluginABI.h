@@ -0,0 +1,70 @@
+#ifndef PLUGIN_ABI_H
+#define PLUGIN_ABI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// C ABI between MapReduce and a user map/reduce plugin: a shared library that
+// exports MR_PLUGIN_ENTRY_SYMBOL and is loaded at run time (plugin_library in
+// config.txt, see MapReducePlugin.h), so the MapReduce binary never links
+// against it. Plain C types only, so a plugin may be built by any compiler.
+//
+// Entry points take whole batches instead of one line or one key per call:
+// map_batch gets a buffer of complete lines, reduce_batch a span of records.
+// Both emit through the host's MrOutput, which copies each record into an
+// arena owned by the host. Entry points may run concurrently for different
+// tasks and must not keep pointers into their arguments after returning.
+//
+// Versioning: the host calls the entry with the ABI version it speaks and the
+// plugin returns a table built against that version, or NULL if it cannot.
+// The host rejects a table whose abi_version differs from its own.
+
+#define MR_PLUGIN_ABI_VERSION 1u
+#define MR_PLUGIN_ENTRY_SYMBOL "mr_plugin_entry"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #define MR_PLUGIN_EXPORT __declspec(dllexport)
+#else
+    #define MR_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MrRecord {
+    const char* key; // Not NUL-terminated
+    uint32_t key_length;
+    int64_t value;
+} MrRecord;
+
+// emit returns 0 once the record is copied, non-zero if the host refused it;
+// the plugin should then stop and return that value.
+typedef struct MrOutput {
+    void* host;
+    int (*emit)(void* host, const char* key, uint32_t key_length, int64_t value);
+} MrOutput;
+
+typedef struct MrPlugin {
+    uint32_t abi_version; // MR_PLUGIN_ABI_VERSION the plugin was built with
+    const char* name;
+
+    // Maps `size` bytes of whole '\n'-terminated lines (the last line may lack
+    // its '\n') and emits {key, count} records. Returns 0 on success. NULL
+    // keeps the built-in word tokenizer.
+    int (*map_batch)(const char* data, size_t size, MrOutput* out);
+
+    // Gets records in ascending byte order of key, each key once with its
+    // counts summed over every mapper, and emits the reducer's output records.
+    // Emitted keys must stay in ascending order across batches (e.g. a subset
+    // of the input keys). Returns 0 on success. NULL writes the sums as-is.
+    int (*reduce_batch)(const MrRecord* records, size_t count, MrOutput* out);
+} MrPlugin;
+
+typedef const MrPlugin* (*MrPluginEntry)(uint32_t host_abi_version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLUGIN_ABI_H
@@ -0,0 +1,195 @@
+#ifndef PROCESS_LAUNCHER_H
+#define PROCESS_LAUNCHER_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+    #include <signal.h>
+    #include <spawn.h>
+    #include <sys/resource.h>
+    #include <sys/time.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    extern char** environ;
+#endif
+
+// Where the controller runs mappers and reducers.
+enum class ExecutionMode {
+    THREADS,  // Threads of the controller process
+    PROCESSES // Child `MapReduce mapper`/`reducer` processes
+};
+
+// Per-process limits a worker applies to itself at startup. 0 means unlimited.
+struct WorkerLimits {
+    uint64_t cpuSeconds = 0;  // RLIMIT_CPU: SIGXCPU at the limit, SIGKILL one second later
+    uint64_t memoryBytes = 0; // RLIMIT_AS: allocations beyond it fail
+};
+
+// Starts and reaps worker processes with posix_spawn/wait4. POSIX only;
+// supported() is false on Windows, where the controller keeps using threads.
+class ProcessLauncher {
+public:
+#ifdef _WIN32
+    using ProcessId = int;
+#else
+    using ProcessId = pid_t;
+#endif
+
+    struct ExitStatus {
+        ProcessId pid = -1;
+        int exitCode = -1;   // Valid unless the process was killed by a signal
+        int signal = 0;      // Terminating signal, or 0
+        double cpuSeconds = 0;
+        long maxResidentKb = 0;
+
+        bool succeeded() const { return signal == 0 && exitCode == 0; }
+    };
+
+    static bool supported() {
+#ifdef _WIN32
+        return false;
+#else
+        return true;
+#endif
+    }
+
+    // Absolute path of the running executable, so children run the same build.
+    static std::string currentExecutable(const std::string& fallback) {
+#if defined(__linux__)
+        char path[4096];
+        ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if (length > 0) return std::string(path, static_cast<size_t>(length));
+#endif
+        return fallback;
+    }
+
+    // Runs `executable` with args (argv[0] is the executable). Returns the
+    // child's id, or -1 with `error` set.
+    static ProcessId spawn(const std::string& executable, const std::vector<std::string>& args, std::string& error) {
+#ifdef _WIN32
+        (void)executable;
+        (void)args;
+        error = "worker processes are not supported on Windows";
+        return -1;
+#else
+        std::vector<char*> argv;
+        argv.reserve(args.size() + 2);
+        argv.push_back(const_cast<char*>(executable.c_str()));
+        for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+
+        // Children start with no blocked signals, whatever the spawning thread had blocked
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        sigset_t noSignals;
+        sigemptyset(&noSignals);
+        posix_spawnattr_setsigmask(&attributes, &noSignals);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK);
+
+        pid_t pid = -1;
+        int result = posix_spawn(&pid, executable.c_str(), nullptr, &attributes, argv.data(), environ);
+        posix_spawnattr_destroy(&attributes);
+        if (result != 0) {
+            error = "posix_spawn " + executable + ": " + std::strerror(result);
+            return -1;
+        }
+        return pid;
+#endif
+    }
+
+    // Blocks until a child exits and reports it. Returns false when this
+    // process has no children left.
+    static bool waitAny(ExitStatus& status) {
+#ifdef _WIN32
+        (void)status;
+        return false;
+#else
+        int rawStatus = 0;
+        struct rusage usage{};
+        pid_t pid;
+        do {
+            pid = wait4(-1, &rawStatus, 0, &usage);
+        } while (pid < 0 && errno == EINTR);
+        if (pid < 0) return false;
+
+        status = ExitStatus();
+        status.pid = pid;
+        if (WIFEXITED(rawStatus)) status.exitCode = WEXITSTATUS(rawStatus);
+        if (WIFSIGNALED(rawStatus)) status.signal = WTERMSIG(rawStatus);
+        status.cpuSeconds = static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                            static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+        status.maxResidentKb = usage.ru_maxrss;
+        return true;
+#endif
+    }
+
+    static void terminate(ProcessId pid) {
+#ifndef _WIN32
+        if (pid > 0) kill(pid, SIGTERM);
+#else
+        (void)pid;
+#endif
+    }
+
+    static ProcessId parentId() {
+#ifdef _WIN32
+        return 0;
+#else
+        return getppid();
+#endif
+    }
+
+    // Applies `limits` to the calling process.
+    static bool applyLimits(const WorkerLimits& limits, std::string& error) {
+#ifdef _WIN32
+        if (limits.cpuSeconds != 0 || limits.memoryBytes != 0) {
+            error = "resource limits are not supported on Windows";
+            return false;
+        }
+        return true;
+#else
+        if (limits.cpuSeconds != 0) {
+            struct rlimit cpu{};
+            cpu.rlim_cur = static_cast<rlim_t>(limits.cpuSeconds);
+            cpu.rlim_max = static_cast<rlim_t>(limits.cpuSeconds + 1);
+            if (setrlimit(RLIMIT_CPU, &cpu) != 0) {
+                error = std::string("setrlimit(RLIMIT_CPU): ") + std::strerror(errno);
+                return false;
+            }
+        }
+        if (limits.memoryBytes != 0) {
+            struct rlimit memory{};
+            memory.rlim_cur = static_cast<rlim_t>(limits.memoryBytes);
+            memory.rlim_max = static_cast<rlim_t>(limits.memoryBytes);
+            if (setrlimit(RLIMIT_AS, &memory) != 0) {
+                error = std::string("setrlimit(RLIMIT_AS): ") + std::strerror(errno);
+                return false;
+            }
+        }
+        return true;
+#endif
+    }
+
+    static std::string describe(const ExitStatus& status) {
+        std::string text;
+        if (status.signal != 0) {
+#ifndef _WIN32
+            text = "killed by signal " + std::to_string(status.signal) + " (" + strsignal(status.signal) + ")";
+            if (status.signal == SIGXCPU || status.signal == SIGKILL) text += ", possibly by the CPU limit";
+#endif
+        } else {
+            text = "exited with code " + std::to_string(status.exitCode);
+        }
+        char usage[64];
+        std::snprintf(usage, sizeof(usage), "; %.2fs CPU, %ld KiB max RSS", status.cpuSeconds, status.maxResidentKb);
+        return text + usage;
+    }
+};
+
+#endif // PROCESS_LAUNCHER_H
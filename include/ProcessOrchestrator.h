@@ -1,13 +1,44 @@
 #ifndef PROCESS_ORCHESTRATOR_H
 #define PROCESS_ORCHESTRATOR_H
 
+#include "ConfigureManager.h"
+#include "InputSplit.h"
+#include "PartitionManifest.h"
+#include "RangePartitioner.h"
+#include "TaskCounters.h"
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+class Mapper;
+class MapReducePlugin;
+
 class ProcessOrchestratorDLL {
 public:
     static constexpr size_t DEFAULT_MIN_THREADS = 0;
     static constexpr size_t DEFAULT_MAX_THREADS = 0;
+    static constexpr const char* DEFAULT_CONFIG_FILE = "config.txt";
+
+    // Load optional job settings (key=value). Returns false and keeps defaults if the file is absent.
+    bool loadConfig(const std::string& configFilePath = DEFAULT_CONFIG_FILE);
+    ConfigManager& getConfig() { return config; }
+    const ConfigManager& getConfig() const { return config; }
+
+    // Apply logging settings (level, console echo, async writer) from the loaded configuration
+    void applyLoggerConfig() const;
+
+    // Apply mapper-side settings from the loaded configuration (e.g. the combiner)
+    void applyMapperConfig(Mapper& mapper) const;
+
+    // Samples the splits, builds balanced key ranges for numReducers reducers and
+    // saves them to tempDir so mapper processes can load them. Mappers configured
+    // afterwards partition by range. Returns false (hash partitioning stays in
+    // effect) if the sample is empty or the boundaries cannot be saved.
+    bool planRangePartitions(const std::vector<InputSplit>& inputSplits, int numReducers, const std::string& tempDir);
+
+    // Loads the ranges saved by planRangePartitions (mapper processes).
+    bool loadRangePartitions(const std::string& tempDir, int numReducers);
 
     // Function to start the orchestration process
     void start(const std::string& tempDir,
@@ -25,15 +56,66 @@ public:
                    size_t minPoolThreads = DEFAULT_MIN_THREADS,
                    size_t maxPoolThreads = DEFAULT_MAX_THREADS);
 
-    // Function to run the reducer
+    // Function to run the mapper over planned input splits. The mapper stages
+    // its own partition files and publishes them with a PartitionManifest.
+    bool runMapper(const std::string& tempDir,
+                   int mapperId,
+                   int numReducers,
+                   const std::vector<InputSplit>& inputSplits,
+                   size_t minPoolThreads = DEFAULT_MIN_THREADS,
+                   size_t maxPoolThreads = DEFAULT_MAX_THREADS);
+
+    // Removes reducer_<r>.txt outputs (and staged copies) left in outputDir by an
+    // earlier job. Reducers never replace a committed output, so a job calls
+    // this before it starts.
+    static void clearReducerOutputs(const std::string& outputDir);
+
+    // Function to run the reducer over the partitions listed by committed mappers' manifests
     bool runReducer(const std::string& outputDir,
                     const std::string& tempDir,
                     int reducerId,
                     size_t minPoolThreads = DEFAULT_MIN_THREADS,
                     size_t maxPoolThreads = DEFAULT_MAX_THREADS);
 
+    // Which attempt of a task the next runMapper / runReducer call is. Attempts
+    // other than 0 stage and commit under their own names (see
+    // PartitionManifest), so a speculative copy can run beside the original.
+    void setTaskAttempt(uint32_t attempt) { taskAttempt = attempt; }
+    uint32_t getTaskAttempt() const { return taskAttempt; }
+
+    // Progress of the running task is reported to `counters` (null: not reported).
+    void setProgressCounters(TaskCounters* counters) { progress = counters; }
+
+    // Applies worker_cpu_seconds / worker_memory_bytes to the calling (worker) process
+    bool applyWorkerLimits() const;
+
+    // Spawns `executable mapper ...` for every entry of mapperSplits and
+    // `executable reducer ...` for every reducer, waits for all of them and
+    // terminates the rest as soon as one fails. Returns true if all succeeded.
+    bool runWorkerProcesses(const std::string& executable,
+                            const std::vector<std::vector<InputSplit>>& mapperSplits,
+                            int numReducers,
+                            const std::string& outputDir,
+                            const std::string& tempDir);
+
+    // Reducer side of multi-process mode (execution_mode=processes): shuffles
+    // each mapper's partition as soon as its manifest appears, so the shuffle
+    // overlaps the map phase, then merges them into reducer_<reducerId>.txt.
+    bool runPipelinedReducer(const std::string& outputDir,
+                             const std::string& tempDir,
+                             int reducerId,
+                             int numMappers);
+
 private:
+    ConfigManager config;
+    RangePartitioner rangePartitioner; // Empty unless range partitioning was planned or loaded
+    uint32_t taskAttempt = 0;
+    TaskCounters* progress = nullptr;
+
     // Private helper functions
+    // Loads plugin_library if configured (plugin stays null otherwise). False,
+    // logged, if the library is configured but cannot be loaded.
+    bool loadPlugin(std::shared_ptr<const MapReducePlugin>& plugin) const;
     size_t resolveDefaultThreads() const;
     std::string formatThreadCount(size_t count) const;
 
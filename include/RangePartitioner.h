@@ -0,0 +1,215 @@
+#ifndef RANGE_PARTITIONER_H
+#define RANGE_PARTITIONER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "KeyValueBuffer.h"
+
+// How mappers assign keys to reducers.
+enum class PartitionScheme {
+    HASH, // Stable seeded hash (Partitioner)
+    RANGE // Sampled key ranges (RangePartitioner)
+};
+
+// Assigns keys to reducers by key range instead of by hash. The R-1 sorted
+// boundary keys come from a sample of the input weighted by occurrence, so
+// each reducer receives about the same number of records even though word
+// frequencies are heavily skewed. Reducer r owns the keys in
+// (boundary[r-1], boundary[r]], which makes reducer_0 ... reducer_{R-1} one
+// globally key-sorted sequence.
+//
+// A key at least as heavy as one reducer's share gets reducers of its own and
+// repeats once in the boundaries per reducer it spans. Its records are dealt
+// round-robin across those reducers and the final reduction sums the partial
+// counts, so a split key appears once in each of those adjacent reducer
+// outputs and the concatenated output stays sorted. With splitting off (a
+// reduce plugin must see each key's full sum), a hot key keeps one reducer and
+// repeated boundaries only leave the reducers after it empty.
+class RangePartitioner {
+public:
+    static constexpr const char* BOUNDARY_FILE_NAME = "partition_boundaries.txt";
+    static constexpr size_t DEFAULT_SAMPLE_BYTES_PER_SPLIT = 256 * 1024;
+
+    RangePartitioner() = default;
+
+    // boundaries must hold numReducers - 1 keys in non-decreasing order.
+    RangePartitioner(int numReducers, std::vector<std::string> boundaryKeys)
+        : numReducers(numReducers), boundaries(std::move(boundaryKeys)), spreadCursors(boundaries.size() + 1, 0) {}
+
+    // Builds balanced ranges from sampled (key, count) records. Duplicate keys
+    // in the sample are summed. Returns an empty partitioner if the sample
+    // holds no records or numReducers < 2.
+    static RangePartitioner fromSample(int numReducers, const KeyValueBuffer& sample, bool splitHotKeys = true) {
+        if (numReducers < 2 || sample.empty()) return RangePartitioner();
+        std::vector<KeyValueBuffer::Record> sorted(sample.begin(), sample.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.key() < b.key(); });
+
+        // Collapse to distinct keys with their total weight
+        std::vector<std::pair<std::string, double>> weighted;
+        double remainingWeight = 0;
+        for (const auto& record : sorted) {
+            double weight = static_cast<double>(std::max(record.value, 0));
+            if (weighted.empty() || weighted.back().first != record.key()) {
+                weighted.emplace_back(std::string(record.key()), weight);
+            } else {
+                weighted.back().second += weight;
+            }
+            remainingWeight += weight;
+        }
+        if (remainingWeight == 0) return RangePartitioner();
+
+        // Greedy: close a range once it holds the average weight still to be
+        // placed per remaining reducer. A key at least that heavy closes the
+        // open range and takes round(weight / target) reducers of its own, or
+        // one if hot keys are not split.
+        const size_t maxBoundaries = static_cast<size_t>(numReducers - 1);
+        std::vector<std::string> boundaryKeys;
+        boundaryKeys.reserve(maxBoundaries);
+        double load = 0;
+        for (size_t i = 0; i < weighted.size() && boundaryKeys.size() < maxBoundaries; ++i) {
+            const std::string& key = weighted[i].first;
+            const double weight = weighted[i].second;
+            double target = remainingWeight / static_cast<double>(numReducers - boundaryKeys.size());
+            if (weight >= target && load > 0) {
+                boundaryKeys.push_back(weighted[i - 1].first);
+                remainingWeight -= load;
+                load = 0;
+                if (boundaryKeys.size() == maxBoundaries) break;
+                target = remainingWeight / static_cast<double>(numReducers - boundaryKeys.size());
+            }
+            if (weight >= target) {
+                size_t span = splitHotKeys ? static_cast<size_t>(weight / target + 0.5) : 1;
+                span = std::min(std::max<size_t>(span, 1), maxBoundaries - boundaryKeys.size());
+                boundaryKeys.insert(boundaryKeys.end(), span, key);
+                remainingWeight -= weight;
+                continue;
+            }
+            load += weight;
+            if (load >= target) {
+                boundaryKeys.push_back(key);
+                remainingWeight -= load;
+                load = 0;
+            }
+        }
+        // Ran out of sampled keys early: the last one spans the trailing reducers
+        while (boundaryKeys.size() < maxBoundaries) boundaryKeys.push_back(weighted.back().first);
+        RangePartitioner planned(numReducers, std::move(boundaryKeys));
+        planned.setSplitHotKeys(splitHotKeys);
+        return planned;
+    }
+
+    bool empty() const { return numReducers == 0; }
+    int getNumReducers() const { return numReducers; }
+    const std::vector<std::string>& getBoundaries() const { return boundaries; }
+
+    // Whether a key repeated in the boundaries is dealt across its reducers
+    // (the default) or sent whole to the first of them. Not saved with the
+    // boundaries: every mapper of a job must set it the same way.
+    void setSplitHotKeys(bool split) { splitHotKeys = split; }
+    bool splitsHotKeys() const { return splitHotKeys; }
+
+    // First reducer and number of reducers that share `key`. The count is 1
+    // except for a hot key, which spans one reducer per repeated boundary
+    // while hot keys are split.
+    std::pair<uint32_t, uint32_t> getReducerSpan(std::string_view key) const {
+        auto first = std::lower_bound(boundaries.begin(), boundaries.end(), key,
+                                      [](const std::string& boundary, std::string_view k) { return std::string_view(boundary) < k; });
+        auto last = std::upper_bound(first, boundaries.end(), key,
+                                     [](std::string_view k, const std::string& boundary) { return k < std::string_view(boundary); });
+        uint32_t begin = static_cast<uint32_t>(first - boundaries.begin());
+        uint32_t width = static_cast<uint32_t>(last - first);
+        return {begin, splitHotKeys && width > 1 ? width : 1};
+    }
+
+    // Not const: records of a hot key advance that key's round-robin cursor.
+    uint32_t getReducerBucket(std::string_view key) {
+        return bucketInSpan(getReducerSpan(key));
+    }
+
+    // Buckets for many keys in one call: buckets[i] is the reducer of records[i].key().
+    // For interned keys the boundary search runs once per distinct key ID.
+    void getReducerBuckets(const KeyValueBuffer& records, std::vector<uint32_t>& buckets) {
+        buckets.resize(records.size());
+        const KeyDictionary* keys = records.keyDictionary();
+        if (keys == nullptr) {
+            for (size_t i = 0; i < records.size(); ++i) {
+                buckets[i] = getReducerBucket(records[i].key());
+            }
+            return;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> spans(keys->size(), {0, 0}); // By key ID; width 0 until searched
+        for (size_t i = 0; i < records.size(); ++i) {
+            std::pair<uint32_t, uint32_t>& span = spans[records.keyId(i)];
+            if (span.second == 0) span = getReducerSpan(records[i].key());
+            buckets[i] = bucketInSpan(span);
+        }
+    }
+
+    // One boundary key per line after a "<numReducers>" header line. Keys come
+    // from the tokenizer and never contain '\n'.
+    bool save(const std::string& path, std::string& error) const {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open()) {
+            error = "could not open " + path;
+            return false;
+        }
+        out << numReducers << "\n";
+        for (const std::string& key : boundaries) out << key << "\n";
+        out.close();
+        if (out.fail()) {
+            error = "could not write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    static bool load(const std::string& path, RangePartitioner& partitioner, std::string& error) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            error = "could not open " + path;
+            return false;
+        }
+        int reducers = 0;
+        std::string line;
+        if (!std::getline(in, line)) {
+            error = "missing header in " + path;
+            return false;
+        }
+        try {
+            reducers = std::stoi(line);
+        } catch (const std::exception&) {
+            error = "invalid header in " + path;
+            return false;
+        }
+        std::vector<std::string> keys;
+        while (std::getline(in, line)) keys.push_back(line);
+        if (reducers < 2 || keys.size() != static_cast<size_t>(reducers - 1) || !std::is_sorted(keys.begin(), keys.end())) {
+            error = "inconsistent boundaries in " + path;
+            return false;
+        }
+        partitioner = RangePartitioner(reducers, std::move(keys));
+        return true;
+    }
+
+private:
+    uint32_t bucketInSpan(std::pair<uint32_t, uint32_t> span) {
+        if (span.second == 1) return span.first;
+        uint32_t& cursor = spreadCursors[span.first];
+        uint32_t bucket = span.first + cursor;
+        cursor = cursor + 1 == span.second ? 0 : cursor + 1;
+        return bucket;
+    }
+
+    int numReducers = 0;
+    std::vector<std::string> boundaries;
+    std::vector<uint32_t> spreadCursors; // Per span start; only hot-key spans use theirs
+    bool splitHotKeys = true;
+};
+
+#endif // RANGE_PARTITIONER_H
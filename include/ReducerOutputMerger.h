@@ -0,0 +1,321 @@
+#ifndef REDUCER_OUTPUT_MERGER_H
+#define REDUCER_OUTPUT_MERGER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ERROR_Handler.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+// Final stage of a job: merges the key-sorted "key: count" reducer outputs
+// into output.txt and output_summed.txt in a single streaming pass. Hash
+// partitions are disjoint and range partitions only share a hot key between
+// adjacent reducers, so a k-way merge that sums equal keys gives the same
+// result as re-reducing everything.
+//
+// The key space is cut at keys sampled from the inputs, and each key range is
+// merged as a separate task on a ThreadPool. Finished ranges are written in
+// key order. At most `windowRanges` ranges are buffered at a time, so memory
+// stays bounded by the window, not the size of the output.
+class ReducerOutputMerger {
+public:
+    static constexpr size_t DEFAULT_RANGE_BYTES = 4 * 1024 * 1024; // Reducer output bytes per merge task
+    static constexpr size_t SAMPLES_PER_RANGE = 4;                   // Sampled keys per planned range
+
+    ReducerOutputMerger() = default;
+    ReducerOutputMerger(const ReducerOutputMerger&) = delete;
+    ReducerOutputMerger& operator=(const ReducerOutputMerger&) = delete;
+
+    // Maps a reducer output file. Returns false if it cannot be read.
+    bool addFile(const std::string& path) {
+        auto file = std::make_unique<MappedFile>();
+        if (!file->open(path)) return false;
+        Input input;
+        input.path = path;
+        input.bytes = file->view();
+        input.file = std::move(file);
+        inputs.push_back(std::move(input));
+        return true;
+    }
+
+    size_t fileCount() const { return inputs.size(); }
+    size_t keyCount() const { return keys; }
+    size_t rangeCount() const { return ranges; }
+
+    // Writes "key: sum" lines to outputPath and "<"key", sum>" lines to
+    // summedPath, each through a ".tmp" file renamed into place. An input
+    // that turns out not to be key-sorted is sorted in memory and the merge
+    // is redone. Returns false with `error` set if an output cannot be written.
+    bool mergeTo(const std::string& outputPath, const std::string& summedPath, ThreadPool& pool, size_t windowRanges,
+                 std::string& error, size_t rangeBytes = DEFAULT_RANGE_BYTES) {
+        std::vector<size_t> unsorted;
+        if (!writeOutputs(outputPath, summedPath, pool, windowRanges, rangeBytes, unsorted, error)) return false;
+        if (unsorted.empty()) return true;
+        for (size_t index : unsorted) {
+            Logger::getInstance().log("ReducerOutputMerger: " + inputs[index].path + " is not key-sorted; sorting it in memory.",
+                                      Logger::Level::WARNING);
+            sortInMemory(inputs[index]);
+        }
+        unsorted.clear();
+        return writeOutputs(outputPath, summedPath, pool, windowRanges, rangeBytes, unsorted, error);
+    }
+
+private:
+    struct Input {
+        std::string path;
+        std::unique_ptr<MappedFile> file;
+        std::string sorted; // Owned copy when the file had to be sorted in memory
+        std::string_view bytes;
+    };
+
+    // One input's lines within a key range.
+    struct Cursor {
+        std::string_view rest;
+        std::string_view key;
+        long long count = 0;
+        size_t input = 0;
+        const std::string* lower = nullptr; // Keys of the range are > *lower and <= *upper
+        const std::string* upper = nullptr;
+        bool unsorted = false;
+    };
+
+    struct Chunk {
+        std::string output;
+        std::string summed;
+        size_t keys = 0;
+        std::vector<size_t> unsortedInputs;
+    };
+
+    // Start of the first line at or after pos (bytes.size() if none).
+    static size_t lineStart(std::string_view bytes, size_t pos) {
+        if (pos == 0) return 0;
+        size_t newline = bytes.find('\n', pos - 1);
+        return newline == std::string_view::npos ? bytes.size() : newline + 1;
+    }
+
+    static std::string_view lineAt(std::string_view bytes, size_t pos) {
+        size_t end = bytes.find('\n', pos);
+        std::string_view line = bytes.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return line;
+    }
+
+    static std::string_view keyOf(std::string_view line) {
+        size_t separator = line.find(": ");
+        return separator == std::string_view::npos ? line : line.substr(0, separator);
+    }
+
+    // Offset of the first line whose key is greater than `splitter`.
+    static size_t upperBound(std::string_view bytes, std::string_view splitter) {
+        size_t lo = 0;
+        size_t hi = bytes.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            size_t start = lineStart(bytes, mid);
+            if (start >= bytes.size() || keyOf(lineAt(bytes, start)) > splitter) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lineStart(bytes, lo);
+    }
+
+    // Range boundaries: the keys at evenly spaced ranks of a sample drawn in
+    // proportion to each input's size.
+    std::vector<std::string> planSplitters(size_t rangeBytes) const {
+        size_t total = 0;
+        for (const Input& input : inputs) total += input.bytes.size();
+        size_t wanted = total / std::max<size_t>(rangeBytes, 1);
+        if (wanted < 2) return {};
+
+        std::vector<std::string_view> sample;
+        for (const Input& input : inputs) {
+            size_t size = input.bytes.size();
+            size_t samples = std::max<size_t>(1, size * wanted * SAMPLES_PER_RANGE / total);
+            for (size_t i = 0; i < samples; ++i) {
+                size_t start = lineStart(input.bytes, size / samples * i);
+                if (start < size) sample.push_back(keyOf(lineAt(input.bytes, start)));
+            }
+        }
+        std::sort(sample.begin(), sample.end());
+        std::vector<std::string> splitters;
+        for (size_t r = 1; r < wanted; ++r) {
+            std::string_view key = sample[r * sample.size() / wanted];
+            if (splitters.empty() || splitters.back() != key) splitters.emplace_back(key);
+        }
+        return splitters;
+    }
+
+    static bool advance(Cursor& cursor) {
+        while (!cursor.rest.empty()) {
+            size_t end = cursor.rest.find('\n');
+            std::string_view line = cursor.rest.substr(0, end);
+            cursor.rest.remove_prefix(end == std::string_view::npos ? cursor.rest.size() : end + 1);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            size_t separator = line.find(": ");
+            if (separator == std::string_view::npos) continue; // Not a "key: count" line
+            std::string_view value = line.substr(separator + 2);
+            long long count = 0;
+            auto parsed = std::from_chars(value.data(), value.data() + value.size(), count);
+            if (parsed.ec != std::errc()) continue;
+            std::string_view key = line.substr(0, separator);
+            if (key < cursor.key || (cursor.lower != nullptr && key <= *cursor.lower) ||
+                (cursor.upper != nullptr && key > *cursor.upper)) {
+                cursor.unsorted = true;
+            }
+            cursor.key = key;
+            cursor.count = count;
+            return true;
+        }
+        return false;
+    }
+
+    // Merges key range r; `bounds[i]` is that range's byte span in input i.
+    Chunk mergeRange(const std::vector<std::pair<size_t, size_t>>& bounds, const std::vector<std::string>& splitters, size_t r) const {
+        std::vector<Cursor> cursors(inputs.size());
+        auto greater = [&cursors](size_t a, size_t b) { return cursors[a].key > cursors[b].key; };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            cursors[i].rest = inputs[i].bytes.substr(bounds[i].first, bounds[i].second - bounds[i].first);
+            cursors[i].input = i;
+            cursors[i].lower = r > 0 ? &splitters[r - 1] : nullptr;
+            cursors[i].upper = r < splitters.size() ? &splitters[r] : nullptr;
+            if (advance(cursors[i])) heap.push(i);
+        }
+
+        Chunk chunk;
+        std::string_view currentKey; // Points into the mapped input, which outlives the merge
+        long long currentSum = 0;
+        bool haveKey = false;
+        auto emit = [&chunk, &currentKey, &currentSum]() {
+            std::string sum = std::to_string(currentSum);
+            chunk.output.append(currentKey.data(), currentKey.size());
+            chunk.output += ": ";
+            chunk.output += sum;
+            chunk.output += '\n';
+            chunk.summed += "<\"";
+            chunk.summed.append(currentKey.data(), currentKey.size());
+            chunk.summed += "\", ";
+            chunk.summed += sum;
+            chunk.summed += ">\n";
+            ++chunk.keys;
+        };
+        while (!heap.empty()) {
+            size_t top = heap.top();
+            heap.pop();
+            Cursor& cursor = cursors[top];
+            if (haveKey && cursor.key == currentKey) {
+                currentSum += cursor.count;
+            } else {
+                if (haveKey) emit();
+                currentKey = cursor.key;
+                currentSum = cursor.count;
+                haveKey = true;
+            }
+            if (advance(cursor)) heap.push(top);
+        }
+        if (haveKey) emit();
+        for (const Cursor& cursor : cursors) {
+            if (cursor.unsorted) chunk.unsortedInputs.push_back(cursor.input);
+        }
+        return chunk;
+    }
+
+    bool writeOutputs(const std::string& outputPath, const std::string& summedPath, ThreadPool& pool, size_t windowRanges,
+                      size_t rangeBytes, std::vector<size_t>& unsorted, std::string& error) {
+        std::vector<std::string> splitters = planSplitters(rangeBytes);
+        ranges = splitters.size() + 1;
+        keys = 0;
+
+        // bounds[r][i]: byte span of range r in input i
+        std::vector<std::vector<std::pair<size_t, size_t>>> bounds(ranges, std::vector<std::pair<size_t, size_t>>(inputs.size()));
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            size_t begin = 0;
+            for (size_t r = 0; r < ranges; ++r) {
+                size_t end = r + 1 < ranges ? std::max(begin, upperBound(inputs[i].bytes, splitters[r])) : inputs[i].bytes.size();
+                bounds[r][i] = {begin, end};
+                begin = end;
+            }
+        }
+
+        const std::string outputTemp = outputPath + ".tmp";
+        const std::string summedTemp = summedPath + ".tmp";
+        std::ofstream output(outputTemp, std::ios::binary | std::ios::trunc);
+        std::ofstream summed(summedTemp, std::ios::binary | std::ios::trunc);
+        if (!output || !summed) {
+            error = "could not open " + (!output ? outputTemp : summedTemp) + " for writing";
+            std::remove(outputTemp.c_str());
+            std::remove(summedTemp.c_str());
+            return false;
+        }
+
+        const size_t window = std::max<size_t>(windowRanges, 1);
+        std::vector<Chunk> chunks(window);
+        for (size_t first = 0; first < ranges && unsorted.empty(); first += window) {
+            size_t last = std::min(first + window, ranges);
+            pool.parallel_for(first, last, 1, [&](size_t begin, size_t end) {
+                for (size_t r = begin; r < end; ++r) chunks[r - first] = mergeRange(bounds[r], splitters, r);
+            });
+            for (size_t r = first; r < last; ++r) {
+                Chunk& chunk = chunks[r - first];
+                output.write(chunk.output.data(), static_cast<std::streamsize>(chunk.output.size()));
+                summed.write(chunk.summed.data(), static_cast<std::streamsize>(chunk.summed.size()));
+                keys += chunk.keys;
+                unsorted.insert(unsorted.end(), chunk.unsortedInputs.begin(), chunk.unsortedInputs.end());
+                chunk = Chunk();
+            }
+        }
+        output.close();
+        summed.close();
+
+        bool written = !output.fail() && !summed.fail();
+        if (!written || !unsorted.empty()) {
+            if (!written) error = "could not write " + outputTemp + " or " + summedTemp;
+            std::remove(outputTemp.c_str());
+            std::remove(summedTemp.c_str());
+            std::sort(unsorted.begin(), unsorted.end());
+            unsorted.erase(std::unique(unsorted.begin(), unsorted.end()), unsorted.end());
+            return written;
+        }
+        if (std::rename(outputTemp.c_str(), outputPath.c_str()) != 0 || std::rename(summedTemp.c_str(), summedPath.c_str()) != 0) {
+            error = "could not rename the merged outputs into place";
+            return false;
+        }
+        return true;
+    }
+
+    static void sortInMemory(Input& input) {
+        std::vector<std::string_view> lines;
+        for (size_t pos = 0; pos < input.bytes.size();) {
+            std::string_view line = lineAt(input.bytes, pos);
+            size_t next = lineStart(input.bytes, pos + 1);
+            if (!line.empty()) lines.push_back(line);
+            pos = next;
+        }
+        std::stable_sort(lines.begin(), lines.end(), [](std::string_view a, std::string_view b) { return keyOf(a) < keyOf(b); });
+        std::string sorted;
+        sorted.reserve(input.bytes.size() + 1);
+        for (std::string_view line : lines) {
+            sorted.append(line.data(), line.size());
+            sorted += '\n';
+        }
+        input.sorted = std::move(sorted);
+        input.bytes = input.sorted;
+    }
+
+    std::vector<Input> inputs;
+    size_t keys = 0;
+    size_t ranges = 0;
+};
+
+#endif // REDUCER_OUTPUT_MERGER_H
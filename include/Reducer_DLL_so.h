@@ -2,32 +2,89 @@
 #define REDUCER_DLL_SO_H
 
 #include "ExportDefinitions.h"
+#include "KeyValueBuffer.h"
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 
+class HashAggregationTable;
+class MapReducePlugin;
+class SortedRunMerger;
+
 class DLL_so_EXPORT ReducerDLLso {
 public:
     static constexpr size_t FALLBACK_REDUCE_THREAD_COUNT = 2;
+    static constexpr size_t PARALLEL_REDUCE_MIN_RECORDS = 64 * 1024; // Below this a pool costs more than it saves
+    static constexpr size_t MIN_REDUCE_CHUNK_SIZE = 16 * 1024;
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+    // Differs from any partition seed a job would use, so the keys of one reducer
+    // do not share high hash bits when sharded and slotted here.
+    static constexpr uint64_t AGGREGATION_HASH_SEED = 0x9E3779B97F4A7C15ULL;
+    static constexpr size_t PLUGIN_BATCH_RECORDS = 4096; // Merged keys per reduce_batch call
 
     virtual ~ReducerDLLso() {}
 
     virtual void reduce(
-        const std::vector<std::pair<std::string, int>>& mappedData,
+        const KeyValueBuffer& mappedData,
         std::map<std::string, int>& reducedData,
         size_t minPoolThreadsConfig = 0,
         size_t maxPoolThreadsConfig = 0
     );
 
+    // Sums counts per key in hash-sharded open-addressing tables, in parallel on a
+    // ThreadPool for large inputs, and appends one {key, sum} per distinct key to
+    // reducedData. The appended range is sorted by key only if sortByKey is set.
+    void reduceToVector(
+        const KeyValueBuffer& mappedData,
+        KeyValueBuffer& reducedData,
+        bool sortByKey = true,
+        size_t minPoolThreadsConfig = 0,
+        size_t maxPoolThreadsConfig = 0
+    );
+
+    // Streams a k-way merge over the key-sorted runs in partitionFiles and writes
+    // "key: sum" lines to outputPath in key order, without holding the partition
+    // in memory. The output file is only created if there is at least one key.
+    // Returns false if a partition file is unreadable or corrupt or the output
+    // cannot be written.
+    virtual bool reduceSortedRuns(
+        const std::vector<std::string>& partitionFiles,
+        const std::string& outputPath
+    );
+
+    // Same, for runs already registered with `merger` (e.g. added one mapper at
+    // a time while the other mappers were still running).
+    bool reduceSortedRuns(
+        SortedRunMerger& merger,
+        const std::string& outputPath
+    );
+
+    // With a plugin that has reduce_batch, reduceSortedRuns hands it the merged
+    // {key, sum} records PLUGIN_BATCH_RECORDS at a time and writes what it
+    // emits instead. A failed batch, or emitted keys out of ascending order,
+    // fails the reduce. Null restores plain sums.
+    void setPlugin(std::shared_ptr<const MapReducePlugin> reducePlugin) { plugin = std::move(reducePlugin); }
+
 protected:
     void process_reduce_internal(
-        const std::vector<std::pair<std::string, int>>& mappedData,
+        const KeyValueBuffer& mappedData,
         std::map<std::string, int>& reducedData,
         size_t minThreads,
         size_t maxThreads
     );
 
+    void aggregate_shards(
+        const KeyValueBuffer& mappedData,
+        std::vector<HashAggregationTable>& shards,
+        size_t minThreads,
+        size_t maxThreads
+    );
+
     size_t calculate_dynamic_chunk_size(size_t totalSize, size_t guideMaxThreads = 0) const;
+
+    std::shared_ptr<const MapReducePlugin> plugin;
 };
 
 #endif // REDUCER_DLL_SO_H
\ No newline at end of file
@@ -0,0 +1,180 @@
+#ifndef SORTED_RUN_MERGER_H
+#define SORTED_RUN_MERGER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "FileHandler.h"
+#include "KeyValueBuffer.h"
+#include "IntermediateFormat.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "TaskCounters.h"
+
+// Streams a k-way merge over the key-sorted runs of one reducer's partition
+// files and hands each distinct key to the caller once, with its counts summed.
+// Every sorted binary segment is a run that is decoded in place from the mapped
+// file, so memory stays at one cursor per run regardless of partition size.
+// Files without sorted runs (text files, or unsorted binary segments) are loaded
+// and sorted in memory as a single run, so older partition files still reduce.
+class SortedRunMerger {
+public:
+    SortedRunMerger() = default;
+    SortedRunMerger(const SortedRunMerger&) = delete;
+    SortedRunMerger& operator=(const SortedRunMerger&) = delete;
+
+    // Maps `path` and registers its runs. Returns false (and registers nothing
+    // from this file) if the file cannot be read or a segment is corrupt.
+    bool addFile(const std::string& path) {
+        return addFile(path, 0, MappedFile::WHOLE_FILE);
+    }
+
+    // Maps only `length` bytes at `offset` of `path`, such as one reducer's
+    // segments in an indexed spill file, so the rest of the file is never read.
+    // A partial range must hold whole, sorted binary segments.
+    bool addFile(const std::string& path, uint64_t offset, uint64_t length) {
+        const bool wholeFile = offset == 0 && length == MappedFile::WHOLE_FILE;
+        auto file = std::make_unique<MappedFile>();
+        if (!file->open(path, static_cast<size_t>(offset), static_cast<size_t>(length))) return false;
+        std::string_view bytes = file->view();
+        if (!wholeFile && !IntermediateFormat::isBinary(bytes)) {
+            ErrorHandler::reportError("Corrupt intermediate file " + path + ": no segment at offset " + std::to_string(offset));
+            return false;
+        }
+
+        if (IntermediateFormat::isBinary(bytes)) {
+            std::vector<IntermediateFormat::Segment> segments;
+            bool allSorted = true;
+            size_t pos = 0;
+            std::string error;
+            while (pos < bytes.size()) {
+                IntermediateFormat::Segment segment;
+                if (!IntermediateFormat::readSegment(bytes, pos, segment, error)) {
+                    ErrorHandler::reportError("Corrupt intermediate file " + path + ": " + error);
+                    return false;
+                }
+                allSorted = allSorted && segment.isSorted();
+                if (segment.recordCount > 0) segments.push_back(segment);
+            }
+            if (allSorted) {
+                for (const auto& segment : segments) {
+                    runs.push_back(Run{IntermediateFormat::RecordCursor(segment), nullptr, 0, {}, 0});
+                    inputRecords += segment.recordCount;
+                }
+                files.push_back(std::move(file));
+                return true;
+            }
+        }
+
+        // No sorted runs to stream: load the file and sort it into one owned run
+        file.reset();
+        if (!wholeFile) {
+            ErrorHandler::reportError("Intermediate file " + path + " has unsorted segments at offset " + std::to_string(offset));
+            return false;
+        }
+        auto records = std::make_unique<KeyValueBuffer>();
+        if (!FileHandler::read_mapped_data(path, *records)) return false;
+        if (records->empty()) return true;
+        records->sortByKey();
+        Logger::getInstance().log("SortedRunMerger: Sorted " + std::to_string(records->size()) + " unsorted records from " + path + " in memory.");
+        runs.push_back(Run{IntermediateFormat::RecordCursor(), records.get(), 0, {}, 0});
+        inputRecords += records->size();
+        ownedRuns.push_back(std::move(records));
+        return true;
+    }
+
+    size_t runCount() const { return runs.size(); }
+    uint64_t recordCount() const { return inputRecords; }
+
+    // Reports input records consumed and keys emitted to `counters` while
+    // merge() runs, in batches of PROGRESS_BATCH records. Null stops reporting.
+    void setProgressCounters(TaskCounters* counters) { progress = counters; }
+
+    // Calls fn(std::string_view key, long long sum) for every distinct key in
+    // ascending byte order. Returns false if a run turned out to be corrupt
+    // while decoding; keys already delivered are not retracted.
+    template <typename Fn>
+    bool merge(Fn&& fn) {
+        auto greater = [this](size_t a, size_t b) { return runs[a].key > runs[b].key; };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+        bool ok = true;
+        for (size_t i = 0; i < runs.size(); ++i) {
+            if (advance(runs[i], ok)) heap.push(i);
+        }
+
+        std::string currentKey; // Owned copy: the run that produced it may advance past it
+        long long currentSum = 0;
+        bool haveKey = false;
+        uint64_t consumed = 0, emitted = 0; // Not yet reported to `progress`
+        auto report = [&]() {
+            if (progress == nullptr) return;
+            progress->add(progress->done, consumed);
+            progress->add(progress->records, emitted);
+            consumed = emitted = 0;
+        };
+        while (!heap.empty()) {
+            size_t top = heap.top();
+            heap.pop();
+            Run& run = runs[top];
+            if (haveKey && run.key == currentKey) {
+                currentSum += run.count;
+            } else {
+                if (haveKey) {
+                    fn(std::string_view(currentKey), currentSum);
+                    ++emitted;
+                }
+                currentKey.assign(run.key.data(), run.key.size());
+                currentSum = run.count;
+                haveKey = true;
+            }
+            if (++consumed == PROGRESS_BATCH) report();
+            if (advance(run, ok)) heap.push(top);
+        }
+        if (haveKey) {
+            fn(std::string_view(currentKey), currentSum);
+            ++emitted;
+        }
+        report();
+        return ok;
+    }
+
+private:
+    static constexpr uint64_t PROGRESS_BATCH = 4096;
+
+    struct Run {
+        IntermediateFormat::RecordCursor cursor;
+        const KeyValueBuffer* owned; // Set for in-memory runs
+        size_t ownedPos;
+        std::string_view key;
+        int count;
+    };
+
+    static bool advance(Run& run, bool& ok) {
+        if (run.owned != nullptr) {
+            if (run.ownedPos >= run.owned->size()) return false;
+            const auto& record = (*run.owned)[run.ownedPos++];
+            run.key = record.key();
+            run.count = record.value;
+            return true;
+        }
+        if (run.cursor.next(run.key, run.count)) return true;
+        if (run.cursor.failed()) {
+            ErrorHandler::reportError("SortedRunMerger: Corrupt record data in a sorted run; remaining records of the run were skipped.");
+            ok = false;
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<std::unique_ptr<KeyValueBuffer>> ownedRuns;
+    std::vector<Run> runs;
+    uint64_t inputRecords = 0;
+    TaskCounters* progress = nullptr;
+};
+
+#endif // SORTED_RUN_MERGER_H
@@ -0,0 +1,117 @@
+#ifndef STABLE_HASH_H
+#define STABLE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// XXH64 (Yann Collet, xxHash, BSD-2-Clause algorithm), written out so that the
+// value of a key depends only on its bytes and the seed: not on the standard
+// library, compiler, build flags or host byte order. Mappers and reducers built
+// with different toolchains therefore agree on partition layout.
+class StableHash {
+public:
+    static uint64_t hash(const void* input, size_t length, uint64_t seed = 0) {
+        const unsigned char* p = static_cast<const unsigned char*>(input);
+        const unsigned char* const end = p + length;
+        uint64_t h;
+
+        if (length >= 32) {
+            const unsigned char* const limit = end - 32;
+            uint64_t v1 = seed + PRIME1 + PRIME2;
+            uint64_t v2 = seed + PRIME2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME1;
+            do {
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h = mergeRound(h, v1);
+            h = mergeRound(h, v2);
+            h = mergeRound(h, v3);
+            h = mergeRound(h, v4);
+        } else {
+            h = seed + PRIME5;
+        }
+
+        h += static_cast<uint64_t>(length);
+        for (; p + 8 <= end; p += 8) {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * PRIME1 + PRIME4;
+        }
+        if (p + 4 <= end) {
+            h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+            h = rotl(h, 23) * PRIME2 + PRIME3;
+            p += 4;
+        }
+        for (; p < end; ++p) {
+            h ^= (*p) * PRIME5;
+            h = rotl(h, 11) * PRIME1;
+        }
+
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static uint64_t hash(std::string_view key, uint64_t seed = 0) {
+        return hash(key.data(), key.size(), seed);
+    }
+
+    // Maps a 64-bit hash onto [0, range) with a multiply and shift instead of a
+    // division (Lemire, "A fast alternative to the modulo reduction"). Uses the
+    // high 32 bits of the hash, so it stays portable without 128-bit integers.
+    static uint32_t fastRange(uint64_t hash, uint32_t range) {
+        return static_cast<uint32_t>(((hash >> 32) * static_cast<uint64_t>(range)) >> 32);
+    }
+
+private:
+    static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t round(uint64_t acc, uint64_t input) {
+        acc += input * PRIME2;
+        acc = rotl(acc, 31);
+        return acc * PRIME1;
+    }
+
+    static uint64_t mergeRound(uint64_t acc, uint64_t value) {
+        acc ^= round(0, value);
+        return acc * PRIME1 + PRIME4;
+    }
+
+    // Little-endian loads; memcpy keeps unaligned reads well-defined and
+    // compiles to a single load on mainstream targets.
+    static uint64_t read64(const unsigned char* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+
+    static uint32_t read32(const unsigned char* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap32(value);
+#endif
+        return value;
+    }
+};
+
+#endif // STABLE_HASH_H
@@ -0,0 +1,21 @@
+#ifndef TASK_COUNTERS_H
+#define TASK_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+// Live progress of one map or reduce task. The task updates the counters as it
+// goes (relaxed atomics, no locking) and the worker reads them for heartbeats.
+// `done` and `total` are in the task's input unit: bytes of input splits for a
+// mapper, input records for a reducer. `records` counts records emitted: words
+// for a mapper, distinct keys for a reducer.
+struct TaskCounters {
+    std::atomic<uint64_t> done{0};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> records{0};
+
+    void add(std::atomic<uint64_t>& counter, uint64_t amount) { counter.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t get(const std::atomic<uint64_t>& counter) const { return counter.load(std::memory_order_relaxed); }
+};
+
+#endif // TASK_COUNTERS_H
@@ -0,0 +1,38 @@
+#ifndef TEXT_NORMALIZER_H
+#define TEXT_NORMALIZER_H
+
+#include "ExportDefinitions.h"
+#include <cstddef>
+
+// Vectorized case-folding/punctuation-stripping pass that runs ahead of the
+// Tokenizer. normalize() rewrites a buffer into its canonical form:
+//   - ASCII uppercase letters are folded to lowercase
+//   - punctuation bytes are removed (they never split a word)
+//   - every separator byte (space, \t \n \v \f \r) becomes ' '
+//   - all other bytes, including non-ASCII, are copied unchanged
+// Tokenizing the canonical form yields exactly the words the scalar Tokenizer
+// (and the original ispunct/tolower pipeline) produces for the raw buffer.
+class DLL_so_EXPORT TextNormalizer {
+public:
+    enum class Kernel {
+        SCALAR,
+        SSE42,
+        AVX2
+    };
+
+    // Normalizes `size` bytes from `in` into `out` using the best kernel the CPU
+    // supports. `out` must hold at least `size` bytes and must not overlap `in`.
+    // Returns the number of bytes written.
+    static size_t normalize(const char* in, size_t size, char* out);
+
+    // Same as normalize() but forces a specific kernel. Requesting a kernel the
+    // CPU does not support falls back to SCALAR.
+    static size_t normalizeWith(Kernel kernel, const char* in, size_t size, char* out);
+
+    // Kernel selected by runtime CPU dispatch (resolved once per process).
+    static Kernel activeKernel();
+    static bool isSupported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+};
+
+#endif // TEXT_NORMALIZER_H
@@ -2,13 +2,31 @@
 #define THREAD_POOL_H
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <type_traits>
+#include <utility>
+#include "WorkStealingDeque.h"
 
+// Work-stealing thread pool. Each worker owns a Chase–Lev deque: tasks enqueued
+// from a worker go to the bottom of its own deque and are popped LIFO without
+// locks, while idle workers steal FIFO from the top of random victims' deques.
+// Tasks enqueued from outside the pool go to a shared injection queue. Workers
+// with nothing to run park on a condition variable and are woken only when
+// there are parked workers and new work arrives.
+// The pool starts minThreads workers and adds more, up to maxThreads, while
+// queued tasks outnumber workers. shutdown() runs every queued task first.
+//
+// enqueueTask() is fire-and-forget: an exception escaping the task is logged.
+// submit(), TaskGroup and parallel_for() hand exceptions back to the waiter.
 class ThreadPool {
 public:
     ThreadPool(size_t minThreads, size_t maxThreads);
@@ -19,25 +37,171 @@ public:
     size_t getActiveThreads() const;
     size_t getTasksInQueue() const;
 
+    // Runs fn() on the pool. The future yields its result or rethrows its
+    // exception; it reports broken_promise if the pool was already shut down.
+    template <typename Fn>
+    auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+        using Result = std::invoke_result_t<std::decay_t<Fn>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        std::future<Result> result = task->get_future();
+        enqueueTask([task]() { (*task)(); });
+        return result;
+    }
+
+    // Calls fn(chunkBegin, chunkEnd) over [begin, end) in chunks of `grain`
+    // indices and returns when all chunks are done. The calling thread runs
+    // chunks too. The first exception thrown by any chunk is rethrown here.
+    template <typename Fn>
+    void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn);
+
+    // Runs one queued task on the calling thread, if there is one. Lets a thread
+    // that waits for pool work help instead of blocking a worker slot.
+    bool runPendingTask();
+
 private:
+    friend class TaskGroup;
+    using Task = std::function<void()>;
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Task*> deque;
+        uint64_t rngState = 0; // xorshift state for victim selection, owner only
+    };
+
+    static constexpr int STEAL_ROUNDS_BEFORE_PARK = 2;
+
+    bool tryEnqueue(const std::function<void()>& task); // False if the pool no longer accepts work
     void addThread();
+    void addThreadLocked();
     void adjustThreadPoolSize();
-    void workerLoop();
+    void workerLoop(size_t index);
+
+    Task* findTask(size_t index);
+    Task* popInjected();
+    void wakeWorker();
+    void runTask(Task* task);
 
     size_t minThreadsCount;
     size_t maxThreadsCount;
 
     std::vector<std::thread> workerThreads;
-    std::queue<std::function<void()>> taskQueue;
+    std::vector<std::unique_ptr<Worker>> workers; // maxThreadsCount slots, filled as threads start
+    std::atomic<size_t> workerCount;              // Published slots in `workers`
+
+    std::deque<Task*> injectionQueue; // Tasks enqueued from non-worker threads
+    mutable std::mutex injectionMutex;
+    std::atomic<size_t> injectedCount; // Lets workers skip the lock when the queue is empty
 
-    mutable std::mutex queueMutex;
     mutable std::mutex threadsMutex;
 
-    std::condition_variable condition;
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    std::atomic<size_t> parkedCount;
+    std::atomic<int64_t> pendingTasks; // Enqueued but not yet taken by a worker
 
     std::atomic<bool> stopFlag;
     std::atomic<bool> shuttingDownFlag;
     std::atomic<size_t> activeThreadsCount;
 };
 
-#endif // THREAD_POOL_H
\ No newline at end of file
+// A batch of tasks on a ThreadPool that can be waited for as a unit.
+// wait() rethrows the first exception any task threw. While waiting, the
+// caller runs queued pool tasks until none are left, so a task may itself
+// create and wait for a nested group without starving the pool; then it
+// sleeps until the group's last task finishes. The destructor waits as well but
+// swallows exceptions; call wait() to observe them.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& threadPool) : pool(threadPool), state(std::make_shared<State>()) {}
+    ~TaskGroup() {
+        try {
+            wait();
+        } catch (...) {
+        }
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template <typename Fn>
+    void run(Fn&& fn) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            ++state->remaining;
+        }
+        std::shared_ptr<State> shared = state;
+        std::function<void()> wrapped = [shared, task = std::decay_t<Fn>(std::forward<Fn>(fn))]() mutable {
+            std::exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            shared->finish(error);
+        };
+        if (!pool.tryEnqueue(wrapped)) {
+            wrapped(); // The pool is shutting down; run inline so wait() still returns
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (state->remaining > 0) {
+            lock.unlock();
+            bool ranTask = pool.runPendingTask();
+            lock.lock();
+            if (!ranTask) {
+                // Nothing queued: the rest of this group is running on other
+                // threads, and finish() wakes us once its last task is done.
+                state->condition.wait(lock, [this] { return state->remaining == 0; });
+            }
+        }
+        if (state->firstError) {
+            std::exception_ptr error = state->firstError;
+            state->firstError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t remaining = 0;
+        std::exception_ptr firstError;
+
+        void finish(std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error && !firstError) firstError = error;
+            if (--remaining == 0) condition.notify_all();
+        }
+    };
+
+    ThreadPool& pool;
+    std::shared_ptr<State> state; // Shared with queued tasks, which may still be signalling after wait() returns
+};
+
+template <typename Fn>
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn) {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+    if (end - begin <= grain) {
+        fn(begin, end);
+        return;
+    }
+    TaskGroup group(*this);
+    size_t chunkBegin = begin;
+    for (; end - chunkBegin > grain; chunkBegin += grain) {
+        size_t chunkEnd = chunkBegin + grain;
+        group.run([&fn, chunkBegin, chunkEnd]() { fn(chunkBegin, chunkEnd); });
+    }
+    std::exception_ptr callerError;
+    try {
+        fn(chunkBegin, end); // Last chunk on the calling thread
+    } catch (...) {
+        callerError = std::current_exception();
+    }
+    group.wait();
+    if (callerError) std::rethrow_exception(callerError);
+}
+
+#endif // THREAD_POOL_H
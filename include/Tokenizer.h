@@ -0,0 +1,115 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Byte classes used by the word tokenizer. The values reproduce the "C" locale
+// behaviour of std::isspace/std::ispunct/std::tolower that Mapper::map relied on,
+// so the table and the old istringstream pipeline produce identical words.
+enum class CharClass : unsigned char {
+    SEPARATOR,   // Whitespace: ends the current word
+    PUNCTUATION, // Dropped from the word, does not split it
+    LETTER,      // Kept as-is
+    UPPER        // Kept, folded to lowercase
+};
+
+struct CharClassTable {
+    CharClass cls[256];
+    unsigned char fold[256];
+};
+
+constexpr CharClassTable buildCharClassTable() {
+    CharClassTable table{};
+    for (int c = 0; c < 256; ++c) {
+        table.fold[c] = static_cast<unsigned char>(c);
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            table.cls[c] = CharClass::SEPARATOR;
+        } else if ((c >= '!' && c <= '/') || (c >= ':' && c <= '@') ||
+                   (c >= '[' && c <= '`') || (c >= '{' && c <= '~')) {
+            table.cls[c] = CharClass::PUNCTUATION;
+        } else if (c >= 'A' && c <= 'Z') {
+            table.cls[c] = CharClass::UPPER;
+            table.fold[c] = static_cast<unsigned char>(c + ('a' - 'A'));
+        } else {
+            table.cls[c] = CharClass::LETTER;
+        }
+    }
+    return table;
+}
+
+inline constexpr CharClassTable CHAR_CLASS_TABLE = buildCharClassTable();
+
+// Streaming word tokenizer over a raw byte buffer. Words that need no cleanup are
+// returned as views straight into the buffer; words containing punctuation or
+// uppercase letters are rewritten into a reusable scratch buffer, so no heap
+// allocation happens per word once the scratch has grown to the longest word.
+// A returned view stays valid until the next call to next() or reset().
+class Tokenizer {
+public:
+    Tokenizer() : pos(0) { scratch.reserve(64); }
+    explicit Tokenizer(std::string_view buffer) : input(buffer), pos(0) { scratch.reserve(64); }
+
+    void reset(std::string_view buffer) {
+        input = buffer;
+        pos = 0;
+    }
+
+    // Advances to the next non-empty word. Returns false once the buffer is exhausted.
+    bool next(std::string_view& token) {
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
+        const size_t size = input.size();
+
+        while (pos < size) {
+            while (pos < size && CHAR_CLASS_TABLE.cls[data[pos]] == CharClass::SEPARATOR) {
+                ++pos;
+            }
+            const size_t start = pos;
+            bool needsRewrite = false;
+            while (pos < size) {
+                CharClass cls = CHAR_CLASS_TABLE.cls[data[pos]];
+                if (cls == CharClass::SEPARATOR) break;
+                needsRewrite |= (cls == CharClass::PUNCTUATION || cls == CharClass::UPPER);
+                ++pos;
+            }
+            if (pos == start) break;
+
+            if (!needsRewrite) {
+                token = input.substr(start, pos - start);
+                return true;
+            }
+
+            scratch.clear();
+            for (size_t i = start; i < pos; ++i) {
+                unsigned char c = data[i];
+                if (CHAR_CLASS_TABLE.cls[c] != CharClass::PUNCTUATION) {
+                    scratch.push_back(static_cast<char>(CHAR_CLASS_TABLE.fold[c]));
+                }
+            }
+            if (!scratch.empty()) {
+                token = std::string_view(scratch);
+                return true;
+            }
+            // Word was punctuation only; keep scanning.
+        }
+        return false;
+    }
+
+    // Calls fn(std::string_view) for every word in the buffer.
+    template <typename Fn>
+    static void forEachWord(std::string_view buffer, Fn&& fn) {
+        Tokenizer tokenizer(buffer);
+        std::string_view token;
+        while (tokenizer.next(token)) {
+            fn(token);
+        }
+    }
+
+private:
+    std::string_view input;
+    size_t pos;
+    std::string scratch;
+};
+
+#endif // TOKENIZER_H
@@ -0,0 +1,109 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase–Lev work-stealing deque (Lê, Pop, Cohen, Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models", PPoPP 2013).
+// The owning thread pushes and pops at the bottom without locks; any other
+// thread may steal from the top with a single CAS. T must be trivially
+// copyable (the pool stores task pointers).
+// Buffers replaced by grow() are kept until destruction because a concurrent
+// thief may still be reading from them.
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t initialCapacity = 256)
+        : top(0), bottom(0) {
+        size_t capacity = 1;
+        while (capacity < initialCapacity) capacity *= 2;
+        buffers.push_back(std::make_unique<Buffer>(capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Buffer* current = buffer.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(current->capacity) - 1) {
+            current = grow(current, t, b);
+        }
+        current->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Returns false if the deque is empty.
+    bool pop(T& item) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* current = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = current->get(b);
+        if (t == b) {
+            // Last item: race thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Returns false if the deque is empty or the steal lost a race.
+    bool steal(T& item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        Buffer* current = buffer.load(std::memory_order_acquire);
+        item = current->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate; exact only when no other thread is operating on the deque.
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(size_t size) : capacity(size), mask(size - 1), slots(new std::atomic<T>[size]) {}
+
+        T get(int64_t index) const { return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { slots[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed); }
+
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, int64_t t, int64_t b) {
+        buffers.push_back(std::make_unique<Buffer>(old->capacity * 2));
+        Buffer* bigger = buffers.back().get();
+        for (int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Buffer*> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers; // Owner only
+};
+
+#endif // WORK_STEALING_DEQUE_H
@@ -0,0 +1,78 @@
+#ifndef WORKER_EXECUTOR_H
+#define WORKER_EXECUTOR_H
+
+#include "FrameProtocol.h"
+#include "ProcessOrchestrator.h"
+#include "TaskCounters.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Runs map and reduce tasks inside a long-lived worker process instead of
+// forking `mapreduce mapper|reducer` for each one. The mapper and reducer
+// libraries are loaded and the configuration is read once; each task then
+// runs on a resident ThreadPool with `slots` threads, so up to `slots` tasks
+// run at once and the rest queue.
+//
+// Tasks take the same arguments as the command-line modes:
+//   map    <tempDir> <mapperId> <R> [minThreads maxThreads] <logPath> <input...>
+//   reduce <outputDir> <tempDir> <reducerId> [minThreads maxThreads] <logPath> [numMappers]
+// The log path is ignored: all tasks log to the worker's own log file.
+// Worker limits (worker_cpu_seconds / worker_memory_bytes) are per process
+// and are not applied in-process.
+class WorkerExecutor {
+public:
+    using StartedCallback = std::function<void(uint32_t requestId)>;
+    using FinishedCallback = std::function<void(uint32_t requestId, const TaskResult& result)>;
+
+    // `orchestrator` carries the loaded configuration; every task runs on its
+    // own copy, so per-task state (range boundaries) is never shared.
+    // Callbacks run on pool threads and must be thread-safe.
+    WorkerExecutor(const ProcessOrchestratorDLL& orchestrator, size_t slots, StartedCallback onStarted,
+                   FinishedCallback onFinished);
+    ~WorkerExecutor();
+
+    WorkerExecutor(const WorkerExecutor&) = delete;
+    WorkerExecutor& operator=(const WorkerExecutor&) = delete;
+
+    // Queues a task. onFinished is called exactly once for it, also when the
+    // arguments are malformed or the task throws.
+    void submit(uint32_t requestId, TaskAssignment task);
+
+    // Waits for every queued and running task, then stops the pool.
+    void drain();
+
+    size_t slotCount() const { return slots; }
+    size_t runningCount() const { return running.load(); }
+
+    // Progress of every started, unfinished task, for heartbeats.
+    std::vector<std::pair<uint32_t, TaskProgress>> progress() const;
+
+    // Runs one task on the calling thread. Returns false with `error` set
+    // when the arguments are malformed or the task fails.
+    static bool runTask(ProcessOrchestratorDLL& orchestrator, const TaskAssignment& task, std::string& error);
+
+    // What a successful task published: the mapper's partition manifest or
+    // the reducer's output file. Empty if the arguments do not say.
+    static std::string publishedPath(const TaskAssignment& task);
+
+private:
+    ProcessOrchestratorDLL base;
+    size_t slots;
+    StartedCallback onStarted;
+    FinishedCallback onFinished;
+    std::atomic<size_t> running{0};
+    mutable std::mutex countersMutex;
+    std::map<uint32_t, std::shared_ptr<TaskCounters>> counters; // Started tasks, by request ID
+    ThreadPool pool;
+    bool drained = false;
+};
+
+#endif // WORKER_EXECUTOR_H
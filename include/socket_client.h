@@ -2,25 +2,35 @@
 #define SOCKET_CLIENT_H
 
 #include "socket_interface.h"
+#include "FrameProtocol.h"
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <string_view>
 
 class SocketClient : public SocketInterface
 {
 private:
     int port;
-    int server_fd = -1; // Server socket file descriptor
-    int client_fd = -1; // Client socket file descriptor
+    std::string host;
+    int client_fd = -1; // Connection to the controller
+    FrameReader reader;
+    std::mutex send_mutex; // Tasks running in parallel report on the same connection
 
 public:
-    SocketClient(int port);
+    SocketClient(int port, const std::string &host = "127.0.0.1");
     ~SocketClient();
 
+    // Connects to the controller, retrying for a few seconds so workers may start first
     bool initialize() override;
-    std::string receive(); // Custom receive function returning string
+    // Blocks for the next frame; false once the controller disconnects.
+    // The payload is valid until the next call.
+    bool receive(Frame &frame);
     void run() override;   // Not used for now, but must be implemented
     void cleanup() override;
 
-    bool transmit(const std::string &message);
+    // Sends one frame; safe to call from several threads
+    bool transmit(FrameType type, uint32_t request_id, std::string_view payload = {});
 };
 
 #endif
@@ -12,6 +12,7 @@
 #include <sstream>
 #include <algorithm>
 #include <stdexcept>
+#include <cctype>
 
 bool ConfigManager::loadFromFile(const std::string& configFilePath) {
     std::ifstream configFile(configFilePath);
@@ -70,6 +71,140 @@ std::optional<size_t> ConfigManager::getReducerMaxThreads() const {
     return it != config.end() ? parseSizeT(it->second) : std::nullopt;
 }
 
+std::optional<bool> ConfigManager::getCombinerEnabled() const {
+    auto it = config.find("combiner_enabled");
+    return it != config.end() ? parseBool(it->second) : std::nullopt;
+}
+
+std::optional<size_t> ConfigManager::getCombinerMemoryBudget() const {
+    auto it = config.find("combiner_memory_budget_bytes");
+    return it != config.end() ? parseSizeT(it->second) : std::nullopt;
+}
+
+std::optional<size_t> ConfigManager::getMapperSpillBudget() const {
+    auto it = config.find("mapper_spill_budget_bytes");
+    return it != config.end() ? parseSizeT(it->second) : std::nullopt;
+}
+
+std::optional<uint64_t> ConfigManager::getPartitionHashSeed() const {
+    auto it = config.find("partition_hash_seed");
+    if (it == config.end()) return std::nullopt;
+    try {
+        return static_cast<uint64_t>(std::stoull(it->second, nullptr, 0)); // Decimal or 0x-prefixed hex
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<PartitionScheme> ConfigManager::getPartitionScheme() const {
+    auto it = config.find("partitioner");
+    if (it == config.end()) return std::nullopt;
+    std::string lower = it->second;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "hash") return PartitionScheme::HASH;
+    if (lower == "range") return PartitionScheme::RANGE;
+    return std::nullopt;
+}
+
+std::optional<size_t> ConfigManager::getPartitionSampleBytes() const {
+    auto it = config.find("partition_sample_bytes");
+    return it != config.end() ? parseSizeT(it->second) : std::nullopt;
+}
+
+std::optional<size_t> ConfigManager::getInputSplitSize() const {
+    auto it = config.find("input_split_size_bytes");
+    return it != config.end() ? parseSizeT(it->second) : std::nullopt;
+}
+
+std::optional<IntermediateEncoding> ConfigManager::getIntermediateEncoding() const {
+    auto it = config.find("intermediate_encoding");
+    if (it == config.end()) return std::nullopt;
+    std::string lower = it->second;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "binary") return IntermediateEncoding::BINARY;
+    if (lower == "text") return IntermediateEncoding::TEXT;
+    return std::nullopt;
+}
+
+std::optional<IntermediateLayout> ConfigManager::getIntermediateLayout() const {
+    auto it = config.find("intermediate_layout");
+    if (it == config.end()) return std::nullopt;
+    std::string lower = it->second;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "per_reducer") return IntermediateLayout::PER_REDUCER;
+    if (lower == "indexed") return IntermediateLayout::INDEXED;
+    return std::nullopt;
+}
+
+std::optional<bool> ConfigManager::getLogAsync() const {
+    auto it = config.find("log_async");
+    return it != config.end() ? parseBool(it->second) : std::nullopt;
+}
+
+std::optional<Logger::Level> ConfigManager::getLogLevel() const {
+    auto it = config.find("log_level");
+    if (it == config.end()) return std::nullopt;
+    std::string lower = it->second;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "debug") return Logger::Level::DEBUG;
+    if (lower == "info") return Logger::Level::INFO;
+    if (lower == "warning") return Logger::Level::WARNING;
+    if (lower == "error") return Logger::Level::ERROR;
+    return std::nullopt;
+}
+
+std::optional<bool> ConfigManager::getLogConsole() const {
+    auto it = config.find("log_console");
+    return it != config.end() ? parseBool(it->second) : std::nullopt;
+}
+
+std::optional<Logger::OutputFormat> ConfigManager::getLogFormat() const {
+    auto it = config.find("log_format");
+    if (it == config.end()) return std::nullopt;
+    std::string lower = it->second;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "text") return Logger::OutputFormat::TEXT;
+    if (lower == "binary") return Logger::OutputFormat::BINARY;
+    return std::nullopt;
+}
+
+std::optional<ExecutionMode> ConfigManager::getExecutionMode() const {
+    auto it = config.find("execution_mode");
+    if (it == config.end()) return std::nullopt;
+    std::string lower = it->second;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "threads") return ExecutionMode::THREADS;
+    if (lower == "processes") return ExecutionMode::PROCESSES;
+    return std::nullopt;
+}
+
+std::optional<uint64_t> ConfigManager::getWorkerCpuSeconds() const {
+    auto it = config.find("worker_cpu_seconds");
+    return it != config.end() ? parseSizeT(it->second) : std::nullopt;
+}
+
+std::optional<uint64_t> ConfigManager::getWorkerMemoryBytes() const {
+    auto it = config.find("worker_memory_bytes");
+    return it != config.end() ? parseSizeT(it->second) : std::nullopt;
+}
+
+std::optional<std::string> ConfigManager::getPluginLibrary() const {
+    auto it = config.find("plugin_library");
+    return it != config.end() ? std::optional<std::string>(it->second) : std::nullopt;
+}
+
 std::string ConfigManager::getIntermediateFileFormat() const {
     auto it = config.find("intermediate_file_format");
     return it != config.end() ? it->second : "temp/partition_{mapper_id}_{reducer_id}.txt";
@@ -104,6 +239,70 @@ void ConfigManager::setOutputFileFormat(const std::string& format) {
     config["output_file_format"] = format;
 }
 
+void ConfigManager::setCombinerEnabled(bool enabled) {
+    config["combiner_enabled"] = enabled ? "true" : "false";
+}
+
+void ConfigManager::setCombinerMemoryBudget(size_t bytes) {
+    config["combiner_memory_budget_bytes"] = std::to_string(bytes);
+}
+
+void ConfigManager::setInputSplitSize(size_t bytes) {
+    config["input_split_size_bytes"] = std::to_string(bytes);
+}
+
+void ConfigManager::setMapperSpillBudget(size_t bytes) {
+    config["mapper_spill_budget_bytes"] = std::to_string(bytes);
+}
+
+void ConfigManager::setPartitionHashSeed(uint64_t seed) {
+    config["partition_hash_seed"] = std::to_string(seed);
+}
+
+void ConfigManager::setPartitionScheme(PartitionScheme scheme) {
+    config["partitioner"] = scheme == PartitionScheme::RANGE ? "range" : "hash";
+}
+
+void ConfigManager::setPartitionSampleBytes(size_t bytes) {
+    config["partition_sample_bytes"] = std::to_string(bytes);
+}
+
+void ConfigManager::setIntermediateEncoding(IntermediateEncoding encoding) {
+    config["intermediate_encoding"] = encoding == IntermediateEncoding::TEXT ? "text" : "binary";
+}
+
+void ConfigManager::setIntermediateLayout(IntermediateLayout layout) {
+    config["intermediate_layout"] = layout == IntermediateLayout::INDEXED ? "indexed" : "per_reducer";
+}
+
+void ConfigManager::setLogAsync(bool enabled) {
+    config["log_async"] = enabled ? "true" : "false";
+}
+
+void ConfigManager::setLogConsole(bool enabled) {
+    config["log_console"] = enabled ? "true" : "false";
+}
+
+void ConfigManager::setLogFormat(Logger::OutputFormat format) {
+    config["log_format"] = format == Logger::OutputFormat::BINARY ? "binary" : "text";
+}
+
+void ConfigManager::setExecutionMode(ExecutionMode mode) {
+    config["execution_mode"] = mode == ExecutionMode::PROCESSES ? "processes" : "threads";
+}
+
+void ConfigManager::setWorkerCpuSeconds(uint64_t seconds) {
+    config["worker_cpu_seconds"] = std::to_string(seconds);
+}
+
+void ConfigManager::setWorkerMemoryBytes(uint64_t bytes) {
+    config["worker_memory_bytes"] = std::to_string(bytes);
+}
+
+void ConfigManager::setPluginLibrary(const std::string& path) {
+    config["plugin_library"] = path;
+}
+
 // Helper to trim whitespace from a string
 std::string ConfigManager::trim(const std::string& str) {
     const auto strBegin = str.find_first_not_of(" \t");
@@ -126,3 +325,14 @@ std::optional<size_t> ConfigManager::parseSizeT(const std::string& value) {
         return std::nullopt;
     }
 }
+
+// Helper to parse true/false, yes/no, on/off, 1/0
+std::optional<bool> ConfigManager::parseBool(const std::string& value) {
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) -> unsigned char {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
+    });
+    if (lower == "true" || lower == "yes" || lower == "on" || lower == "1") return true;
+    if (lower == "false" || lower == "no" || lower == "off" || lower == "0") return false;
+    return std::nullopt;
+}
@@ -0,0 +1,50 @@
+// Example map/reduce plugin for the C ABI in PluginABI.h. Built by go.sh as
+// FrequentWordsPlugin.so; enable it with plugin_library=./FrequentWordsPlugin.so
+// in config.txt. Map: lower-cased ASCII words of at least MIN_WORD_LENGTH
+// letters. Reduce: keeps words seen at least MIN_COUNT times.
+
+#include "../include/PluginABI.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace {
+
+constexpr size_t MIN_WORD_LENGTH = 3;
+constexpr int64_t MIN_COUNT = 2;
+constexpr size_t MAX_WORD_LENGTH = 256; // Longer runs of letters are cut
+
+int mapBatch(const char* data, size_t size, MrOutput* out) {
+    char word[MAX_WORD_LENGTH];
+    size_t length = 0;
+    for (size_t i = 0; i <= size; ++i) {
+        unsigned char c = i < size ? static_cast<unsigned char>(data[i]) : ' ';
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            if (length < MAX_WORD_LENGTH) word[length++] = static_cast<char>(c | 0x20);
+            continue;
+        }
+        if (length >= MIN_WORD_LENGTH) {
+            int status = out->emit(out->host, word, static_cast<uint32_t>(length), 1);
+            if (status != 0) return status;
+        }
+        length = 0;
+    }
+    return 0;
+}
+
+int reduceBatch(const MrRecord* records, size_t count, MrOutput* out) {
+    for (size_t i = 0; i < count; ++i) {
+        if (records[i].value < MIN_COUNT) continue;
+        int status = out->emit(out->host, records[i].key, records[i].key_length, records[i].value);
+        if (status != 0) return status;
+    }
+    return 0;
+}
+
+const MrPlugin PLUGIN = {MR_PLUGIN_ABI_VERSION, "frequent-words", &mapBatch, &reduceBatch};
+
+} // namespace
+
+extern "C" MR_PLUGIN_EXPORT const MrPlugin* mr_plugin_entry(uint32_t hostAbiVersion) {
+    return hostAbiVersion == MR_PLUGIN_ABI_VERSION ? &PLUGIN : nullptr;
+}
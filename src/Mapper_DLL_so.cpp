@@ -1,11 +1,17 @@
 #ifdef _WIN32
     #include "..\include\Mapper_DLL_so.h"
     #include "..\include\Partitioner.h"
+    #include "..\include\TextNormalizer.h"
+    #include "..\include\MappedFile.h"
+    #include "..\include\IntermediateFormat.h"
     #include "..\include\Logger.h"
     #include "..\include\ERROR_Handler.h"
 #elif defined(__unix__) || defined(__APPLE__) && defined(__MACH__)
     #include "../include/Mapper_DLL_so.h"
     #include "../include/Partitioner.h"
+    #include "../include/TextNormalizer.h"
+    #include "../include/MappedFile.h"
+    #include "../include/IntermediateFormat.h"
     #include "../include/Logger.h"
     #include "../include/ERROR_Handler.h"
 #else
@@ -18,50 +24,166 @@
 #include <string>
 #include <unordered_map>
 #include <algorithm>
+#include <limits>
 #include <filesystem> // Required for creating directories if tempDir doesn't exist
 
 namespace fs = std::filesystem;
 
+// Below this size the extra normalization pass costs more than it saves
+static constexpr size_t SIMD_MIN_BUFFER_SIZE = 64;
+
 // Constructor for the Mapper class
 Mapper::Mapper(Logger& loggerRef, ErrorHandler& errorHandlerRef)
     : logger(loggerRef), errorHandler(errorHandlerRef) {
-    this->logger.log("[DEBUG] Mapper instance created.");
+    LOG_DEBUG("Mapper instance created.");
 }
 
 // Destructor for the Mapper class
 Mapper::~Mapper() {
-    this->logger.log("[DEBUG] Mapper instance destroyed.");
+    LOG_DEBUG("Mapper instance destroyed.");
 }
 
 // Perform the map operation on a single line of input
-void Mapper::map(const std::string& documentId, const std::string& line, std::vector<std::pair<std::string, int>>& intermediateData) {
+void Mapper::map(const std::string& documentId, const std::string& line, KeyValueBuffer& intermediateData) {
     if (line.empty()) return;
-    
-    // Use documentId to avoid unused parameter warning
-    if(documentId.empty() && line.empty()) return;
-
-    std::istringstream iss(line);
-    std::string word;
-
-    while (iss >> word) {
-        // Remove punctuation and convert to lowercase
-        word.erase(std::remove_if(word.begin(), word.end(), [](unsigned char c) {
-            return std::ispunct(c);
-        }), word.end());
-        
-        // Fix for warning: conversion from int to char
-        std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) -> unsigned char {
-            return static_cast<unsigned char>(std::tolower(static_cast<unsigned int>(c)));
-        });
-
-        if (!word.empty()) {
-            intermediateData.push_back({word, 1});
+    mapBuffer(documentId, line, intermediateData);
+}
+
+// Tokenize a raw buffer and emit {word, 1} for every word
+void Mapper::mapBuffer(const std::string& documentId, std::string_view buffer, KeyValueBuffer& intermediateData) {
+    // documentId is part of the map contract but word count does not key on it
+    (void)documentId;
+    if (buffer.empty()) return;
+    intermediateData.internKeys(partitionSeed);
+    if (plugin && plugin->hasMap()) {
+        mapWithPlugin(buffer, intermediateData);
+        return;
+    }
+
+    if (buffer.size() >= SIMD_MIN_BUFFER_SIZE && TextNormalizer::activeKernel() != TextNormalizer::Kernel::SCALAR) {
+        if (normalized.size() < buffer.size()) normalized.resize(buffer.size());
+        size_t length = TextNormalizer::normalize(buffer.data(), buffer.size(), normalized.data());
+        tokenizer.reset(std::string_view(normalized.data(), length));
+    } else {
+        tokenizer.reset(buffer);
+    }
+
+    std::string_view word;
+    uint64_t words = 0;
+    if (combinerEnabled) {
+        while (tokenizer.next(word)) {
+            combiner.add(word, 1, intermediateData);
+            ++words;
+        }
+    } else {
+        while (tokenizer.next(word)) {
+            intermediateData.add(word, 1);
+            ++words;
         }
     }
+    if (progress != nullptr) progress->add(progress->records, words);
+}
+
+// One map_batch call per buffer; the emitted records leave the plugin's arena
+// as the same {key, count} records the tokenizer path produces
+void Mapper::mapWithPlugin(std::string_view buffer, KeyValueBuffer& intermediateData) {
+    pluginOutput.clear();
+    if (!plugin->mapBatch(buffer, pluginOutput)) {
+        if (!pluginError) {
+            errorHandler.reportError("Mapper: Plugin " + plugin->name() + " failed to map a " + std::to_string(buffer.size()) +
+                                     "-byte batch.", false);
+        }
+        pluginError = true;
+        return;
+    }
+    for (size_t i = 0; i < pluginOutput.size(); ++i) {
+        int count = static_cast<int>(std::clamp<int64_t>(pluginOutput.value(i), std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+        if (combinerEnabled) {
+            combiner.add(pluginOutput.key(i), count, intermediateData);
+        } else {
+            intermediateData.add(pluginOutput.key(i), count);
+        }
+    }
+    if (progress != nullptr) progress->add(progress->records, pluginOutput.size());
+}
+
+// Map a whole input file through a read-only memory mapping
+bool Mapper::mapFile(const std::string& filePath, KeyValueBuffer& intermediateData) {
+    return mapSplit(InputSplit{filePath, 0, MappedFile::WHOLE_FILE}, intermediateData);
+}
+
+// Map one line-aligned byte range of an input file
+bool Mapper::mapSplit(const InputSplit& split, KeyValueBuffer& intermediateData) {
+    MappedFile input;
+    if (!input.open(split.filePath, split.offset, split.length)) {
+        return false;
+    }
+    for (std::string_view block : input.blocks(MAP_BLOCK_SIZE)) {
+        mapBuffer(split.filePath, block, intermediateData);
+        if (progress != nullptr) progress->add(progress->done, block.size());
+        if (spillMemoryBudget > 0 && !spillTempDir.empty()) {
+            spillIfOverBudget(intermediateData);
+        }
+    }
+    return !pluginError;
+}
+
+// Configure where budget-triggered spills are written
+void Mapper::setSpillTarget(const std::string& tempDir, int numReducers,
+                            const std::string& partitionFilePrefix, const std::string& partitionFileSuffix) {
+    spillTempDir = tempDir;
+    spillNumReducers = numReducers;
+    spillPrefix = partitionFilePrefix;
+    spillSuffix = partitionFileSuffix;
+}
+
+// Export the buffered intermediate data as one sorted run per partition once it
+// outgrows the spill budget, then reuse the buffer's arena for the next records.
+void Mapper::spillIfOverBudget(KeyValueBuffer& intermediateData) {
+    size_t bufferedBytes = intermediateData.memoryUsed();
+    if (bufferedBytes <= spillMemoryBudget) return;
+
+    // A spill keeps the interned keys, and their IDs the combiner holds, unless
+    // they fill half the budget on their own; then the combiner is flushed into
+    // this spill so the dictionary can start over.
+    const KeyDictionary* keys = intermediateData.keyDictionary();
+    const bool dropKeys = keys != nullptr && keys->memoryUsed() > spillMemoryBudget / 2;
+    if (dropKeys && combinerEnabled) combiner.flush(intermediateData);
+
+    ++spillCount;
+    LOG_INFO("Mapper: Spill {}: {} records ({} bytes) exceeded the {} byte budget.", spillCount, intermediateData.size(),
+             bufferedBytes, spillMemoryBudget);
+    if (!exportPartitionedData(spillTempDir, intermediateData, spillNumReducers, spillPrefix, spillSuffix)) {
+        errorHandler.reportError("Mapper: Spill failed; keeping records in memory.", false);
+        return;
+    }
+    if (dropKeys) {
+        intermediateData.clearKeys();
+    } else {
+        intermediateData.clear();
+    }
+}
+
+// Enable in-mapper pre-aggregation of word counts
+void Mapper::enableCombiner(size_t memoryBudgetBytes) {
+    combiner.setMemoryBudget(memoryBudgetBytes);
+    combinerEnabled = true;
+    LOG_INFO("Mapper: Combiner enabled with memory budget of {} bytes.", memoryBudgetBytes);
+}
+
+// Flush remaining combiner aggregates into the intermediate data
+void Mapper::flushCombiner(KeyValueBuffer& intermediateData) {
+    if (!combinerEnabled) return;
+    combiner.flush(intermediateData);
+
+    const Combiner::Stats& stats = combiner.getStats();
+    double ratio = stats.outputRecords > 0 ? static_cast<double>(stats.inputRecords) / static_cast<double>(stats.outputRecords) : 0.0;
+    LOG_INFO("Mapper: Combiner reduced {} records to {} ({}x) across {} flush(es).", stats.inputRecords, stats.outputRecords,
+             ratio, stats.flushes);
 }
 
 // Export mapped data to a file
-bool Mapper::exportMappedData(const std::string& filePath, const std::vector<std::pair<std::string, int>>& mappedData) {
+bool Mapper::exportMappedData(const std::string& filePath, const KeyValueBuffer& mappedData) {
     // Ensure directory for filePath exists
     fs::path p(filePath);
     if (p.has_parent_path()) {
@@ -80,8 +202,8 @@ bool Mapper::exportMappedData(const std::string& filePath, const std::vector<std
         return false;
     }
 
-    for (const auto& pair : mappedData) {
-        outFile << pair.first << "\t" << pair.second << "\n";
+    for (const auto& record : mappedData) {
+        outFile << record.key() << "\t" << record.value << "\n";
     }
 
     outFile.close();
@@ -95,7 +217,7 @@ bool Mapper::exportMappedData(const std::string& filePath, const std::vector<std
 
 // Export partitioned data into temporary files for reducers
 bool Mapper::exportPartitionedData(const std::string& tempDir, 
-                                  const std::vector<std::pair<std::string, int>>& mappedData, 
+                                  const KeyValueBuffer& mappedData, 
                                   int numReducers,
                                   const std::string& partitionFilePrefix,
                                   const std::string& partitionFileSuffix) {
@@ -112,7 +234,27 @@ bool Mapper::exportPartitionedData(const std::string& tempDir,
         }
     }
 
-    Partitioner partitioner(numReducers);
+    // Bucket every record in one batch call; both partitioners return buckets in [0, numReducers)
+    std::vector<uint32_t> recordBuckets;
+    if (!rangePartitioner.empty()) {
+        if (rangePartitioner.getNumReducers() != numReducers) {
+            errorHandler.reportError("Mapper: Range partitioner was built for " + std::to_string(rangePartitioner.getNumReducers()) +
+                                     " reducers, not " + std::to_string(numReducers), false);
+            return false;
+        }
+        rangePartitioner.getReducerBuckets(mappedData, recordBuckets);
+    } else {
+        Partitioner partitioner(numReducers, partitionSeed);
+        partitioner.getReducerBuckets(mappedData, recordBuckets);
+    }
+    if (intermediateEncoding == IntermediateEncoding::BINARY) {
+        return exportBinaryPartitions(tempDir, mappedData, recordBuckets, numReducers, partitionFilePrefix, partitionFileSuffix);
+    }
+    if (!indexedSpillPath.empty()) {
+        errorHandler.reportError("Mapper: An indexed spill file requires binary intermediate encoding.", false);
+        return false;
+    }
+
     std::vector<std::ofstream> reducerFiles(numReducers); // Use vector instead of map for direct indexing
 
     // Open a file for each reducer
@@ -134,14 +276,12 @@ bool Mapper::exportPartitionedData(const std::string& tempDir,
     }
 
     // Write mapped data to the appropriate partition file
-    for (const auto& pair : mappedData) {
-        int bucket = partitioner.getReducerBucket(pair.first);
-        if (bucket >= 0 && bucket < numReducers) {
-            reducerFiles[bucket] << pair.first << "\t" << pair.second << "\n";
-        } else {
-            // This case should ideally not happen if Partitioner is correct
-            errorHandler.reportError("Mapper: Invalid bucket " + std::to_string(bucket) + " for key '" + pair.first + "'", false);
-        }
+    size_t bytesWritten = 0;
+    for (size_t i = 0; i < mappedData.size(); ++i) {
+        const auto& record = mappedData[i];
+        std::string count = std::to_string(record.value);
+        reducerFiles[recordBuckets[i]] << record.key() << "\t" << count << "\n";
+        bytesWritten += record.key().size() + count.size() + 2;
     }
 
     // Close all files
@@ -158,7 +298,101 @@ bool Mapper::exportPartitionedData(const std::string& tempDir,
     }
     
     if(allClosedSuccessfully) {
-        logger.log("Successfully exported partitioned data to " + tempDir);
+        logger.log("Successfully exported partitioned data to " + tempDir + " (" + std::to_string(mappedData.size()) +
+                   " records, " + std::to_string(bytesWritten) + " intermediate bytes)");
     }
     return allClosedSuccessfully;
-}
\ No newline at end of file
+}
+
+// Builds one key-sorted binary segment per reducer in memory and appends each with
+// a single write. Every partition file receives a segment, even an empty one, so
+// reducers can tell "no keys" from "mapper never ran". With an indexed spill file,
+// all segments go to that one file instead and only non-empty ones are indexed.
+// Interned keys are sorted by their rank in the dictionary, and a segment whose
+// keys repeat on average stores each key once in a dictionary.
+bool Mapper::exportBinaryPartitions(const std::string& tempDir,
+                                    const KeyValueBuffer& mappedData,
+                                    const std::vector<uint32_t>& recordBuckets,
+                                    int numReducers,
+                                    const std::string& partitionFilePrefix,
+                                    const std::string& partitionFileSuffix) {
+    std::vector<std::vector<size_t>> buckets(numReducers);
+    for (size_t i = 0; i < mappedData.size(); ++i) {
+        buckets[recordBuckets[i]].push_back(i);
+    }
+
+    // Key order of interned keys, computed once per distinct key instead of per comparison
+    std::vector<uint32_t> keyRank;
+    if (const KeyDictionary* keys = mappedData.keyDictionary()) {
+        std::vector<uint32_t> sortedIds = keys->sortedIds();
+        keyRank.resize(sortedIds.size());
+        for (uint32_t rank = 0; rank < sortedIds.size(); ++rank) keyRank[sortedIds[rank]] = rank;
+    }
+
+    const bool indexed = !indexedSpillPath.empty();
+    const size_t indexedBefore = spillIndex.size(); // A failed export is dropped from the index
+    IntermediateFormat::Appender indexedFile;
+    std::string error;
+    if (indexed && !indexedFile.open(indexedSpillPath, error)) {
+        errorHandler.reportError("Mapper: Could not open indexed spill file: " + error, false);
+        return false;
+    }
+
+    size_t bytesWritten = 0;
+    bool allWritten = true;
+    for (int i = 0; i < numReducers; ++i) {
+        // Each segment is a key-sorted run, so reducers can merge instead of sort
+        std::vector<size_t>& bucket = buckets[i];
+        size_t distinctKeys = bucket.empty() ? 0 : 1;
+        if (!keyRank.empty()) {
+            std::sort(bucket.begin(), bucket.end(),
+                      [&](size_t a, size_t b) { return keyRank[mappedData.keyId(a)] < keyRank[mappedData.keyId(b)]; });
+            for (size_t r = 1; r < bucket.size(); ++r) distinctKeys += mappedData.keyId(bucket[r]) != mappedData.keyId(bucket[r - 1]);
+        } else {
+            std::sort(bucket.begin(), bucket.end(), [&](size_t a, size_t b) { return mappedData[a].key() < mappedData[b].key(); });
+            for (size_t r = 1; r < bucket.size(); ++r) distinctKeys += mappedData[bucket[r]].key() != mappedData[bucket[r - 1]].key();
+        }
+        uint16_t flags = IntermediateFormat::FLAG_SORTED;
+        if (!bucket.empty() && bucket.size() >= 2 * distinctKeys) flags |= IntermediateFormat::FLAG_DICTIONARY;
+        IntermediateFormat::Writer writer(IntermediateFormat::DEFAULT_BLOCK_SIZE, flags);
+        for (size_t index : bucket) {
+            writer.add(mappedData[index].key(), mappedData[index].value);
+        }
+        std::vector<size_t>().swap(bucket);
+
+        if (indexed) {
+            if (writer.recordCount() == 0) continue;
+            const std::string& segment = writer.finish();
+            uint64_t offset = indexedFile.offset();
+            if (!indexedFile.append(segment, error)) {
+                errorHandler.reportError("Mapper: Could not write segment for reducer " + std::to_string(i) + ": " + error, false);
+                allWritten = false;
+                break;
+            }
+            spillIndex.push_back(SpillExtent{i, offset, segment.size()});
+            bytesWritten += segment.size();
+            continue;
+        }
+
+        fs::path partitionFilePath = fs::path(tempDir) / (partitionFilePrefix + std::to_string(i) + partitionFileSuffix);
+        const std::string& segment = writer.finish();
+        if (!IntermediateFormat::appendToFile(partitionFilePath.string(), segment, error)) {
+            errorHandler.reportError("Mapper: Could not write partition file for reducer " + std::to_string(i) + ": " + error, false);
+            allWritten = false;
+            continue;
+        }
+        bytesWritten += segment.size();
+    }
+    if (indexed && !indexedFile.close(error)) {
+        errorHandler.reportError("Mapper: Could not close indexed spill file: " + error, false);
+        allWritten = false;
+    }
+    if (indexed && !allWritten) spillIndex.resize(indexedBefore);
+
+    if (allWritten) {
+        logger.log("Successfully exported partitioned data to " + (indexed ? indexedSpillPath : tempDir) + " (" +
+                   std::to_string(mappedData.size()) + " records, " + std::to_string(bytesWritten) + " intermediate bytes, binary" +
+                   (indexed ? ", indexed)" : ")"));
+    }
+    return allWritten;
+}
@@ -5,7 +5,12 @@
     #include "..\include\ThreadPool.h"
     #include "..\include\FileHandler.h"
     #include "..\include\Mapper_DLL_so.h"
+    #include "..\include\Partitioner.h"
     #include "..\include\Reducer_DLL_so.h"
+    #include "..\include\ReducerOutputMerger.h"
+    #include "..\include\ProcessLauncher.h"
+    #include "..\include\SortedRunMerger.h"
+    #include "..\include\MapReducePlugin.h"
 #elif defined(__unix__) || defined(__APPLE__) && defined(__MACH__)
     #include "../include/ProcessOrchestrator.h"
     #include "../include/Logger.h"
@@ -13,20 +18,213 @@
     #include "../include/ThreadPool.h"
     #include "../include/FileHandler.h"
     #include "../include/Mapper_DLL_so.h"
+    #include "../include/Partitioner.h"
     #include "../include/Reducer_DLL_so.h"
+    #include "../include/ReducerOutputMerger.h"
+    #include "../include/ProcessLauncher.h"
+    #include "../include/SortedRunMerger.h"
+    #include "../include/MapReducePlugin.h"
 #else
     #error "Unsupported operating system. Please utilize Windows, MacOS, or any Linux distribution to operate this C++ program."
 #endif
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <filesystem>
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace fs = std::filesystem;
 
+// Line-aligned windows sampled per split when planning range partitions
+static constexpr size_t PARTITION_SAMPLE_WINDOWS = 8;
+
+// Maps only the listed byte range of an indexed spill file; per-reducer files are mapped whole
+static bool addPartitionInput(SortedRunMerger& merger, const std::string& path, const PartitionManifest::Entry& entry) {
+    return entry.inSpillFile() ? merger.addFile(path, entry.offset, entry.bytes) : merger.addFile(path);
+}
+
+// Reducer output is written under an attempt-specific staging name and then
+// hard-linked into place, so a backup attempt never writes into the original's
+// file. Linking never replaces: whichever attempt commits first wins and every
+// later copy, attempt 0 included, is discarded. Outputs of an earlier job are
+// removed by clearReducerOutputs before the job starts. A reducer without keys
+// stages nothing.
+static std::string reducerStagingPath(const std::string& outputPath, uint32_t attempt) {
+    return outputPath + (attempt > 0 ? ".a" + std::to_string(attempt) : "") + PartitionManifest::STAGING_SUFFIX;
+}
+
+static bool commitReducerOutput(const std::string& outputPath, uint32_t attempt) {
+    Logger& logger = Logger::getInstance();
+    const std::string stagingPath = reducerStagingPath(outputPath, attempt);
+    std::error_code ec;
+    if (!fs::exists(stagingPath, ec)) return true;
+    fs::create_hard_link(stagingPath, outputPath, ec);
+    if (ec == std::errc::file_exists) {
+        logger.log("Reducer output " + outputPath + " was committed by another attempt first; discarding attempt " +
+                   std::to_string(attempt) + ".");
+        ec.clear();
+    }
+    std::error_code removeError;
+    fs::remove(stagingPath, removeError);
+    if (ec) {
+        logger.log("Could not commit reducer output " + outputPath + ": " + ec.message(), Logger::Level::ERROR);
+        return false;
+    }
+    return true;
+}
+
 // Implementation of ProcessOrchestratorDLL class
+void ProcessOrchestratorDLL::clearReducerOutputs(const std::string& outputDir) {
+    std::error_code ec;
+    for (fs::directory_iterator it(outputDir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind("reducer_", 0) == 0 && name.find(".txt") != std::string::npos) {
+            std::error_code removeError;
+            fs::remove(it->path(), removeError);
+        }
+    }
+}
+
+bool ProcessOrchestratorDLL::loadConfig(const std::string& configFilePath) {
+    if (!fs::exists(configFilePath)) {
+        Logger::getInstance().log("No configuration file at " + configFilePath + ". Using defaults.");
+        return false;
+    }
+    return config.loadFromFile(configFilePath);
+}
+
+void ProcessOrchestratorDLL::applyLoggerConfig() const {
+    Logger& logger = Logger::getInstance();
+    if (auto level = config.getLogLevel()) {
+        logger.setMinimumLevel(*level);
+    }
+    logger.setConsoleOutput(config.getLogConsole().value_or(true));
+    logger.setOutputFormat(config.getLogFormat().value_or(Logger::OutputFormat::TEXT));
+    logger.setAsync(config.getLogAsync().value_or(false));
+}
+
+void ProcessOrchestratorDLL::applyMapperConfig(Mapper& mapper) const {
+    if (config.getCombinerEnabled().value_or(false)) {
+        mapper.enableCombiner(config.getCombinerMemoryBudget().value_or(Combiner::DEFAULT_MEMORY_BUDGET_BYTES));
+    }
+    mapper.setIntermediateEncoding(config.getIntermediateEncoding().value_or(IntermediateEncoding::BINARY));
+    mapper.setSpillBudget(config.getMapperSpillBudget().value_or(Mapper::DEFAULT_SPILL_BUDGET_BYTES));
+    mapper.setPartitionSeed(config.getPartitionHashSeed().value_or(Partitioner::DEFAULT_SEED));
+    if (!rangePartitioner.empty()) {
+        mapper.setRangePartitioner(rangePartitioner);
+    }
+}
+
+bool ProcessOrchestratorDLL::planRangePartitions(const std::vector<InputSplit>& inputSplits, int numReducers, const std::string& tempDir) {
+    Logger& logger = Logger::getInstance();
+    if (numReducers < 2) {
+        return false; // A single reducer already holds the whole sorted key space
+    }
+    const size_t sampleBytes = config.getPartitionSampleBytes().value_or(RangePartitioner::DEFAULT_SAMPLE_BYTES_PER_SPLIT);
+
+    // Tokenize a few line-aligned windows spread over each split with the
+    // mappers' own tokenizer, so sampled keys match the keys mappers emit.
+    // The combiner keeps the sample to one record per distinct word.
+    ErrorHandler errorHandler;
+    Mapper sampler(logger, errorHandler);
+    sampler.enableCombiner();
+    std::shared_ptr<const MapReducePlugin> plugin;
+    if (loadPlugin(plugin)) sampler.setPlugin(plugin); // Sample the keys a plugin's map_batch emits
+    KeyValueBuffer sample;
+    size_t bytesSampled = 0;
+    for (const auto& split : inputSplits) {
+        MappedFile input;
+        if (!input.open(split.filePath, split.offset, split.length)) continue;
+        std::string_view text = input.view();
+        if (text.size() <= sampleBytes) {
+            sampler.mapBuffer(split.filePath, text, sample);
+            bytesSampled += text.size();
+            continue;
+        }
+        const size_t windowBytes = std::max<size_t>(sampleBytes / PARTITION_SAMPLE_WINDOWS, 1);
+        for (size_t w = 0; w < PARTITION_SAMPLE_WINDOWS; ++w) {
+            size_t begin = text.size() / PARTITION_SAMPLE_WINDOWS * w;
+            if (begin > 0) {
+                size_t newline = text.find('\n', begin - 1);
+                if (newline == std::string_view::npos) break;
+                begin = newline + 1;
+            }
+            size_t end = text.find('\n', std::min(begin + windowBytes, text.size()) - 1);
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+            if (begin >= end) continue;
+            sampler.mapBuffer(split.filePath, text.substr(begin, end - begin), sample);
+            bytesSampled += end - begin;
+        }
+    }
+    sampler.flushCombiner(sample);
+
+    // A reduce plugin is promised each key's sum over every mapper, so its hot keys stay on one reducer
+    const bool splitHotKeys = !(plugin && plugin->hasReduce());
+    RangePartitioner planned = RangePartitioner::fromSample(numReducers, sample, splitHotKeys);
+    if (planned.empty()) {
+        logger.log("Range partitioning: sample of " + std::to_string(bytesSampled) + " bytes held no keys; using hash partitioning.",
+                   Logger::Level::WARNING);
+        return false;
+    }
+
+    // Expected share of the sampled records per reducer, with hot keys split evenly over their spans
+    std::vector<double> load(numReducers, 0.0);
+    double total = 0;
+    for (const auto& record : sample) {
+        std::pair<uint32_t, uint32_t> span = planned.getReducerSpan(record.key());
+        for (uint32_t r = 0; r < span.second; ++r) load[span.first + r] += static_cast<double>(record.value) / span.second;
+        total += record.value;
+    }
+    std::string hotKeys;
+    const std::vector<std::string>& boundaries = planned.getBoundaries();
+    for (size_t i = 1; splitHotKeys && i < boundaries.size(); ++i) {
+        if (boundaries[i] == boundaries[i - 1] && (i < 2 || boundaries[i - 2] != boundaries[i])) {
+            hotKeys += (hotKeys.empty() ? "" : ", ") + boundaries[i];
+        }
+    }
+    double maxLoad = *std::max_element(load.begin(), load.end());
+    logger.log("Range partitioning: " + std::to_string(sample.size()) + " distinct keys from " + std::to_string(bytesSampled) +
+               " sampled bytes; largest reducer share " + std::to_string(total > 0 ? maxLoad * numReducers / total : 0.0) +
+               "x the average" + (hotKeys.empty() ? "." : "; split hot keys: " + hotKeys + ".") +
+               (splitHotKeys ? "" : " Hot keys are not split while a reduce plugin is loaded."));
+
+    std::string boundaryPath = (fs::path(tempDir) / RangePartitioner::BOUNDARY_FILE_NAME).string();
+    std::string error;
+    std::error_code ec;
+    fs::create_directories(tempDir, ec);
+    if (!planned.save(boundaryPath, error)) {
+        logger.log("Range partitioning: could not save boundaries: " + error + "; using hash partitioning.", Logger::Level::ERROR);
+        return false;
+    }
+    rangePartitioner = std::move(planned);
+    return true;
+}
+
+bool ProcessOrchestratorDLL::loadRangePartitions(const std::string& tempDir, int numReducers) {
+    std::string boundaryPath = (fs::path(tempDir) / RangePartitioner::BOUNDARY_FILE_NAME).string();
+    RangePartitioner loaded;
+    std::string error;
+    if (!RangePartitioner::load(boundaryPath, loaded, error)) {
+        Logger::getInstance().log("Range partitioning: " + error + "; using hash partitioning.", Logger::Level::WARNING);
+        return false;
+    }
+    if (loaded.getNumReducers() != numReducers) {
+        Logger::getInstance().log("Range partitioning: " + boundaryPath + " was planned for " + std::to_string(loaded.getNumReducers()) +
+                                  " reducers, not " + std::to_string(numReducers) + "; using hash partitioning.", Logger::Level::WARNING);
+        return false;
+    }
+    std::shared_ptr<const MapReducePlugin> plugin;
+    if (loadPlugin(plugin) && plugin && plugin->hasReduce()) {
+        loaded.setSplitHotKeys(false); // As planRangePartitions planned them
+    }
+    rangePartitioner = std::move(loaded);
+    return true;
+}
+
 void ProcessOrchestratorDLL::runFinalReducer(const std::string& outputDir, const std::string& tempDir) {
     Logger& logger = Logger::getInstance();
     logger.log("Starting final reduction from " + tempDir + " to " + outputDir);
@@ -41,44 +239,40 @@ void ProcessOrchestratorDLL::runFinalReducer(const std::string& outputDir, const
         }
     }
 
-    // Find all reducer output files and perform final aggregation
-    std::map<std::string, int> finalResults;
-    std::map<std::string, std::vector<int>> finalVectorResults;
-
+    // Reducer outputs are key-sorted, so the final step is a streaming merge, not a re-reduction
+    std::vector<std::string> reducerOutputs;
     try {
-        // First check temp directory for any intermediate files that weren't processed by reducers
-        for (const auto& entry : fs::directory_iterator(tempDir)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-                logger.log("Processing intermediate file from temp directory: " + entry.path().string());
-                // Process temp files if needed (uncomment if required)
-                // processIntermediateFile(entry.path(), finalResults, finalVectorResults);
-            }
-        }
-        
-        // Now process reducer output files in the output directory
         for (const auto& entry : fs::directory_iterator(outputDir)) {
-            if (entry.is_regular_file() && entry.path().filename().string().find("reducer_") == 0) {
-                std::ifstream inFile(entry.path());
-                std::string line;
-                while (std::getline(inFile, line)) {
-                    size_t colonPos = line.find(": ");
-                    if (colonPos != std::string::npos) {
-                        std::string key = line.substr(0, colonPos);
-                        int value = std::stoi(line.substr(colonPos + 2));
-                        finalResults[key] += value;
-                        finalVectorResults[key].push_back(value);
-                    }
-                }
+            // Staged outputs of unfinished attempts end in ".tmp" and are skipped
+            if (entry.is_regular_file() && entry.path().filename().string().find("reducer_") == 0 && entry.path().extension() == ".txt") {
+                reducerOutputs.push_back(entry.path().string());
             }
         }
     } catch (const std::exception& e) {
         logger.log("Error in final aggregation: " + std::string(e.what()), Logger::Level::ERROR);
     }
+    std::sort(reducerOutputs.begin(), reducerOutputs.end());
 
-    // Write outputs
-    FileHandler::write_output(outputDir + "/output.txt", finalResults);
-    FileHandler::write_summed_output(outputDir + "/output_summed.txt", finalVectorResults);
+    ReducerOutputMerger merger;
+    for (const auto& path : reducerOutputs) {
+        if (!merger.addFile(path)) {
+            logger.log("Final reduction: could not read reducer output " + path, Logger::Level::ERROR);
+        }
+    }
 
+    size_t threads = config.getReducerMaxThreads().value_or(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::max<size_t>(threads, 1);
+    ThreadPool pool(threads, threads);
+    std::string error;
+    if (!merger.mergeTo(outputDir + "/output.txt", outputDir + "/output_summed.txt", pool, 2 * threads, error)) {
+        logger.log("Final reduction failed: " + error, Logger::Level::ERROR);
+        return;
+    }
+    if (merger.keyCount() == 0) {
+        logger.log("Final reduction: no keys found in reducer outputs; output files are empty.", Logger::Level::WARNING);
+    }
+    logger.log("Final reduction merged " + std::to_string(merger.fileCount()) + " reducer outputs into " +
+               std::to_string(merger.keyCount()) + " keys across " + std::to_string(merger.rangeCount()) + " key ranges.");
     logger.log("Final reduction completed.");
 }
 
@@ -110,9 +304,23 @@ bool ProcessOrchestratorDLL::runMapper(const std::string& tempDir,
                                       const std::vector<std::string>& inputFilePaths,
                                       size_t minPoolThreads,
                                       size_t maxPoolThreads) {
+    std::vector<InputSplit> wholeFiles;
+    for (const auto& filePath : inputFilePaths) {
+        wholeFiles.push_back({filePath, 0, MappedFile::WHOLE_FILE});
+    }
+    return runMapper(tempDir, mapperId, numReducers, wholeFiles, minPoolThreads, maxPoolThreads);
+}
+
+// Function to run the mapper over planned input splits
+bool ProcessOrchestratorDLL::runMapper(const std::string& tempDir,
+                                      int mapperId,
+                                      int numReducers,
+                                      const std::vector<InputSplit>& inputSplits,
+                                      size_t minPoolThreads,
+                                      size_t maxPoolThreads) {
     Logger& logger = Logger::getInstance();
     logger.log("Running mapper " + std::to_string(mapperId) + " with " + 
-               std::to_string(inputFilePaths.size()) + " files, using thread pool configuration: min=" + 
+               std::to_string(inputSplits.size()) + " splits, using thread pool configuration: min=" + 
                std::to_string(minPoolThreads) + ", max=" + std::to_string(maxPoolThreads));
     
     // Ensure temp directory exists
@@ -124,7 +332,25 @@ bool ProcessOrchestratorDLL::runMapper(const std::string& tempDir,
     // Initialize and process
     ErrorHandler errorHandler;
     Mapper mapper(logger, errorHandler);
-    std::vector<std::pair<std::string, int>> mappedData;
+    applyMapperConfig(mapper);
+    mapper.setProgressCounters(progress);
+    std::shared_ptr<const MapReducePlugin> plugin;
+    if (!loadPlugin(plugin)) return false;
+    mapper.setPlugin(plugin);
+    // Stage into this attempt's own files; a retry starts from scratch
+    const std::string partitionPrefix = PartitionManifest::partitionPrefix(mapperId, taskAttempt);
+    const std::string stagingSuffix = PartitionManifest::stagingSuffix();
+    PartitionManifest::clearStaging(tempDir, mapperId, numReducers, taskAttempt);
+    mapper.setSpillTarget(tempDir, numReducers, partitionPrefix, stagingSuffix);
+    bool indexed = config.getIntermediateLayout().value_or(IntermediateLayout::PER_REDUCER) == IntermediateLayout::INDEXED;
+    if (indexed && mapper.getIntermediateEncoding() != IntermediateEncoding::BINARY) {
+        logger.log("Indexed intermediate layout requires binary encoding; writing one file per reducer.", Logger::Level::WARNING);
+        indexed = false;
+    }
+    if (indexed) {
+        mapper.setIndexedSpillFile((fs::path(tempDir) / (PartitionManifest::spillFileName(mapperId, taskAttempt) + PartitionManifest::STAGING_SUFFIX)).string());
+    }
+    KeyValueBuffer mappedData;
     
     // Configure thread pools if needed (for future implementation)
     size_t actualMinThreads = minPoolThreads > 0 ? minPoolThreads : std::thread::hardware_concurrency();
@@ -136,22 +362,60 @@ bool ProcessOrchestratorDLL::runMapper(const std::string& tempDir,
     logger.log("Using thread pool configuration: min=" + std::to_string(actualMinThreads) + 
                ", max=" + std::to_string(actualMaxThreads));
     
-    // Process all input files
-    for (const auto& filePath : inputFilePaths) {
-        std::vector<std::string> lines;
-        if (FileHandler::read_file(filePath, lines)) {
-            for (const auto& line : lines) {
-                mapper.map(filePath, line, mappedData);
-            }
+    if (progress != nullptr) {
+        uint64_t totalBytes = 0;
+        for (const auto& split : inputSplits) {
+            std::error_code ec;
+            uint64_t fileSize = static_cast<uint64_t>(fs::file_size(split.filePath, ec));
+            if (ec || split.offset >= fileSize) continue;
+            totalBytes += std::min<uint64_t>(split.length, fileSize - split.offset);
         }
+        progress->total.store(totalBytes, std::memory_order_relaxed);
+    }
+
+    // Process all input splits
+    for (const auto& split : inputSplits) {
+        if (!mapper.mapSplit(split, mappedData)) {
+            logger.log("Failed to read input split: " + split.toString(), Logger::Level::ERROR);
+        }
+    }
+    if (mapper.hasPluginError()) {
+        logger.log("Mapper " + std::to_string(mapperId) + ": plugin " + plugin->name() + " failed; nothing committed.", Logger::Level::ERROR);
+        return false;
     }
+    mapper.flushCombiner(mappedData);
     
     // Export partitioned data
-    bool success = mapper.exportPartitionedData(tempDir, mappedData, numReducers, "partition_", ".txt");
-    logger.log(success ? "Mapper completed successfully" : "Mapper failed to export data", 
-              success ? Logger::Level::INFO : Logger::Level::ERROR);
-    
-    return success;
+    bool success = mapper.exportPartitionedData(tempDir, mappedData, numReducers, partitionPrefix, stagingSuffix);
+    if (!success) {
+        logger.log("Mapper failed to export data", Logger::Level::ERROR);
+        return false;
+    }
+
+    PartitionManifest manifest;
+    std::string error;
+    bool committed;
+    if (indexed) {
+        std::vector<PartitionManifest::Entry> segments;
+        for (const Mapper::SpillExtent& extent : mapper.getSpillIndex()) {
+            segments.push_back(PartitionManifest::Entry{extent.reducerId, "", extent.bytes, extent.offset});
+        }
+        committed = PartitionManifest::commitIndexed(tempDir, mapperId, numReducers, segments, manifest, error, taskAttempt);
+    } else {
+        committed = PartitionManifest::commit(tempDir, mapperId, numReducers, manifest, error, taskAttempt);
+    }
+    if (!committed) {
+        logger.log("Mapper " + std::to_string(mapperId) + " failed to commit its partitions: " + error, Logger::Level::ERROR);
+        return false;
+    }
+    if (manifest.getAttempt() != taskAttempt) {
+        logger.log("Mapper " + std::to_string(mapperId) + " attempt " + std::to_string(taskAttempt) + ": attempt " +
+                   std::to_string(manifest.getAttempt()) + " committed first; this attempt's output was discarded.");
+        return true;
+    }
+    logger.log("Mapper completed successfully; committed " + std::to_string(manifest.getEntries().size()) +
+               (indexed ? " indexed segments." : " partition files."));
+    return true;
 }
 
 // Function to run the reducer
@@ -171,39 +435,41 @@ bool ProcessOrchestratorDLL::runReducer(const std::string& outputDir,
         return false;
     }
 
-    // Find all partition files for this reducer
-    std::vector<std::string> partitionFiles;
-    std::vector<std::pair<std::string, int>> allMappedData;
-    
-    try {
-        for (const auto& entry : fs::directory_iterator(tempDir)) {
-            if (entry.is_regular_file()) {
-                std::string fname = entry.path().filename().string();
-                if (fname.find("_" + std::to_string(reducerId) + ".") != std::string::npos) {
-                    std::vector<std::pair<std::string, int>> mappedData;
-                    FileHandler::read_mapped_data(entry.path().string(), mappedData);
-                    allMappedData.insert(allMappedData.end(), mappedData.begin(), mappedData.end());
-                }
-            }
-        }
-    } catch (const fs::filesystem_error&) {
-        logger.log("Error scanning temp directory", Logger::Level::ERROR);
+    // Inputs are exactly the partitions committed mappers listed for this reducer
+    std::vector<PartitionManifest::Entry> inputs;
+    std::string error;
+    if (!PartitionManifest::collectReducerInputs(tempDir, reducerId, inputs, error)) {
+        logger.log("Reducer " + std::to_string(reducerId) + ": " + error, Logger::Level::ERROR);
         return false;
     }
 
-    if (allMappedData.empty()) {
+    if (inputs.empty()) {
         logger.log("No data found for reducer " + std::to_string(reducerId), Logger::Level::WARNING);
         return true;
     }
 
-    // Perform reduction
-    std::map<std::string, int> reducedData;
-    ReducerDLLso reducer;
-    reducer.reduce(allMappedData, reducedData, minPoolThreads, maxPoolThreads);
+    SortedRunMerger merger;
+    for (const auto& input : inputs) {
+        if (!addPartitionInput(merger, input.fileName, input)) {
+            logger.log("Reducer " + std::to_string(reducerId) + ": could not read " + input.fileName, Logger::Level::ERROR);
+            return false;
+        }
+    }
+    logger.log("Reducer " + std::to_string(reducerId) + ": merging " + std::to_string(merger.runCount()) + " sorted runs from " +
+               std::to_string(inputs.size()) + " partition inputs.");
 
-    // Write output
+    // Merge the mappers' sorted runs straight into the (staged) output file
     std::string outputPath = (fs::path(outputDir) / ("reducer_" + std::to_string(reducerId) + ".txt")).string();
-    bool success = FileHandler::write_output(outputPath, reducedData);
+    if (progress != nullptr) {
+        progress->total.store(merger.recordCount(), std::memory_order_relaxed);
+        merger.setProgressCounters(progress);
+    }
+    ReducerDLLso reducer;
+    std::shared_ptr<const MapReducePlugin> plugin;
+    if (!loadPlugin(plugin)) return false;
+    reducer.setPlugin(plugin);
+    bool success = reducer.reduceSortedRuns(merger, reducerStagingPath(outputPath, taskAttempt)) &&
+                   commitReducerOutput(outputPath, taskAttempt);
     
     logger.log(success ? "Reducer completed successfully" : "Failed to write reducer output", 
               success ? Logger::Level::INFO : Logger::Level::ERROR);
@@ -211,7 +477,186 @@ bool ProcessOrchestratorDLL::runReducer(const std::string& outputDir,
     return success;
 }
 
+bool ProcessOrchestratorDLL::applyWorkerLimits() const {
+    WorkerLimits limits;
+    limits.cpuSeconds = config.getWorkerCpuSeconds().value_or(0);
+    limits.memoryBytes = config.getWorkerMemoryBytes().value_or(0);
+    std::string error;
+    if (!ProcessLauncher::applyLimits(limits, error)) {
+        Logger::getInstance().log("Could not apply worker limits: " + error, Logger::Level::ERROR);
+        return false;
+    }
+    if (limits.cpuSeconds != 0 || limits.memoryBytes != 0) {
+        Logger::getInstance().log("Worker limits: cpu=" + std::to_string(limits.cpuSeconds) + "s, memory=" +
+                                  std::to_string(limits.memoryBytes) + " bytes (0 = unlimited)");
+    }
+    return true;
+}
+
+bool ProcessOrchestratorDLL::runWorkerProcesses(const std::string& executable,
+                                                const std::vector<std::vector<InputSplit>>& mapperSplits,
+                                                int numReducers,
+                                                const std::string& outputDir,
+                                                const std::string& tempDir) {
+    Logger& logger = Logger::getInstance();
+    const int numMappers = static_cast<int>(mapperSplits.size());
+    fs::path logDir = fs::path(tempDir) / "logs";
+    try {
+        fs::create_directories(logDir);
+        fs::create_directories(outputDir);
+    } catch (const fs::filesystem_error& e) {
+        logger.log("CONTROLLER: Could not prepare " + tempDir + " for worker processes: " + e.what(), Logger::Level::ERROR);
+        return false;
+    }
+
+    const std::string mapperMin = std::to_string(config.getMapperMinThreads().value_or(2));
+    const std::string mapperMax = std::to_string(config.getMapperMaxThreads().value_or(4));
+    const std::string reducerMin = std::to_string(config.getReducerMinThreads().value_or(2));
+    const std::string reducerMax = std::to_string(config.getReducerMaxThreads().value_or(4));
+
+    struct Worker {
+        std::string name;
+        bool running;
+    };
+    std::map<ProcessLauncher::ProcessId, Worker> workers;
+    bool success = true;
+    auto launch = [&](const std::string& name, const std::vector<std::string>& args) {
+        std::string error;
+        ProcessLauncher::ProcessId pid = ProcessLauncher::spawn(executable, args, error);
+        if (pid < 0) {
+            logger.log("CONTROLLER: Could not start " + name + ": " + error, Logger::Level::ERROR);
+            return false;
+        }
+        workers[pid] = Worker{name, true};
+        logger.log("CONTROLLER: Started " + name + " (pid " + std::to_string(pid) + "): " + buildCommandString_impl(executable, args));
+        return true;
+    };
+
+    // Reducers first: they shuffle each mapper's output the moment it commits
+    for (int r = 0; r < numReducers && success; ++r) {
+        std::string logPath = (logDir / ("reducer_" + std::to_string(r) + ".log")).string();
+        success = launch("reducer " + std::to_string(r),
+                         {"reducer", outputDir, tempDir, std::to_string(r), reducerMin, reducerMax, logPath, std::to_string(numMappers)});
+    }
+    for (int m = 0; m < numMappers && success; ++m) {
+        std::string logPath = (logDir / ("mapper_" + std::to_string(m) + ".log")).string();
+        std::vector<std::string> args = {"mapper", tempDir, std::to_string(m), std::to_string(numReducers), mapperMin, mapperMax, logPath};
+        for (const auto& split : mapperSplits[m]) args.push_back(split.toString());
+        success = launch("mapper " + std::to_string(m), args);
+    }
+
+    auto terminateRunning = [&]() {
+        for (const auto& worker : workers) {
+            if (worker.second.running) ProcessLauncher::terminate(worker.first);
+        }
+    };
+    if (!success) terminateRunning();
+
+    size_t running = workers.size();
+    ProcessLauncher::ExitStatus status;
+    while (running > 0 && ProcessLauncher::waitAny(status)) {
+        auto it = workers.find(status.pid);
+        if (it == workers.end()) continue; // Not one of this job's workers
+        it->second.running = false;
+        --running;
+        std::string outcome = it->second.name + " " + ProcessLauncher::describe(status);
+        if (status.succeeded()) {
+            logger.log("CONTROLLER: " + outcome);
+            continue;
+        }
+        logger.log("CONTROLLER: " + outcome + "; see its log in " + logDir.string(), Logger::Level::ERROR);
+        if (success) {
+            success = false;
+            terminateRunning(); // Reducers would otherwise wait forever for the failed mapper
+        }
+    }
+    return success && running == 0;
+}
+
+bool ProcessOrchestratorDLL::runPipelinedReducer(const std::string& outputDir,
+                                                 const std::string& tempDir,
+                                                 int reducerId,
+                                                 int numMappers) {
+    Logger& logger = Logger::getInstance();
+    const ProcessLauncher::ProcessId controller = ProcessLauncher::parentId();
+    std::vector<bool> shuffled(static_cast<size_t>(numMappers), false);
+    int remaining = numMappers;
+    SortedRunMerger merger;
+    size_t partitionInputs = 0;
+    auto delay = std::chrono::milliseconds(1);
+    while (remaining > 0) {
+        bool progressed = false;
+        for (int m = 0; m < numMappers; ++m) {
+            if (shuffled[m] || !PartitionManifest::isCommitted(tempDir, m)) continue;
+            PartitionManifest manifest;
+            std::string error;
+            if (!PartitionManifest::load(PartitionManifest::path(tempDir, m), manifest, error)) {
+                logger.log("Reducer " + std::to_string(reducerId) + ": " + error, Logger::Level::ERROR);
+                return false;
+            }
+            shuffled[m] = true;
+            --remaining;
+            progressed = true;
+            uint64_t bytes = 0;
+            for (const PartitionManifest::Entry& entry : manifest.entriesFor(reducerId)) {
+                fs::path partition = fs::path(tempDir) / entry.fileName;
+                if (!addPartitionInput(merger, partition.string(), entry)) {
+                    logger.log("Reducer " + std::to_string(reducerId) + ": could not read " + partition.string(), Logger::Level::ERROR);
+                    return false;
+                }
+                ++partitionInputs;
+                bytes += entry.bytes;
+            }
+            if (bytes == 0) continue; // No records of this mapper went to this reducer
+            LOG_INFO("Reducer {}: shuffled mapper {} ({} bytes); {} mapper(s) still running.", reducerId, m, bytes, remaining);
+        }
+        if (remaining == 0) break;
+        if (progressed) {
+            delay = std::chrono::milliseconds(1);
+            continue;
+        }
+        if (ProcessLauncher::parentId() != controller) {
+            logger.log("Reducer " + std::to_string(reducerId) + ": controller exited before all mappers committed.", Logger::Level::ERROR);
+            return false;
+        }
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, std::chrono::milliseconds(50));
+    }
+
+    if (!fs::exists(outputDir) && !fs::create_directories(outputDir)) {
+        logger.log("Failed to create output directory", Logger::Level::ERROR);
+        return false;
+    }
+    logger.log("Reducer " + std::to_string(reducerId) + ": all " + std::to_string(numMappers) + " mappers committed; merging " +
+               std::to_string(merger.runCount()) + " sorted runs from " + std::to_string(partitionInputs) + " partition inputs.");
+    std::string outputPath = (fs::path(outputDir) / ("reducer_" + std::to_string(reducerId) + ".txt")).string();
+    if (progress != nullptr) {
+        progress->total.store(merger.recordCount(), std::memory_order_relaxed);
+        merger.setProgressCounters(progress);
+    }
+    ReducerDLLso reducer;
+    std::shared_ptr<const MapReducePlugin> plugin;
+    if (!loadPlugin(plugin)) return false;
+    reducer.setPlugin(plugin);
+    return reducer.reduceSortedRuns(merger, reducerStagingPath(outputPath, taskAttempt)) && commitReducerOutput(outputPath, taskAttempt);
+}
+
 // Helper methods implementation
+bool ProcessOrchestratorDLL::loadPlugin(std::shared_ptr<const MapReducePlugin>& plugin) const {
+    plugin.reset();
+    std::optional<std::string> path = config.getPluginLibrary();
+    if (!path) return true;
+    std::string error;
+    plugin = MapReducePlugin::load(*path, error);
+    if (!plugin) {
+        Logger::getInstance().log("Plugin: " + error, Logger::Level::ERROR);
+        return false;
+    }
+    LOG_DEBUG("Plugin: using {} from {} (map: {}, reduce: {}).", plugin->name(), plugin->path(), plugin->hasMap() ? "yes" : "built-in",
+              plugin->hasReduce() ? "yes" : "built-in");
+    return true;
+}
+
 size_t ProcessOrchestratorDLL::resolveDefaultThreads() const {
     size_t hwThreads = std::thread::hardware_concurrency();
     return hwThreads > 0 ? hwThreads : 2; // Default to 2 if hardware_concurrency returns 0
@@ -3,25 +3,36 @@
     #include "..\include\ThreadPool.h"
     #include "..\include\ERROR_Handler.h"
     #include "..\include\Logger.h"
+    #include "..\include\SortedRunMerger.h"
+    #include "..\include\HashAggregationTable.h"
+    #include "..\include\StableHash.h"
+    #include "..\include\MapReducePlugin.h"
 #elif defined(__unix__) || defined(__APPLE__) && defined(__MACH__)
     #include "../include/Reducer_DLL_so.h"
     #include "../include/ThreadPool.h"
     #include "../include/ERROR_Handler.h"
     #include "../include/Logger.h"
+    #include "../include/SortedRunMerger.h"
+    #include "../include/HashAggregationTable.h"
+    #include "../include/StableHash.h"
+    #include "../include/MapReducePlugin.h"
 #else
     #error "Unsupported operating system. Please utilize Windows, MacOS, or any Linux distribution to operate this C++ program."
 #endif
 
 #include <mutex>
+#include <functional>
+#include <string_view>
 #include <thread>
 #include <algorithm>
 #include <map>
 #include <vector>
 #include <string>
 #include <cstddef>
+#include <fstream>
 
 void ReducerDLLso::reduce(
-    const std::vector<std::pair<std::string, int>>& mappedData,
+    const KeyValueBuffer& mappedData,
     std::map<std::string, int>& reducedData,
     size_t minPoolThreadsConfig,
     size_t maxPoolThreadsConfig
@@ -29,26 +40,226 @@ void ReducerDLLso::reduce(
     process_reduce_internal(mappedData, reducedData, minPoolThreadsConfig, maxPoolThreadsConfig);
 }
 
+void ReducerDLLso::reduceToVector(
+    const KeyValueBuffer& mappedData,
+    KeyValueBuffer& reducedData,
+    bool sortByKey,
+    size_t minPoolThreadsConfig,
+    size_t maxPoolThreadsConfig
+) {
+    std::vector<HashAggregationTable> shards;
+    aggregate_shards(mappedData, shards, minPoolThreadsConfig, maxPoolThreadsConfig);
+
+    size_t totalKeys = 0;
+    for (const auto& shard : shards) totalKeys += shard.size();
+    reducedData.reserve(reducedData.size() + totalKeys);
+    size_t firstNew = reducedData.size();
+    for (const auto& shard : shards) {
+        shard.forEach([&reducedData](std::string_view key, long long count) {
+            reducedData.add(key, static_cast<int>(count));
+        });
+    }
+    if (sortByKey) {
+        reducedData.sortByKey(firstNew);
+    }
+}
+
 void ReducerDLLso::process_reduce_internal(
-    const std::vector<std::pair<std::string, int>>& mappedData,
+    const KeyValueBuffer& mappedData,
     std::map<std::string, int>& reducedData,
     size_t minThreads,
     size_t maxThreads
+) {
+    // Aggregate in hash shards, then sort once; std::map only sees each key once
+    KeyValueBuffer aggregated;
+    reduceToVector(mappedData, aggregated, true, minThreads, maxThreads);
+
+    if (reducedData.empty()) {
+        for (const auto& record : aggregated) {
+            reducedData.emplace_hint(reducedData.end(), std::string(record.key()), record.value);
+        }
+    } else {
+        for (const auto& record : aggregated) {
+            reducedData[std::string(record.key())] += record.value;
+        }
+    }
+
+    Logger::getInstance().log("ReducerDLLso: Reduction completed (" + std::to_string(mappedData.size()) + " records, " +
+                              std::to_string(aggregated.size()) + " keys).");
+}
+
+void ReducerDLLso::aggregate_shards(
+    const KeyValueBuffer& mappedData,
+    std::vector<HashAggregationTable>& shards,
+    size_t minThreads,
+    size_t maxThreads
 ) {
     // Validate thread configurations
     size_t actualMinThreads = (minThreads == 0) ? std::thread::hardware_concurrency() : minThreads;
-    if (actualMinThreads == 0) actualMinThreads = 2; // Fallback value
+    if (actualMinThreads == 0) actualMinThreads = FALLBACK_REDUCE_THREAD_COUNT;
 
     size_t actualMaxThreads = (maxThreads == 0) ? actualMinThreads : maxThreads;
     if (actualMaxThreads < actualMinThreads) actualMaxThreads = actualMinThreads;
 
+    const size_t totalSize = mappedData.size();
+    if (totalSize < PARALLEL_REDUCE_MIN_RECORDS || actualMaxThreads == 1) {
+        Logger::getInstance().log("ReducerDLLso: Reducing " + std::to_string(totalSize) + " records on the calling thread.");
+        shards.clear();
+        shards.emplace_back(totalSize / 4);
+        for (const auto& record : mappedData) {
+            shards[0].add(record.key(), StableHash::hash(record.key(), AGGREGATION_HASH_SEED), record.value);
+        }
+        return;
+    }
+
     Logger::getInstance().log("ReducerDLLso: Starting reduction with threads: " +
                               std::to_string(actualMinThreads) + " to " + std::to_string(actualMaxThreads));
 
-    // Perform reduction logic here
-    for (const auto& pair : mappedData) {
-        reducedData[pair.first] += pair.second;
+    const size_t shardCount = actualMaxThreads;
+    const size_t chunkSize = calculate_dynamic_chunk_size(totalSize, actualMaxThreads);
+    const size_t chunkCount = (totalSize + chunkSize - 1) / chunkSize;
+
+    ThreadPool pool(actualMinThreads, actualMaxThreads);
+
+    // Phase 1: hash every key once and route record indices to their shard, per chunk
+    std::vector<uint64_t> hashes(totalSize);
+    std::vector<std::vector<std::vector<uint32_t>>> routed(chunkCount, std::vector<std::vector<uint32_t>>(shardCount));
+    pool.parallel_for(0, chunkCount, 1, [&](size_t chunk, size_t) {
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(begin + chunkSize, totalSize);
+        auto& chunkShards = routed[chunk];
+        for (auto& indices : chunkShards) indices.reserve((end - begin) / shardCount + 1);
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t hash = StableHash::hash(mappedData[i].key(), AGGREGATION_HASH_SEED);
+            hashes[i] = hash;
+            chunkShards[StableHash::fastRange(hash, static_cast<uint32_t>(shardCount))].push_back(static_cast<uint32_t>(i - begin));
+        }
+    });
+
+    // Phase 2: each shard owns a disjoint key set, so its table needs no locking
+    shards.clear();
+    shards.reserve(shardCount);
+    for (size_t s = 0; s < shardCount; ++s) shards.emplace_back(totalSize / shardCount / 4);
+    pool.parallel_for(0, shardCount, 1, [&](size_t s, size_t) {
+        HashAggregationTable& table = shards[s];
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            size_t base = chunk * chunkSize;
+            for (uint32_t offset : routed[chunk][s]) {
+                size_t i = base + offset;
+                table.add(mappedData[i].key(), hashes[i], mappedData[i].value);
+            }
+        }
+    });
+}
+
+// Chunks are sized so every thread gets several to balance uneven key lengths,
+// but never so small that per-chunk bookkeeping dominates.
+size_t ReducerDLLso::calculate_dynamic_chunk_size(size_t totalSize, size_t guideMaxThreads) const {
+    size_t threads = guideMaxThreads > 0 ? guideMaxThreads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = FALLBACK_REDUCE_THREAD_COUNT;
+    size_t chunkSize = (totalSize + threads * CHUNKS_PER_THREAD - 1) / (threads * CHUNKS_PER_THREAD);
+    return std::max(chunkSize, MIN_REDUCE_CHUNK_SIZE);
+}
+
+bool ReducerDLLso::reduceSortedRuns(
+    const std::vector<std::string>& partitionFiles,
+    const std::string& outputPath
+) {
+    Logger& logger = Logger::getInstance();
+    SortedRunMerger merger;
+    bool inputsOk = true;
+    for (const auto& file : partitionFiles) {
+        if (!merger.addFile(file)) {
+            logger.log("ReducerDLLso: Could not read partition file " + file, Logger::Level::ERROR);
+            inputsOk = false;
+        }
     }
+    if (!inputsOk) return false;
+    logger.log("ReducerDLLso: Merging " + std::to_string(merger.runCount()) + " sorted runs from " +
+               std::to_string(partitionFiles.size()) + " partition files.");
+    return reduceSortedRuns(merger, outputPath);
+}
+
+bool ReducerDLLso::reduceSortedRuns(
+    SortedRunMerger& merger,
+    const std::string& outputPath
+) {
+    Logger& logger = Logger::getInstance();
+    std::ofstream out;
+    std::string buffer;
+    size_t keys = 0;
+    bool writeOk = true;
+    auto flushBuffer = [&]() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    };
+    auto writeRecord = [&](std::string_view key, long long value) {
+        if (!out.is_open()) {
+            out.open(outputPath, std::ios::trunc | std::ios::binary);
+            if (!out) writeOk = false;
+        }
+        if (!writeOk) return;
+        buffer.append(key.data(), key.size());
+        buffer += ": ";
+        buffer += std::to_string(value);
+        buffer += '\n';
+        if (buffer.size() >= 64 * 1024) flushBuffer();
+        ++keys;
+    };
+
+    // With a reduce plugin, merged records wait in `pending` until a batch is full
+    const bool usePlugin = plugin && plugin->hasReduce();
+    PluginOutput pending, emitted;
+    std::vector<MrRecord> batch;
+    std::string lastKey; // Last key the plugin emitted, to check the output stays sorted
+    bool pluginOk = true;
+    auto reduceBatch = [&]() {
+        if (pending.empty() || !pluginOk) return;
+        batch.clear();
+        for (size_t i = 0; i < pending.size(); ++i) {
+            std::string_view key = pending.key(i);
+            batch.push_back(MrRecord{key.data(), static_cast<uint32_t>(key.size()), pending.value(i)});
+        }
+        emitted.clear();
+        if (!plugin->reduceBatch(batch, emitted)) {
+            ErrorHandler::reportError("ReducerDLLso: Plugin " + plugin->name() + " failed to reduce a batch of " +
+                                      std::to_string(batch.size()) + " keys.");
+            pluginOk = false;
+            return;
+        }
+        for (size_t i = 0; i < emitted.size() && pluginOk; ++i) {
+            if (keys > 0 && emitted.key(i) < lastKey) {
+                ErrorHandler::reportError("ReducerDLLso: Plugin " + plugin->name() + " emitted key '" + std::string(emitted.key(i)) +
+                                          "' out of order.");
+                pluginOk = false;
+                break;
+            }
+            lastKey.assign(emitted.key(i).data(), emitted.key(i).size());
+            writeRecord(emitted.key(i), emitted.value(i));
+        }
+        pending.clear();
+    };
 
-    Logger::getInstance().log("ReducerDLLso: Reduction completed.");
-}
\ No newline at end of file
+    bool mergeOk = merger.merge([&](std::string_view key, long long sum) {
+        if (!usePlugin) {
+            writeRecord(key, sum);
+            return;
+        }
+        pending.add(key, sum);
+        if (pending.size() >= PLUGIN_BATCH_RECORDS) reduceBatch();
+    });
+    if (usePlugin) reduceBatch();
+    if (out.is_open()) {
+        flushBuffer();
+        out.close();
+        if (out.fail()) writeOk = false;
+    }
+
+    if (!writeOk) {
+        ErrorHandler::reportError("ReducerDLLso: Failed to write reducer output " + outputPath);
+        return false;
+    }
+    logger.log("ReducerDLLso: Merged " + std::to_string(keys) + (usePlugin ? " keys emitted by plugin " + plugin->name() : std::string(" distinct keys")) +
+               " into " + outputPath);
+    return mergeOk && pluginOk;
+}
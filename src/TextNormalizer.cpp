@@ -0,0 +1,183 @@
+#ifdef _WIN32
+    #include "..\include\TextNormalizer.h"
+    #include "..\include\Tokenizer.h"
+#elif defined(__unix__) || defined(__APPLE__) && defined(__MACH__)
+    #include "../include/TextNormalizer.h"
+    #include "../include/Tokenizer.h"
+#else
+    #error "Unsupported operating system. Please utilize Windows, MacOS, or any Linux distribution to operate this C++ program."
+#endif
+
+#include <cstdint>
+
+// The vector kernels rely on GCC/Clang function-level target attributes so the
+// rest of the library can still be compiled for baseline x86-64. Other
+// compilers and architectures only get the scalar kernel.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define TEXT_NORMALIZER_X86 1
+    #include <immintrin.h>
+#else
+    #define TEXT_NORMALIZER_X86 0
+#endif
+
+namespace {
+
+// Reference kernel, driven by the same table as Tokenizer.
+size_t normalizeScalar(const char* in, size_t size, char* out) {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(in);
+    size_t o = 0;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = src[i];
+        switch (CHAR_CLASS_TABLE.cls[c]) {
+            case CharClass::SEPARATOR:   out[o++] = ' '; break;
+            case CharClass::PUNCTUATION: break;
+            default:                     out[o++] = static_cast<char>(CHAR_CLASS_TABLE.fold[c]); break;
+        }
+    }
+    return o;
+}
+
+#if TEXT_NORMALIZER_X86
+
+// Appends the bytes of `block` whose bit is set in `keepMask`.
+inline size_t compactBlock(const unsigned char* block, uint32_t keepMask, char* out) {
+    size_t o = 0;
+    while (keepMask) {
+        out[o++] = static_cast<char>(block[__builtin_ctz(keepMask)]);
+        keepMask &= keepMask - 1;
+    }
+    return o;
+}
+
+// lo <= c <= hi as an unsigned byte compare: (c - lo) <= (hi - lo).
+__attribute__((target("avx2")))
+inline __m256i inRange256(__m256i c, char lo, char hi) {
+    __m256i shifted = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+    __m256i limit = _mm256_set1_epi8(static_cast<char>(hi - lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, limit), shifted);
+}
+
+__attribute__((target("avx2")))
+size_t normalizeAVX2(const char* in, size_t size, char* out) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    size_t o = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+        __m256i separator = _mm256_or_si256(_mm256_cmpeq_epi8(c, space), inRange256(c, '\t', '\r'));
+        __m256i upper = inRange256(c, 'A', 'Z');
+        __m256i alnum = _mm256_or_si256(_mm256_or_si256(inRange256(c, '0', '9'), upper), inRange256(c, 'a', 'z'));
+        __m256i punct = _mm256_andnot_si256(alnum, inRange256(c, '!', '~'));
+
+        __m256i folded = _mm256_or_si256(c, _mm256_and_si256(upper, caseBit));
+        folded = _mm256_blendv_epi8(folded, space, separator);
+
+        uint32_t punctMask = static_cast<uint32_t>(_mm256_movemask_epi8(punct));
+        if (punctMask == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), folded);
+            o += 32;
+        } else {
+            alignas(32) unsigned char block[32];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(block), folded);
+            o += compactBlock(block, ~punctMask, out + o);
+        }
+    }
+
+    return o + normalizeScalar(in + i, size - i, out + o);
+}
+
+__attribute__((target("sse4.2")))
+inline __m128i inRange128(__m128i c, char lo, char hi) {
+    __m128i shifted = _mm_sub_epi8(c, _mm_set1_epi8(lo));
+    __m128i limit = _mm_set1_epi8(static_cast<char>(hi - lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, limit), shifted);
+}
+
+// Uses PCMPESTRM range mode to classify punctuation and separators. The explicit
+// length form is required because input text may contain NUL bytes.
+__attribute__((target("sse4.2")))
+size_t normalizeSSE42(const char* in, size_t size, char* out) {
+    const __m128i punctRanges = _mm_setr_epi8('!', '/', ':', '@', '[', '`', '{', '~', 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i separatorRanges = _mm_setr_epi8('\t', '\r', ' ', ' ', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    size_t o = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+        __m128i separator = _mm_cmpestrm(separatorRanges, 4, c, 16,
+                                         _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_UNIT_MASK);
+        __m128i punct = _mm_cmpestrm(punctRanges, 8, c, 16,
+                                     _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_UNIT_MASK);
+        __m128i upper = inRange128(c, 'A', 'Z');
+
+        __m128i folded = _mm_or_si128(c, _mm_and_si128(upper, caseBit));
+        folded = _mm_blendv_epi8(folded, space, separator);
+
+        uint32_t punctMask = static_cast<uint32_t>(_mm_movemask_epi8(punct));
+        if (punctMask == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), folded);
+            o += 16;
+        } else {
+            alignas(16) unsigned char block[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(block), folded);
+            o += compactBlock(block, ~punctMask & 0xFFFFu, out + o);
+        }
+    }
+
+    return o + normalizeScalar(in + i, size - i, out + o);
+}
+
+#endif // TEXT_NORMALIZER_X86
+
+TextNormalizer::Kernel detectKernel() {
+#if TEXT_NORMALIZER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return TextNormalizer::Kernel::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return TextNormalizer::Kernel::SSE42;
+#endif
+    return TextNormalizer::Kernel::SCALAR;
+}
+
+} // namespace
+
+TextNormalizer::Kernel TextNormalizer::activeKernel() {
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+bool TextNormalizer::isSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SCALAR: return true;
+        case Kernel::SSE42:  return activeKernel() == Kernel::SSE42 || activeKernel() == Kernel::AVX2;
+        case Kernel::AVX2:   return activeKernel() == Kernel::AVX2;
+        default:             return false;
+    }
+}
+
+const char* TextNormalizer::kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SCALAR: return "scalar";
+        case Kernel::SSE42:  return "sse4.2";
+        case Kernel::AVX2:   return "avx2";
+        default:             return "unknown";
+    }
+}
+
+size_t TextNormalizer::normalize(const char* in, size_t size, char* out) {
+    return normalizeWith(activeKernel(), in, size, out);
+}
+
+size_t TextNormalizer::normalizeWith(Kernel kernel, const char* in, size_t size, char* out) {
+    if (!isSupported(kernel)) kernel = Kernel::SCALAR;
+#if TEXT_NORMALIZER_X86
+    if (kernel == Kernel::AVX2) return normalizeAVX2(in, size, out);
+    if (kernel == Kernel::SSE42) return normalizeSSE42(in, size, out);
+#endif
+    return normalizeScalar(in, size, out);
+}
@@ -12,7 +12,7 @@
 
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -20,12 +20,24 @@
 #include <string>
 #include <atomic>
 
+namespace {
+    // Identifies the pool and deque of the current worker thread, so tasks
+    // enqueued from inside a task go to that worker's own deque.
+    struct CurrentWorker {
+        const ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+    thread_local CurrentWorker currentWorker;
+}
+
 // Constructor
 ThreadPool::ThreadPool(size_t minThreads, size_t maxThreads)
-    : minThreadsCount(minThreads), maxThreadsCount(maxThreads),
+    : minThreadsCount(minThreads), maxThreadsCount(maxThreads), workerCount(0),
+      injectedCount(0), parkedCount(0), pendingTasks(0),
       stopFlag(false), shuttingDownFlag(false), activeThreadsCount(0) {
     if (minThreadsCount == 0) minThreadsCount = 1;
     if (maxThreadsCount < minThreadsCount) maxThreadsCount = minThreadsCount;
+    workers.resize(maxThreadsCount);
 
     Logger::getInstance().log("THREAD_POOL: Initializing with MinThreads=" + std::to_string(minThreadsCount) +
                               ", MaxThreads=" + std::to_string(maxThreadsCount));
@@ -41,109 +53,212 @@ ThreadPool::~ThreadPool() {
 
 // Enqueue a task
 void ThreadPool::enqueueTask(const std::function<void()>& task) {
-    if (shuttingDownFlag || stopFlag) return;
+    tryEnqueue(task);
+}
 
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        taskQueue.push(task);
+bool ThreadPool::tryEnqueue(const std::function<void()>& task) {
+    if (currentWorker.pool == this) {
+        // shutdown() drains worker deques after joining the workers, so this push is never lost
+        if (shuttingDownFlag || stopFlag) return false;
+        workers[currentWorker.index]->deque.push(new Task(task));
+    } else {
+        // The flag is checked under the lock shutdown() drains with, so a task
+        // is either refused or published before that drain
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (shuttingDownFlag || stopFlag) return false;
+        injectionQueue.push_back(new Task(task));
+        injectedCount.fetch_add(1, std::memory_order_release);
     }
-    condition.notify_one();
+    pendingTasks.fetch_add(1);
+    wakeWorker();
     adjustThreadPoolSize();
+    return true;
 }
 
 // Shutdown the thread pool
 void ThreadPool::shutdown() {
-    if (shuttingDownFlag) return;
-    shuttingDownFlag = true;
+    if (shuttingDownFlag.exchange(true)) return;
 
     Logger::getInstance().log("THREAD_POOL: Shutdown initiated. Waiting for tasks and threads to complete.");
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        std::lock_guard<std::mutex> lock(parkMutex);
         stopFlag = true;
     }
-    condition.notify_all();
+    parkCondition.notify_all();
 
-    for (std::thread& thread : workerThreads) {
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        threads.swap(workerThreads);
+    }
+    for (std::thread& thread : threads) {
         if (thread.joinable()) {
             thread.join();
         }
     }
-    workerThreads.clear();
+
+    // A task accepted while shutdown began may have been published after the
+    // last worker exited. Run any such stragglers here so none are lost. The
+    // shutdown flag is already set, so tryEnqueue refuses anything after this.
+    std::deque<Task*> stragglers;
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        stragglers.swap(injectionQueue);
+        injectedCount.store(0, std::memory_order_relaxed);
+    }
+    for (Task* straggler : stragglers) runTask(straggler);
+    Task* task = nullptr;
+    for (size_t i = 0; i < workerCount.load(); ++i) {
+        while (workers[i]->deque.steal(task)) runTask(task);
+    }
+    pendingTasks.store(0);
     Logger::getInstance().log("THREAD_POOL: Shutdown complete. All threads joined.");
 }
 
 // Get the count of active threads
 size_t ThreadPool::getActiveThreads() const {
-    std::lock_guard<std::mutex> lock(threadsMutex);
-    return activeThreadsCount;
+    return activeThreadsCount.load();
 }
 
-// Get the number of tasks in the queue
+// Get the number of tasks waiting to be picked up by a worker
 size_t ThreadPool::getTasksInQueue() const {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    return taskQueue.size();
+    int64_t pending = pendingTasks.load();
+    return pending > 0 ? static_cast<size_t>(pending) : 0;
 }
 
 // Worker loop for each thread
-void ThreadPool::workerLoop() {
-    {
-        std::lock_guard<std::mutex> lock(threadsMutex);
-        activeThreadsCount++;
-    }
+void ThreadPool::workerLoop(size_t index) {
+    currentWorker = CurrentWorker{this, index};
+    activeThreadsCount++;
 
     while (true) {
-        std::function<void()> task;
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            condition.wait(lock, [this]() {
-                return stopFlag || !taskQueue.empty();
-            });
-
-            if (stopFlag && taskQueue.empty()) break;
-            if (taskQueue.empty()) continue;
-
-            task = std::move(taskQueue.front());
-            taskQueue.pop();
+        Task* task = nullptr;
+        for (int round = 0; round < STEAL_ROUNDS_BEFORE_PARK && task == nullptr; ++round) {
+            task = findTask(index);
+            if (task == nullptr) std::this_thread::yield();
         }
+        if (task != nullptr) {
+            pendingTasks.fetch_sub(1);
+            runTask(task);
+            continue;
+        }
+
+        // Park until work is announced. parkedCount is raised before pendingTasks
+        // is re-checked, and enqueueTask raises pendingTasks before checking
+        // parkedCount, so a wakeup cannot be lost between the two.
+        std::unique_lock<std::mutex> lock(parkMutex);
+        parkedCount.fetch_add(1);
+        parkCondition.wait(lock, [this]() {
+            return stopFlag || pendingTasks.load() > 0;
+        });
+        parkedCount.fetch_sub(1);
+        if (stopFlag && pendingTasks.load() <= 0) break;
+    }
+
+    activeThreadsCount--;
+    currentWorker = CurrentWorker{};
+}
 
-        try {
-            task();
-        } catch (const std::exception& e) {
-            Logger::getInstance().log("THREAD_POOL: Exception caught in worker thread: " + std::string(e.what()));
-        } catch (...) {
-            Logger::getInstance().log("THREAD_POOL: Unknown exception caught in worker thread.");
+// Own deque first (LIFO, cache-warm), then the injection queue, then steal
+// from random victims (FIFO, oldest and usually largest tasks first)
+ThreadPool::Task* ThreadPool::findTask(size_t index) {
+    Worker& self = *workers[index];
+    Task* task = nullptr;
+    if (self.deque.pop(task)) return task;
+
+    task = popInjected();
+    if (task != nullptr) return task;
+
+    size_t count = workerCount.load(std::memory_order_acquire);
+    if (count <= 1) return nullptr;
+    for (size_t attempt = 0; attempt < count; ++attempt) {
+        self.rngState ^= self.rngState << 13;
+        self.rngState ^= self.rngState >> 7;
+        self.rngState ^= self.rngState << 17;
+        size_t victim = static_cast<size_t>(self.rngState % count);
+        if (victim == index) continue;
+        if (workers[victim]->deque.steal(task)) return task;
+    }
+    return nullptr;
+}
+
+// Take the oldest externally enqueued task, if any
+ThreadPool::Task* ThreadPool::popInjected() {
+    if (injectedCount.load(std::memory_order_acquire) == 0) return nullptr;
+    std::lock_guard<std::mutex> lock(injectionMutex);
+    if (injectionQueue.empty()) return nullptr;
+    Task* task = injectionQueue.front();
+    injectionQueue.pop_front();
+    injectedCount.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+}
+
+// Run one queued task on the calling thread. Workers use their own deque
+// first; other threads take injected work and then steal.
+bool ThreadPool::runPendingTask() {
+    Task* task = nullptr;
+    if (currentWorker.pool == this) {
+        task = findTask(currentWorker.index);
+    } else {
+        task = popInjected();
+        size_t count = workerCount.load(std::memory_order_acquire);
+        for (size_t i = 0; task == nullptr && i < count; ++i) {
+            if (!workers[i]->deque.steal(task)) task = nullptr;
         }
     }
+    if (task == nullptr) return false;
+    pendingTasks.fetch_sub(1);
+    runTask(task);
+    return true;
+}
 
+// Wake one parked worker; free when no worker is parked
+void ThreadPool::wakeWorker() {
+    if (parkedCount.load() == 0) return;
     {
-        std::lock_guard<std::mutex> lock(threadsMutex);
-        activeThreadsCount--;
+        std::lock_guard<std::mutex> lock(parkMutex);
     }
+    parkCondition.notify_one();
+}
+
+void ThreadPool::runTask(Task* task) {
+    try {
+        (*task)();
+    } catch (const std::exception& e) {
+        Logger::getInstance().log("THREAD_POOL: Exception caught in worker thread: " + std::string(e.what()));
+    } catch (...) {
+        Logger::getInstance().log("THREAD_POOL: Unknown exception caught in worker thread.");
+    }
+    delete task;
 }
 
 // Add a thread to the pool
 void ThreadPool::addThread() {
     std::lock_guard<std::mutex> lock(threadsMutex);
-    if (workerThreads.size() < maxThreadsCount) {
-        workerThreads.emplace_back(&ThreadPool::workerLoop, this);
+    addThreadLocked();
+}
+
+// Add a thread to the pool; threadsMutex must be held
+void ThreadPool::addThreadLocked() {
+    size_t index = workerCount.load(std::memory_order_relaxed);
+    if (index < maxThreadsCount) {
+        workers[index] = std::make_unique<Worker>();
+        workers[index]->rngState = 0x9E3779B97F4A7C15ULL * (index + 1);
+        workerCount.store(index + 1, std::memory_order_release); // Thieves may see the slot from here on
+        workerThreads.emplace_back(&ThreadPool::workerLoop, this, index);
     }
 }
 
-// Adjust the thread pool size based on workload
+// Grow the pool while queued tasks outnumber workers. Only takes threadsMutex
+// when a thread will actually be added.
 void ThreadPool::adjustThreadPoolSize() {
+    if (stopFlag || shuttingDownFlag) return;
+    size_t count = workerCount.load(std::memory_order_relaxed);
+    if (count >= maxThreadsCount || getTasksInQueue() <= count) return;
+
     std::lock_guard<std::mutex> lock(threadsMutex);
-    if (!stopFlag && !shuttingDownFlag) {
-        if (!taskQueue.empty() && workerThreads.size() < maxThreadsCount) {
-            if (taskQueue.size() > workerThreads.size() || workerThreads.size() < minThreadsCount) {
-                addThread();
-            }
-        }
-    }
-    if (workerThreads.size() < minThreadsCount && !stopFlag && !shuttingDownFlag) {
-        for (size_t i = workerThreads.size(); i < minThreadsCount; ++i) {
-            if (workerThreads.size() < maxThreadsCount) {
-                addThread();
-            } else break;
-        }
+    if (!stopFlag && !shuttingDownFlag && workerCount.load(std::memory_order_relaxed) < maxThreadsCount &&
+        getTasksInQueue() > workerCount.load(std::memory_order_relaxed)) {
+        addThreadLocked();
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,165 @@
+#include "../include/WorkerExecutor.h"
+#include "../include/InputSplit.h"
+#include "../include/Logger.h"
+#include "../include/PartitionManifest.h"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool isNumber(const std::string& s) {
+    return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char c) { return c >= '0' && c <= '9'; });
+}
+
+// Index of the log path argument: after the optional "minThreads maxThreads"
+// pair, which is present when two numbers follow the fixed arguments and
+// enough arguments remain for the log path (and, for mappers, an input).
+static size_t logArgIndex(const std::vector<std::string>& args, size_t fixedArgs, size_t minimumAfterLog) {
+    if (args.size() >= fixedArgs + 3 + minimumAfterLog && isNumber(args[fixedArgs]) && isNumber(args[fixedArgs + 1])) {
+        return fixedArgs + 2;
+    }
+    return fixedArgs;
+}
+
+WorkerExecutor::WorkerExecutor(const ProcessOrchestratorDLL& orchestrator, size_t slots, StartedCallback onStarted,
+                               FinishedCallback onFinished)
+    : base(orchestrator),
+      slots(std::max<size_t>(1, slots)),
+      onStarted(std::move(onStarted)),
+      onFinished(std::move(onFinished)),
+      pool(this->slots, this->slots) {}
+
+WorkerExecutor::~WorkerExecutor() {
+    drain();
+}
+
+void WorkerExecutor::submit(uint32_t requestId, TaskAssignment task) {
+    pool.enqueueTask([this, requestId, task = std::move(task)]() {
+        ++running;
+        auto taskCounters = std::make_shared<TaskCounters>();
+        {
+            std::lock_guard<std::mutex> lock(countersMutex);
+            counters[requestId] = taskCounters;
+        }
+        if (onStarted) onStarted(requestId);
+
+        TaskResult result;
+        std::string error;
+        ProcessOrchestratorDLL orchestrator = base;
+        orchestrator.setTaskAttempt(task.attempt);
+        orchestrator.setProgressCounters(taskCounters.get());
+        bool ok = false;
+        try {
+            ok = runTask(orchestrator, task, error);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        if (ok) {
+            result.manifestPath = publishedPath(task);
+        } else {
+            result.exitCode = 1;
+            Logger::getInstance().log("Task #" + std::to_string(requestId) + " (" + task.command + ") failed: " + error,
+                                      Logger::Level::ERROR);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(countersMutex);
+            counters.erase(requestId);
+        }
+        --running;
+        if (onFinished) onFinished(requestId, result);
+    });
+}
+
+std::vector<std::pair<uint32_t, TaskProgress>> WorkerExecutor::progress() const {
+    std::lock_guard<std::mutex> lock(countersMutex);
+    std::vector<std::pair<uint32_t, TaskProgress>> tasks;
+    for (const auto& entry : counters) {
+        const TaskCounters& task = *entry.second;
+        tasks.emplace_back(entry.first, TaskProgress{task.get(task.done), task.get(task.total), task.get(task.records)});
+    }
+    return tasks;
+}
+
+void WorkerExecutor::drain() {
+    if (drained) return;
+    drained = true;
+    pool.shutdown();
+}
+
+bool WorkerExecutor::runTask(ProcessOrchestratorDLL& orchestrator, const TaskAssignment& task, std::string& error) {
+    const std::vector<std::string>& args = task.args;
+    if (task.command == "map") {
+        // tempDir mapperId R [min max] log input...
+        if (args.size() < 5) {
+            error = "map needs <tempDir> <mapperId> <R> [minThreads maxThreads] <logPath> <input...>";
+            return false;
+        }
+        size_t logIndex = logArgIndex(args, 3, 1);
+        if (args.size() <= logIndex + 1) {
+            error = "map task has no inputs";
+            return false;
+        }
+        const std::string& tempDir = args[0];
+        int mapperId = std::stoi(args[1]);
+        int numReducers = std::stoi(args[2]);
+        size_t minThreads = logIndex > 3 ? std::stoul(args[3]) : 0;
+        size_t maxThreads = logIndex > 3 ? std::stoul(args[4]) : 0;
+
+        if (orchestrator.getConfig().getPartitionScheme().value_or(PartitionScheme::HASH) == PartitionScheme::RANGE) {
+            orchestrator.loadRangePartitions(tempDir, numReducers);
+        }
+        std::vector<InputSplit> inputSplits;
+        for (size_t i = logIndex + 1; i < args.size(); ++i) {
+            inputSplits.push_back(InputSplit::parse(args[i]));
+        }
+        if (!orchestrator.runMapper(tempDir, mapperId, numReducers, inputSplits, minThreads, maxThreads)) {
+            error = "mapper " + args[1] + " did not commit its partitions";
+            return false;
+        }
+        return true;
+    }
+
+    if (task.command == "reduce") {
+        // outputDir tempDir reducerId [min max] log [numMappers]
+        if (args.size() < 4) {
+            error = "reduce needs <outputDir> <tempDir> <reducerId> [minThreads maxThreads] <logPath> [numMappers]";
+            return false;
+        }
+        size_t logIndex = logArgIndex(args, 3, 0);
+        const std::string& outputDir = args[0];
+        const std::string& tempDir = args[1];
+        int reducerId = std::stoi(args[2]);
+        size_t minThreads = logIndex > 3 ? std::stoul(args[3]) : 0;
+        size_t maxThreads = logIndex > 3 ? std::stoul(args[4]) : 0;
+
+        bool ok;
+        if (args.size() > logIndex + 1) {
+            // With a mapper count, shuffle each mapper's partition as soon as it commits
+            ok = orchestrator.runPipelinedReducer(outputDir, tempDir, reducerId, std::stoi(args[logIndex + 1]));
+        } else {
+            ok = orchestrator.runReducer(outputDir, tempDir, reducerId, minThreads, maxThreads);
+        }
+        if (!ok) error = "reducer " + args[2] + " failed";
+        return ok;
+    }
+
+    error = "unknown task command '" + task.command + "'";
+    return false;
+}
+
+std::string WorkerExecutor::publishedPath(const TaskAssignment& task) {
+    try {
+        if (task.command == "map" && task.args.size() >= 2) {
+            return PartitionManifest::path(task.args[0], std::stoi(task.args[1]));
+        }
+        if (task.command == "reduce" && task.args.size() >= 3) {
+            return (fs::path(task.args[0]) / ("reducer_" + task.args[2] + ".txt")).string();
+        }
+    } catch (const std::exception&) {
+    }
+    return "";
+}
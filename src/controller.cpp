@@ -1,136 +1,303 @@
 #include <iostream>
 #include <unistd.h>
-#include <arpa/inet.h>
 #include <cstring>
+#include <filesystem>
 #include <thread>
 #include <sstream>
+#include <vector>
 #include "../include/socket_interface.h"
+#include "../include/ControllerService.h"
+#include "../include/FileHandler.h"
+#include "../include/InputSplit.h"
+#include "../include/PartitionManifest.h"
+#include "../include/ProcessOrchestrator.h"
+#include "../include/ReducerOutputMerger.h"
 
+namespace fs = std::filesystem;
+
+// Accepts any number of worker_stub connections and hands them map and reduce
+// tasks as they free up. With `job`, plans a whole MapReduce job, runs it on
+// the connected workers and merges the reducer outputs; otherwise tasks are
+// typed in interactively.
 class Controller : public SocketInterface
 {
-    int sock;
-    sockaddr_in server_addr{};
-    std::string command;
+    ControllerService service;
+    ProcessOrchestratorDLL orchestrator; // Job settings from config.txt; plans range partitions
+    uint16_t port;
+    size_t min_workers;
+    std::vector<std::string> job_args; // inputDir outputDir tempDir M R, or empty
     std::string initial_command;
-    bool running = true;
+    std::string pending_input;
 
 public:
-    Controller(const std::string &cmd = "") : initial_command(cmd) {}
+    Controller(uint16_t port, size_t min_workers, const ControllerService::Policy &policy, const std::vector<std::string> &job_args,
+               const std::string &cmd = "")
+        : port(port), min_workers(min_workers), job_args(job_args), initial_command(cmd)
+    {
+        service.setPolicy(policy);
+    }
 
     bool initialize() override
     {
-        sock = socket(AF_INET, SOCK_STREAM, 0);
-        if (sock < 0)
+        // Console gets the log too; the file keeps it after the terminal is gone
+        fs::path log_path = "controller.log";
+        if (!job_args.empty())
         {
-            perror("socket");
-            return false;
+            log_path = fs::absolute(job_args[2]) / "logs" / "controller.log";
+            fs::create_directories(log_path.parent_path());
         }
+        Logger::getInstance().configureLogFilePath(log_path.string());
 
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_port = htons(54000);
-        server_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
-
+        std::string error;
+        if (!service.listen(port, error))
+        {
+            std::cerr << error << std::endl;
+            return false;
+        }
+        service.setMinWorkers(min_workers);
+        std::cout << "Controller listening on port " << service.port() << "; start workers with: worker_stub " << service.port() << std::endl;
         return true;
     }
 
     void run() override
     {
-        if (connect(sock, (sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+        if (!job_args.empty())
         {
-            perror("connect");
+            exit_code = run_job() ? 0 : 1;
             return;
         }
 
-        // Start listener for heartbeats and other messages
-        std::thread listener_thread(&Controller::listen_for_messages, this);
-        listener_thread.detach();
-
         if (!initial_command.empty())
+            handle_command(initial_command);
+
+        // Interactive mode: stdin is just another descriptor on the event loop
+        std::string error;
+        std::cout << "Enter commands (map ..., reduce ..., stage, workers, exit):" << std::endl;
+        if (!service.watch(STDIN_FILENO, [this]() { read_stdin(); }, error) || !service.serve(error))
         {
-            std::string transformed_command = transform_command(initial_command);
-            send(sock, transformed_command.c_str(), transformed_command.size(), 0);
-            std::cout << "Command sent: " << transformed_command << std::endl;
+            std::cerr << error << std::endl;
+            exit_code = 1;
+        }
+    }
 
-            if (transformed_command == "exit")
-            {
-                running = false;
-                return;
-            }
+    void cleanup() override
+    {
+        service.shutdownWorkers();
+        service.close();
+    }
+
+    int exit_code = 0;
+
+private:
+    bool run_job()
+    {
+        std::string input_dir = job_args[0];
+        fs::path output_dir = fs::absolute(job_args[1]);
+        fs::path temp_dir = fs::absolute(job_args[2]);
+        int num_mappers = std::stoi(job_args[3]);
+        int num_reducers = std::stoi(job_args[4]);
+        if (num_mappers <= 0 || num_reducers <= 0)
+        {
+            std::cerr << "M and R must be positive." << std::endl;
+            return false;
         }
 
-        // Interactive mode
-        while (running)
+        std::vector<std::string> input_files;
+        if (!FileHandler::validate_directory(input_dir, input_files, input_dir, false) || input_files.empty())
         {
-            std::cout << "Enter command (or exit to quit): ";
-            std::getline(std::cin, command);
+            std::cerr << "No input files found in " << job_args[0] << std::endl;
+            return false;
+        }
+        for (auto &file : input_files)
+            file = fs::absolute(file).string();
 
-            if (command.empty())
-                continue;
+        // Same config.txt the workers read, so splits and partitioning match a local run
+        orchestrator.loadConfig();
+        orchestrator.applyLoggerConfig();
+        size_t split_size = orchestrator.getConfig().getInputSplitSize().value_or(InputSplitPlanner::DEFAULT_SPLIT_SIZE);
+        std::vector<InputSplit> splits = InputSplitPlanner::plan(input_files, split_size);
+        std::vector<std::vector<InputSplit>> assignments = InputSplitPlanner::assign(splits, num_mappers);
+        Logger::getInstance().log("CONTROLLER: Planned " + std::to_string(splits.size()) + " input splits from " +
+                                  std::to_string(input_files.size()) + " files (split size " + std::to_string(split_size) + " bytes).");
 
-            std::string transformed_command = transform_command(command);
-            send(sock, transformed_command.c_str(), transformed_command.size(), 0);
-            std::cout << "Command sent: " << transformed_command << std::endl;
+        fs::path log_dir = temp_dir / "logs";
+        fs::create_directories(log_dir);
+        fs::create_directories(output_dir);
 
-            if (transformed_command == "exit")
-            {
-                running = false;
-                break;
-            }
+        // Map tasks load the boundaries from tempDir, so they are planned before stage 1.
+        // A job whose ranges cannot be planned is refused rather than silently hashed.
+        if (orchestrator.getConfig().getPartitionScheme().value_or(PartitionScheme::HASH) == PartitionScheme::RANGE && num_reducers > 1 &&
+            !orchestrator.planRangePartitions(splits, num_reducers, temp_dir.string()))
+        {
+            std::cerr << "partitioner=range: could not plan key ranges in " << temp_dir.string()
+                      << " (see controller.log); set partitioner=hash to run this job." << std::endl;
+            return false;
         }
-    }
+        PartitionManifest::clearJob(temp_dir.string());
+        ProcessOrchestratorDLL::clearReducerOutputs(output_dir.string());
 
-    std::string transform_command(const std::string &raw_command)
-    {
-        std::istringstream iss(raw_command);
-        std::string program, subcommand;
-        iss >> program >> subcommand;
-
-        if (program == "./mapreduce" && (subcommand == "mapper" || subcommand == "reducer"))
+        // Stage 1: mappers. Stage 2: reducers, once every mapper has committed.
+        for (int m = 0; m < num_mappers; ++m)
         {
-            std::string new_command = (subcommand == "mapper") ? "map" : "reduce";
-            std::string remaining_args;
-            std::getline(iss, remaining_args);
-            return new_command + remaining_args; // include the leading space from getline
+            TaskAssignment task{"map", {temp_dir.string(), std::to_string(m), std::to_string(num_reducers), "2", "4",
+                                        (log_dir / ("mapper_" + std::to_string(m) + ".log")).string()}};
+            for (const auto &split : assignments[m])
+                task.args.push_back(split.toString());
+            service.submit(task);
+        }
+        service.nextStage();
+        for (int r = 0; r < num_reducers; ++r)
+        {
+            service.submit(TaskAssignment{"reduce", {output_dir.string(), temp_dir.string(), std::to_string(r), "2", "4",
+                                                     (log_dir / ("reducer_" + std::to_string(r) + ".log")).string()}});
         }
 
-        // If it's not a ./mapreduce command, send as-is
-        return raw_command;
-    }
+        std::cout << "Waiting for " << min_workers << " worker(s) to run " << num_mappers << " map and " << num_reducers << " reduce tasks..." << std::endl;
+        std::string error;
+        if (!service.runUntilDone(error))
+        {
+            std::cerr << "Job failed: " << error << std::endl;
+            return false;
+        }
 
-    void listen_for_messages()
-    {
-        char buffer[1024];
+        std::set<std::string> workers_used;
+        for (const auto &outcome : service.outcomes())
+            workers_used.insert(outcome.worker);
+        size_t backups_won = 0;
+        for (const auto &outcome : service.outcomes())
+            backups_won += outcome.backup ? 1 : 0;
+        std::cout << "All " << service.outcomes().size() << " tasks finished on " << workers_used.size() << " worker(s); "
+                  << service.backupsLaunched() << " backup copies started, " << backups_won << " finished first." << std::endl;
 
-        while (running)
+        // Reducer outputs are key-sorted; merge them into the final results
+        ReducerOutputMerger merger;
+        for (int r = 0; r < num_reducers; ++r)
         {
-            memset(buffer, 0, sizeof(buffer));
-            ssize_t bytes_received = recv(sock, buffer, sizeof(buffer) - 1, 0);
-
-            if (bytes_received <= 0)
+            fs::path reducer_output = output_dir / ("reducer_" + std::to_string(r) + ".txt");
+            if (fs::exists(reducer_output) && !merger.addFile(reducer_output.string()))
             {
-                std::cout << "Connection closed or error." << std::endl;
-                running = false;
-                break;
+                std::cerr << "Could not read " << reducer_output << std::endl;
+                return false;
             }
+        }
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        ThreadPool pool(threads, threads);
+        bool merged = merger.mergeTo((output_dir / "output.txt").string(), (output_dir / "output_summed.txt").string(), pool, 2 * threads, error);
+        pool.shutdown();
+        if (!merged)
+        {
+            std::cerr << "Final reduction failed: " << error << std::endl;
+            return false;
+        }
+        std::cout << "Merged " << merger.keyCount() << " keys into " << (output_dir / "output.txt").string() << std::endl;
+        return true;
+    }
 
-            std::string msg(buffer);
-            std::cout << "\n[Worker Message] " << msg << std::endl;
+    void read_stdin()
+    {
+        char buffer[4096];
+        ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            handle_command("exit"); // End of input
+            return;
+        }
+        pending_input.append(buffer, static_cast<size_t>(count));
+        size_t newline;
+        while ((newline = pending_input.find('\n')) != std::string::npos)
+        {
+            std::string line = pending_input.substr(0, newline);
+            pending_input.erase(0, newline + 1);
+            handle_command(line);
         }
     }
 
-    void cleanup() override
+    void handle_command(const std::string &raw_command)
     {
-        close(sock);
+        std::istringstream iss(raw_command);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> token)
+            tokens.push_back(token);
+        if (tokens.empty())
+            return;
+
+        // "./mapreduce mapper|reducer ..." is accepted as well as "map|reduce ..."
+        if (tokens.size() >= 2 && tokens[0] == "./mapreduce" && (tokens[1] == "mapper" || tokens[1] == "reducer"))
+        {
+            tokens.erase(tokens.begin());
+            tokens[0] = (tokens[0] == "mapper") ? "map" : "reduce";
+        }
+
+        if (tokens[0] == "exit")
+        {
+            std::cout << "Shutting down workers" << std::endl;
+            service.stop();
+        }
+        else if (tokens[0] == "stage")
+        {
+            service.nextStage();
+            std::cout << "Tasks entered next wait for the earlier ones to finish" << std::endl;
+        }
+        else if (tokens[0] == "workers")
+        {
+            std::cout << service.workerCount() << " worker(s), " << service.runningCount() << " task(s) running, "
+                      << service.pendingCount() << " queued" << std::endl;
+            for (const auto &line : service.describeWorkers())
+                std::cout << "  " << line << std::endl;
+        }
+        else if (tokens[0] == "map" || tokens[0] == "reduce")
+        {
+            TaskAssignment task;
+            task.command = tokens[0];
+            task.args.assign(tokens.begin() + 1, tokens.end());
+            service.submit(task);
+            std::cout << "Queued " << task.command << " task with " << task.args.size() << " arguments" << std::endl;
+        }
+        else
+        {
+            std::cout << "Unknown command: " << tokens[0] << " (expected map, reduce, stage, workers or exit)" << std::endl;
+        }
     }
 };
 
 int main(int argc, char *argv[])
 {
+    uint16_t port = 54000;
+    size_t min_workers = 1;
+    ControllerService::Policy policy;
+    std::vector<std::string> job_args;
     std::string initial_command;
 
-    if (argc > 1)
+    int i = 1;
+    for (; i + 1 < argc && argv[i][0] == '-' && argv[i][1] == '-'; i += 2)
     {
-        for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--port") == 0)
+            port = static_cast<uint16_t>(std::stoi(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--workers") == 0)
+            min_workers = std::stoul(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--heartbeat-timeout") == 0)
+            policy.heartbeatTimeout = std::chrono::milliseconds(std::stoul(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--speculation") == 0)
+            policy.speculate = std::strcmp(argv[i + 1], "off") != 0;
+        else
+            break;
+    }
+
+    if (i < argc && std::strcmp(argv[i], "job") == 0)
+    {
+        if (argc - i != 6)
+        {
+            std::cerr << "Usage: controller [--port N] [--workers N] [--heartbeat-timeout MS] [--speculation on|off] "
+                         "job <inputDir> <outputDir> <tempDir> <M> <R>"
+                      << std::endl;
+            return 1;
+        }
+        job_args.assign(argv + i + 1, argv + argc);
+    }
+    else
+    {
+        for (; i < argc; ++i)
         {
             initial_command += argv[i];
             if (i < argc - 1)
@@ -138,11 +305,10 @@ int main(int argc, char *argv[])
         }
     }
 
-    Controller ctrl(initial_command);
-    if (ctrl.initialize())
-    {
-        ctrl.run();
-        ctrl.cleanup();
-    }
-    return 0;
+    Controller ctrl(port, min_workers, policy, job_args, initial_command);
+    if (!ctrl.initialize())
+        return 1;
+    ctrl.run();
+    ctrl.cleanup();
+    return ctrl.exit_code;
 }
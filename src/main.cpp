@@ -5,6 +5,7 @@
     #include "..\include\Mapper_DLL_so.h" 
     #include "..\include\Reducer_DLL_so.h" 
     #include "..\include\ProcessOrchestrator.h"
+    #include "..\include\InputSplit.h"
     #include "..\include\InteractiveMode.h"
 #elif defined(__unix__) || defined(__APPLE__) && defined(__MACH__)
     #include "../include/ERROR_Handler.h"
@@ -13,6 +14,7 @@
     #include "../include/Mapper_DLL_so.h" 
     #include "../include/Reducer_DLL_so.h" 
     #include "../include/ProcessOrchestrator.h"
+    #include "../include/InputSplit.h"
     #include "../include/InteractiveMode.h"
 #else
     #error "Unsupported operating system. Please utilize Windows, MacOS, or any Linux distribution to operate this C++ program."
@@ -41,6 +43,7 @@ enum class AppMode {
     MAPPER,
     REDUCER,
     INTERACTIVE,
+    DECODE_LOG,
     UNKNOWN
 };
 
@@ -54,6 +57,7 @@ AppMode parseMode(const std::string& modeStr) {
     if (lowerModeStr == "mapper") return AppMode::MAPPER;
     if (lowerModeStr == "reducer") return AppMode::REDUCER;
     if (lowerModeStr == "interactive") return AppMode::INTERACTIVE;
+    if (lowerModeStr == "decode-log") return AppMode::DECODE_LOG;
     return AppMode::UNKNOWN;
 }
 
@@ -78,6 +82,12 @@ int main(int argc, char* argv[]) {
     logger.setPrefix("[MAIN] ");
 
     ProcessOrchestratorDLL orchestrator;
+    orchestrator.loadConfig();
+    orchestrator.applyLoggerConfig();
+    // A worker running a reassigned or backup copy of a task numbers the attempt
+    if (const char* attempt = std::getenv("MAPREDUCE_TASK_ATTEMPT")) {
+        orchestrator.setTaskAttempt(static_cast<uint32_t>(std::strtoul(attempt, nullptr, 10)));
+    }
 
     if (argc > 1) {
         std::string modeStr = argv[1];
@@ -137,54 +147,82 @@ int main(int argc, char* argv[]) {
                         bool mapperOutputsReady = false;
 
                         std::vector<std::thread> mapperThreads;
-                        std::vector<std::vector<std::string>> mapperFileAssignments(numMappers);
 
-                        for (size_t i = 0; i < allInputFiles.size(); ++i) {
-                            if (numMappers > 0) { 
-                                mapperFileAssignments[i % numMappers].push_back(allInputFiles[i]);
-                            }
+                        // Cut inputs into line-aligned splits and balance them across mappers by size
+                        size_t splitSize = orchestrator.getConfig().getInputSplitSize().value_or(InputSplitPlanner::DEFAULT_SPLIT_SIZE);
+                        std::vector<InputSplit> inputSplits = InputSplitPlanner::plan(allInputFiles, splitSize);
+                        std::vector<std::vector<InputSplit>> mapperSplitAssignments = InputSplitPlanner::assign(inputSplits, numMappers);
+                        logger.log("CONTROLLER: Planned " + std::to_string(inputSplits.size()) + " input splits from " +
+                                   std::to_string(allInputFiles.size()) + " files (split size " + std::to_string(splitSize) + " bytes).");
+
+                        // Range partitioning samples the splits once here; every mapper then uses the same boundaries
+                        if (orchestrator.getConfig().getPartitionScheme().value_or(PartitionScheme::HASH) == PartitionScheme::RANGE) {
+                            orchestrator.planRangePartitions(inputSplits, numReducers, tempDir);
                         }
                         
-                        logger.log("CONTROLLER: Launching " + std::to_string(numMappers) + " mapper processes/threads.");
-                        for (int i = 0; i < numMappers; ++i) {
-                            mapperThreads.emplace_back([&logger, &orchestrator, tempDir, i, numReducers, files = mapperFileAssignments[i], partitionPrefix, partitionSuffix]() mutable { 
-                                logger.log("CONTROLLER: Starting mapper thread/process " + std::to_string(i) + " with " + std::to_string(files.size()) + " files.");
-                                orchestrator.runMapper(tempDir, i, numReducers, files, 2, 4); // Assuming ProcessOrchestratorDLL::runMapper is updated
-                                logger.log("CONTROLLER: Mapper thread/process " + std::to_string(i) + " finished.");
-                            });
+                        // Manifests and per-mapper partitions of an earlier job must not be read as this job's
+                        PartitionManifest::clearJob(tempDir);
+                        ProcessOrchestratorDLL::clearReducerOutputs(outputDir);
+
+                        ExecutionMode executionMode = orchestrator.getConfig().getExecutionMode().value_or(ExecutionMode::THREADS);
+                        if (executionMode == ExecutionMode::PROCESSES && !ProcessLauncher::supported()) {
+                            logger.log("CONTROLLER: Worker processes are not supported on this platform; using threads.", Logger::Level::WARNING);
+                            executionMode = ExecutionMode::THREADS;
                         }
 
-                        logger.log("CONTROLLER: Launching " + std::to_string(numReducers) + " reducer processes/threads.");
-                        std::vector<std::thread> reducerThreads;
-                        for (int i = 0; i < numReducers; ++i) {
-                            reducerThreads.emplace_back([&logger, &orchestrator, &cvReducers, &mtxReducers, &mapperOutputsReady, outputDir, tempDir, i]() mutable {
-                                logger.log("CONTROLLER: Reducer thread/process " + std::to_string(i) + " created, waiting for mapper signal.");
-                                std::unique_lock<std::mutex> lock(mtxReducers); 
-                                cvReducers.wait(lock, [&mapperOutputsReady]() { return mapperOutputsReady; }); 
-                                logger.log("CONTROLLER: Reducer thread/process " + std::to_string(i) + " received signal, starting reduction.");
-                                orchestrator.runReducer(outputDir, tempDir, i, 2, 4); // Assuming ProcessOrchestratorDLL::runReducer is updated
-                                logger.log("CONTROLLER: Reducer thread/process " + std::to_string(i) + " finished.");
-                            });
-                        }
-                        logger.log("CONTROLLER: All reducer threads created.");
+                        if (executionMode == ExecutionMode::PROCESSES) {
+                            logger.log("CONTROLLER: Launching " + std::to_string(numMappers) + " mapper and " + std::to_string(numReducers) + " reducer processes.");
+                            std::string executable = ProcessLauncher::currentExecutable(argv[0]);
+                            if (!orchestrator.runWorkerProcesses(executable, mapperSplitAssignments, numReducers, outputDir, tempDir)) {
+                                logger.log("CONTROLLER: Worker processes failed; no final output was produced.", Logger::Level::ERROR);
+                                cmdModeSuccess = false;
+                                break;
+                            }
+                            logger.log("CONTROLLER: All worker processes completed.");
+                        } else {
+                            logger.log("CONTROLLER: Launching " + std::to_string(numMappers) + " mapper processes/threads.");
+                            for (int i = 0; i < numMappers; ++i) {
+                                mapperThreads.emplace_back([&logger, &orchestrator, tempDir, i, numReducers, splits = mapperSplitAssignments[i], partitionPrefix, partitionSuffix]() mutable { 
+                                    size_t splitBytes = 0;
+                                    for (const auto& split : splits) splitBytes += split.length;
+                                    logger.log("CONTROLLER: Starting mapper thread/process " + std::to_string(i) + " with " + std::to_string(splits.size()) +
+                                               " splits (" + std::to_string(splitBytes) + " bytes).");
+                                    orchestrator.runMapper(tempDir, i, numReducers, splits, 2, 4); // Assuming ProcessOrchestratorDLL::runMapper is updated
+                                    logger.log("CONTROLLER: Mapper thread/process " + std::to_string(i) + " finished.");
+                                });
+                            }
 
-                        logger.log("CONTROLLER: Waiting for all mapper processes/threads to complete...");
-                        for (auto &t : mapperThreads) {
-                            if (t.joinable()) t.join();
-                        }
-                        logger.log("CONTROLLER: All mapper processes/threads completed.");
+                            logger.log("CONTROLLER: Launching " + std::to_string(numReducers) + " reducer processes/threads.");
+                            std::vector<std::thread> reducerThreads;
+                            for (int i = 0; i < numReducers; ++i) {
+                                reducerThreads.emplace_back([&logger, &orchestrator, &cvReducers, &mtxReducers, &mapperOutputsReady, outputDir, tempDir, i]() mutable {
+                                    logger.log("CONTROLLER: Reducer thread/process " + std::to_string(i) + " created, waiting for mapper signal.");
+                                    std::unique_lock<std::mutex> lock(mtxReducers); 
+                                    cvReducers.wait(lock, [&mapperOutputsReady]() { return mapperOutputsReady; }); 
+                                    logger.log("CONTROLLER: Reducer thread/process " + std::to_string(i) + " received signal, starting reduction.");
+                                    orchestrator.runReducer(outputDir, tempDir, i, 2, 4); // Assuming ProcessOrchestratorDLL::runReducer is updated
+                                    logger.log("CONTROLLER: Reducer thread/process " + std::to_string(i) + " finished.");
+                                });
+                            }
+                            logger.log("CONTROLLER: All reducer threads created.");
 
-                        logger.log("CONTROLLER: Initiating distinct sorting step for intermediate data (conceptual).");
-                        // orchestrator.performIntermediateSort(tempDir, numReducers, partitionPrefix, partitionSuffix);
-                        logger.log("CONTROLLER: Distinct sorting step for intermediate data completed (conceptual).");
+                            logger.log("CONTROLLER: Waiting for all mapper processes/threads to complete...");
+                            for (auto &t : mapperThreads) {
+                                if (t.joinable()) t.join();
+                            }
+                            logger.log("CONTROLLER: All mapper processes/threads completed.");
+
+                            // No separate sort step: mappers write key-sorted runs and each reducer merges them
+                            logger.log("CONTROLLER: Intermediate partitions are key-sorted runs; reducers will merge them.");
 
-                        signalReducers(cvReducers, mtxReducers, mapperOutputsReady);
+                            signalReducers(cvReducers, mtxReducers, mapperOutputsReady);
 
-                        logger.log("CONTROLLER: Waiting for all reducer processes/threads to complete...");
-                        for (auto &t : reducerThreads) {
-                           if (t.joinable()) t.join();
+                            logger.log("CONTROLLER: Waiting for all reducer processes/threads to complete...");
+                            for (auto &t : reducerThreads) {
+                               if (t.joinable()) t.join();
+                            }
+                            logger.log("CONTROLLER: All reducer processes/threads completed.");
                         }
-                        logger.log("CONTROLLER: All reducer processes/threads completed.");
 
                         logger.log("CONTROLLER: Performing final reduction/aggregation step.");
                         orchestrator.runFinalReducer(outputDir, tempDir); // Assuming ProcessOrchestratorDLL::runFinalReducer is updated
@@ -211,6 +249,7 @@ int main(int argc, char* argv[]) {
                         }
 
                         std::string tempDir = argv[2];
+                        int mapperId = std::stoi(argv[3]);
                         int numReducers = std::stoi(argv[4]);
 
                         size_t minThreads = std::thread::hardware_concurrency();
@@ -231,28 +270,21 @@ int main(int argc, char* argv[]) {
 
                         logger.configureLogFilePath(logPath);
                         logger.setPrefix("[MAPPER] ");
+                        if (!orchestrator.applyWorkerLimits()) {
+                            cmdModeSuccess = false;
+                            break;
+                        }
 
-                        ErrorHandler errorHandler;
-
-                        Mapper mapper(logger, errorHandler);
+                        if (orchestrator.getConfig().getPartitionScheme().value_or(PartitionScheme::HASH) == PartitionScheme::RANGE) {
+                            orchestrator.loadRangePartitions(tempDir, numReducers);
+                        }
 
-                        std::vector<std::pair<std::string, int>> mappedData;
+                        // Each input is a file path or a split spec "<path>@<offset>+<length>"
+                        std::vector<InputSplit> inputSplits;
                         for (int i = inputFilesStartIdx; i < argc; ++i) {
-                            std::vector<std::string> lines;
-                            if (!FileHandler::read_file(argv[i], lines)) {
-                                logger.log("Failed to read input file: " + std::string(argv[i]), Logger::Level::ERROR);
-                                continue;
-                            }
-                            for (const auto& line : lines) {
-                                mapper.map(argv[i], line, mappedData);
-                            }
+                            inputSplits.push_back(InputSplit::parse(argv[i]));
                         }
-
-                        // Use partitioning
-                        std::string partitionPrefix = "partition_";
-                        std::string partitionSuffix = ".txt";
-                        if (!mapper.exportPartitionedData(tempDir, mappedData, numReducers, partitionPrefix, partitionSuffix)) {
-                            logger.log("Mapper failed to export partitioned data.", Logger::Level::ERROR);
+                        if (!orchestrator.runMapper(tempDir, mapperId, numReducers, inputSplits, minThreads, maxThreads)) {
                             cmdModeSuccess = false;
                             break;
                         }
@@ -264,7 +296,7 @@ int main(int argc, char* argv[]) {
                     case AppMode::REDUCER: {
                         logger.log("Running in REDUCER mode (invoked directly - usually by orchestrator).");
                         if (argc < 6) { 
-                            ErrorHandler::reportError("Reducer usage: <executable> reducer <outputDir> <tempDir> <reducerId> [minThreads maxThreads] <reducerLogPath>", true);
+                            ErrorHandler::reportError("Reducer usage: <executable> reducer <outputDir> <tempDir> <reducerId> [minThreads maxThreads] <reducerLogPath> [<numMappers>]", true);
                         }
 
                         std::string outputDir = argv[2];
@@ -289,47 +321,54 @@ int main(int argc, char* argv[]) {
 
                         logger.configureLogFilePath(logPath);
                         logger.setPrefix("[REDUCER] ");
-
-                        // Find all partition files for this reducer
-                        std::vector<std::string> partitionFiles;
-                        for (const auto& entry : fs::directory_iterator(tempDir)) {
-                            if (entry.is_regular_file()) {
-                                std::string fname = entry.path().filename().string();
-                                std::string expected = "partition_" + std::to_string(reducerId) + ".txt";
-                                if (fname == expected) {
-                                    partitionFiles.push_back(entry.path().string());
-                                }
-                            }
+                        logger.log("Reducer thread configuration: min=" + std::to_string(minThreads) + ", max=" + std::to_string(maxThreads));
+                        if (!orchestrator.applyWorkerLimits()) {
+                            cmdModeSuccess = false;
+                            break;
                         }
 
-                        if (partitionFiles.empty()) {
-                            logger.log("No partition files found for reducer " + std::to_string(reducerId) + " in " + tempDir, Logger::Level::WARNING);
-                            cmdModeSuccess = true;
+                        // With a mapper count, shuffle each mapper's partition as soon as it commits
+                        if (argc > logArgIdx + 1) {
+                            int numMappers = std::stoi(argv[logArgIdx + 1]);
+                            cmdModeSuccess = orchestrator.runPipelinedReducer(outputDir, tempDir, reducerId, numMappers);
+                            logger.log(cmdModeSuccess ? "Reducer completed successfully." : "Reducer failed.",
+                                       cmdModeSuccess ? Logger::Level::INFO : Logger::Level::ERROR);
                             break;
                         }
 
-                        std::vector<std::pair<std::string, int>> allMappedData;
-                        for (const auto& file : partitionFiles) {
-                            std::vector<std::pair<std::string, int>> mappedData;
-                            FileHandler::read_mapped_data(file, mappedData);
-                            allMappedData.insert(allMappedData.end(), mappedData.begin(), mappedData.end());
+                        cmdModeSuccess = orchestrator.runReducer(outputDir, tempDir, reducerId, minThreads, maxThreads);
+                        break;
+                    }
+                    case AppMode::DECODE_LOG: {
+                        if (argc < 4) {
+                            ErrorHandler::reportError("Decode usage: <executable> decode-log <binaryLogFile> <outputFile>", true);
                         }
+                        std::string binaryLogPath = argv[2];
+                        std::string outputPath = argv[3];
 
-                        std::map<std::string, int> reducedData;
-                        ReducerDLLso reducer;
-                        reducer.reduce(allMappedData, reducedData, minThreads, maxThreads);
-
-                        // Write output
-                        fs::create_directories(outputDir);
-                        std::string outputPath = (fs::path(outputDir) / ("reducer_" + std::to_string(reducerId) + ".txt")).string();
-                        if (!FileHandler::write_output(outputPath, reducedData)) {
-                            logger.log("Failed to write reducer output: " + outputPath, Logger::Level::ERROR);
+                        MappedFile binaryLog;
+                        if (!binaryLog.open(binaryLogPath)) {
+                            ErrorHandler::reportError("Could not open binary log: " + binaryLogPath, false);
                             cmdModeSuccess = false;
                             break;
                         }
-
-                        logger.log("Reducer completed successfully. Output written to: " + outputPath);
-                        cmdModeSuccess = true;
+                        std::string text;
+                        std::string error;
+                        bool decoded = Logger::decodeBinaryLog(binaryLog.view(), text, error);
+                        if (!decoded) {
+                            // Keep the lines decoded before the damage; a crash can truncate the last record
+                            ErrorHandler::reportError("Binary log " + binaryLogPath + ": " + error, false);
+                        }
+                        std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+                        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                        out.close();
+                        if (out.fail()) {
+                            ErrorHandler::reportError("Could not write decoded log: " + outputPath, false);
+                            cmdModeSuccess = false;
+                            break;
+                        }
+                        logger.log("Decoded binary log " + binaryLogPath + " into " + outputPath);
+                        cmdModeSuccess = decoded;
                         break;
                     }
                     default: // Should not happen if parseMode is correct
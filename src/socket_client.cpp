@@ -1,11 +1,15 @@
 #include "../include/socket_client.h"
 #include <sys/socket.h>
+#include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
+#include <chrono>
 #include <cstring>
 #include <iostream>
+#include <thread>
 
-SocketClient::SocketClient(int port) : port(port) {}
+SocketClient::SocketClient(int port, const std::string &host) : port(port), host(host) {}
 
 SocketClient::~SocketClient()
 {
@@ -14,85 +18,58 @@ SocketClient::~SocketClient()
 
 bool SocketClient::initialize()
 {
-    server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd == -1)
-    {
-        perror("socket failed");
-        return false;
-    }
-
     sockaddr_in address{};
     address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY; // Listen on all interfaces
     address.sin_port = htons(port);
-
-    // Allow reuse of the port immediately after program exits
-    int opt = 1;
-
-    // Set SO_REUSEADDR
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0)
-    {
-        perror("setsockopt SO_REUSEADDR failed");
-        return false;
-    }
-
-    // Set SO_REUSEPORT (optional, but if you want it, you must set it separately)
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
-    {
-        perror("setsockopt SO_REUSEPORT failed");
-        return false;
-    }
-
-    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0)
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)
     {
-        perror("bind failed");
+        std::cerr << "Invalid controller address: " << host << std::endl;
         return false;
     }
 
-    if (listen(server_fd, 1) < 0)
+    const int attempts = 50;
+    for (int attempt = 1; attempt <= attempts; ++attempt)
     {
-        perror("listen failed");
-        return false;
-    }
-
-    std::cout << "Server listening on port " << port << std::endl;
-
-    // Accept one client connection (blocking)
-    socklen_t addrlen = sizeof(address);
-    client_fd = accept(server_fd, (struct sockaddr *)&address, &addrlen);
-    if (client_fd < 0)
-    {
-        perror("accept failed");
-        return false;
+        client_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (client_fd == -1)
+        {
+            perror("socket failed");
+            return false;
+        }
+        if (connect(client_fd, (struct sockaddr *)&address, sizeof(address)) == 0)
+        {
+            int no_delay = 1;
+            setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            std::cout << "Connected to controller at " << host << ":" << port << std::endl;
+            return true;
+        }
+        close(client_fd);
+        client_fd = -1;
+        if (attempt == attempts)
+        {
+            perror("connect failed");
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
-
-    std::cout << "Client connected" << std::endl;
-    return true;
+    return false;
 }
 
-std::string SocketClient::receive()
+bool SocketClient::receive(Frame &frame)
 {
     if (client_fd < 0)
-        return "";
+        return false;
 
-    char buffer[1024];
-    memset(buffer, 0, sizeof(buffer));
-    ssize_t valread = read(client_fd, buffer, sizeof(buffer) - 1);
-    if (valread <= 0)
+    std::string error;
+    if (!reader.receive(client_fd, frame, error))
     {
-        if (valread == 0)
+        if (error.empty())
             std::cout << "Client disconnected" << std::endl;
         else
-            perror("read failed");
-        return "";
+            std::cerr << "receive failed: " << error << std::endl;
+        return false;
     }
-
-    // Return received string (trim trailing \n or \r if needed)
-    std::string msg(buffer);
-    if (!msg.empty() && (msg.back() == '\n' || msg.back() == '\r'))
-        msg.pop_back();
-
-    return msg;
+    return true;
 }
 
 void SocketClient::run()
@@ -107,15 +84,9 @@ void SocketClient::cleanup()
         close(client_fd);
         client_fd = -1;
     }
-
-    if (server_fd >= 0)
-    {
-        close(server_fd);
-        server_fd = -1;
-    }
 }
 
-bool SocketClient::transmit(const std::string &message)
+bool SocketClient::transmit(FrameType type, uint32_t request_id, std::string_view payload)
 {
     if (client_fd < 0)
     {
@@ -123,12 +94,12 @@ bool SocketClient::transmit(const std::string &message)
         return false;
     }
 
-    ssize_t bytes_sent = send(client_fd, message.c_str(), message.length(), 0);
-    if (bytes_sent < 0)
+    std::lock_guard<std::mutex> lock(send_mutex);
+    std::string error;
+    if (!FrameProtocol::sendFrame(client_fd, type, request_id, payload, error))
     {
-        perror("send failed");
+        std::cerr << error << std::endl;
         return false;
     }
-
-    return bytes_sent == (ssize_t)message.length();
+    return true;
 }
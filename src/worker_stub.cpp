@@ -1,129 +1,234 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
-#include <sstream>
+#include <thread>
 #include <vector>
+#include <cstdlib>
 #include <unistd.h>
 #include <sys/wait.h>
 #include "../include/socket_client.h" // Use the concrete class
+#include "../include/Logger.h"
+#include "../include/WorkerExecutor.h"
 
-SocketClient client(0); // Will initialize with correct port in main
+SocketClient *client = nullptr;        // Connected in main
+WorkerExecutor *executor = nullptr;    // Runs tasks in-process; null with --exec
 
-void sendStatus(const std::string &status)
+std::mutex exec_mutex;
+std::set<uint32_t> exec_running; // --exec mode: request IDs with a child process
+
+void sendStatus(uint32_t request_id, const std::string &status)
 {
-    std::string message = "status:" + status;
-    client.transmit(message);
-    std::cout << "[Worker Status] " << status << std::endl;
+    client->transmit(FrameType::STATUS, request_id, status);
+    std::cout << "[Worker Status] #" << request_id << " " << status << std::endl;
+}
+
+// Running tasks and their progress. Child processes (--exec) cannot report
+// progress, so their tasks are listed as 0/0: alive, rate unknown.
+WorkerHeartbeat currentHeartbeat()
+{
+    WorkerHeartbeat heartbeat;
+    if (executor)
+    {
+        heartbeat.tasks = executor->progress();
+        return heartbeat;
+    }
+    std::lock_guard<std::mutex> lock(exec_mutex);
+    for (uint32_t request_id : exec_running)
+        heartbeat.tasks.emplace_back(request_id, TaskProgress{});
+    return heartbeat;
 }
 
-void fork_and_run(const std::string &prog, const std::string &args)
+// Runs prog with args and returns its exit code (-1 if it could not run or was killed).
+// `attempt` reaches the child as MAPREDUCE_TASK_ATTEMPT.
+int fork_and_run(const std::string &prog, const std::vector<std::string> &args, uint32_t attempt)
 {
+    // Build argv before forking; the child only calls exec
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(prog.c_str()));
+    for (const auto &arg : args)
+    {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
     pid_t pid = fork();
     if (pid == 0)
     {
         // Child process
-        std::istringstream iss(args);
-        std::vector<std::string> tokens;
-        std::string token;
-        while (iss >> token)
-        {
-            tokens.push_back(token);
-        }
-
-        char *argv[tokens.size() + 2];
-        argv[0] = const_cast<char *>(prog.c_str());
-        for (size_t i = 0; i < tokens.size(); ++i)
-        {
-            argv[i + 1] = const_cast<char *>(tokens[i].c_str());
-        }
-        argv[tokens.size() + 1] = nullptr;
-
-        execvp(prog.c_str(), argv);
+        setenv("MAPREDUCE_TASK_ATTEMPT", std::to_string(attempt).c_str(), 1);
+        execvp(prog.c_str(), argv.data());
         perror("execvp failed");
-        exit(1);
+        _exit(1);
     }
     else if (pid > 0)
     {
         // Parent process
         int status;
-        waitpid(pid, &status, 0);
-    }
-    else
-    {
-        perror("fork failed");
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status))
+            return -1;
+        return WEXITSTATUS(status);
     }
+    perror("fork failed");
+    return -1;
 }
 
-void handleMessage(const std::string &message)
+// --exec mode: runs one task as a ./mapreduce child process. Several run at
+// once, each on its own thread and reporting under its own request ID.
+void runTask(uint32_t request_id, TaskAssignment task)
 {
-    std::istringstream iss(message);
-    std::string command;
-    iss >> command;
-
-    if (command == "map")
+    sendStatus(request_id, "job started");
+    client->transmit(FrameType::PROGRESS, request_id, FrameProtocol::encode(TaskProgress{0, 1}));
     {
-        std::string args;
-        std::getline(iss, args);
-        if (!args.empty() && args[0] == ' ')
-            args = args.substr(1); // Trim leading space
-
-        sendStatus("job started");
-        sendStatus("job processing");
-        fork_and_run("./mapreduce", "mapper " + args);
-        sendStatus("job completed");
+        std::lock_guard<std::mutex> lock(exec_mutex);
+        exec_running.insert(request_id);
     }
-    else if (command == "reduce")
+
+    std::vector<std::string> args = task.args;
+    args.insert(args.begin(), task.command == "map" ? "mapper" : "reducer");
+    TaskResult result;
+    result.exitCode = fork_and_run("./mapreduce", args, task.attempt);
+    if (result.exitCode == 0)
+        result.manifestPath = WorkerExecutor::publishedPath(task);
     {
-        std::string args;
-        std::getline(iss, args);
-        if (!args.empty() && args[0] == ' ')
-            args = args.substr(1); // Trim leading space
-
-        sendStatus("job started");
-        sendStatus("job processing");
-        fork_and_run("./mapreduce", "reducer " + args);
-        sendStatus("job completed");
+        std::lock_guard<std::mutex> lock(exec_mutex);
+        exec_running.erase(request_id);
     }
-    else if (command == "heartbeat")
+
+    client->transmit(FrameType::PROGRESS, request_id, FrameProtocol::encode(TaskProgress{1, 1}));
+    client->transmit(FrameType::RESULT_MANIFEST, request_id, FrameProtocol::encode(result));
+    sendStatus(request_id, result.exitCode == 0 ? "job completed" : "job failed");
+}
+
+// Returns false when the controller asks the worker to stop
+bool handleMessage(const Frame &frame, std::vector<std::thread> &tasks)
+{
+    switch (frame.type)
     {
-        sendStatus("alive");
-    }
-    else
+    case FrameType::JOB_ASSIGNMENT:
     {
-        std::cout << "[Worker Message] " << message << ": unknown" << std::endl;
+        TaskAssignment task;
+        if (!FrameProtocol::decode(frame.payload, task) || (task.command != "map" && task.command != "reduce"))
+        {
+            sendStatus(frame.requestId, "unknown or malformed job");
+            client->transmit(FrameType::RESULT_MANIFEST, frame.requestId, FrameProtocol::encode(TaskResult{-1, ""}));
+            break;
+        }
+        if (executor)
+        {
+            sendStatus(frame.requestId, "job queued");
+            executor->submit(frame.requestId, std::move(task));
+        }
+        else
+        {
+            tasks.emplace_back(runTask, frame.requestId, std::move(task));
+        }
+        break;
+    }
+    case FrameType::HEARTBEAT:
+        client->transmit(FrameType::HEARTBEAT, frame.requestId, FrameProtocol::encode(currentHeartbeat()));
+        break;
+    case FrameType::SHUTDOWN:
+        return false;
+    default:
+        std::cout << "[Worker Message] " << FrameProtocol::typeName(frame.type) << " #" << frame.requestId << ": unexpected" << std::endl;
+        break;
     }
+    return true;
 }
 
 int main(int argc, char *argv[])
 {
-    if (argc != 2)
+    // --exec forks ./mapreduce per task (isolated, but pays process startup every time)
+    bool exec_mode = argc > 1 && std::string(argv[1]) == "--exec";
+    int first = exec_mode ? 2 : 1;
+    if (argc - first < 1 || argc - first > 3)
     {
-        std::cerr << "Usage: worker_stub <controller_port>" << std::endl;
+        std::cerr << "Usage: worker_stub [--exec] <controller_port> [controller_host] [slots]" << std::endl;
         return 1;
     }
 
-    int controller_port = std::stoi(argv[1]);
-    client = SocketClient(controller_port);
+    int controller_port = std::stoi(argv[first]);
+    std::string controller_host = argc > first + 1 ? argv[first + 1] : "127.0.0.1";
+    WorkerInfo info;
+    info.slots = argc > first + 2 ? static_cast<uint32_t>(std::stoul(argv[first + 2])) : std::max(1u, std::thread::hardware_concurrency());
+    char hostname[256] = "worker";
+    gethostname(hostname, sizeof(hostname) - 1);
+    info.name = std::string(hostname) + "/" + std::to_string(getpid());
+
+    SocketClient connection(controller_port, controller_host);
+    client = &connection;
 
-    if (!client.initialize())
+    if (!client->initialize())
     {
         std::cerr << "Failed to initialize worker socket client." << std::endl;
         return 1;
     }
 
-    std::cout << "Worker connected to controller on port " << controller_port << std::endl;
+    // In-process mode reads the configuration and loads the libraries once;
+    // tasks share this worker's log file instead of opening their own
+    ProcessOrchestratorDLL orchestrator;
+    std::unique_ptr<WorkerExecutor> in_process;
+    if (!exec_mode)
+    {
+        Logger::getInstance().configureLogFilePath("worker_" + std::to_string(getpid()) + ".log");
+        orchestrator.loadConfig();
+        orchestrator.applyLoggerConfig();
+        in_process = std::make_unique<WorkerExecutor>(
+            orchestrator, info.slots,
+            [](uint32_t request_id)
+            {
+                sendStatus(request_id, "job started");
+                client->transmit(FrameType::PROGRESS, request_id, FrameProtocol::encode(TaskProgress{0, 1}));
+            },
+            [](uint32_t request_id, const TaskResult &result)
+            {
+                client->transmit(FrameType::PROGRESS, request_id, FrameProtocol::encode(TaskProgress{1, 1}));
+                client->transmit(FrameType::RESULT_MANIFEST, request_id, FrameProtocol::encode(result));
+                sendStatus(request_id, result.exitCode == 0 ? "job completed" : "job failed");
+            });
+        executor = in_process.get();
+    }
 
-    while (true)
+    // Tell the controller how many tasks to send at once
+    client->transmit(FrameType::REGISTER, 0, FrameProtocol::encode(info));
+    std::cout << "Worker " << info.name << " registered with " << info.slots << " slots ("
+              << (exec_mode ? "a process per task" : "in-process") << ")" << std::endl;
+
+    // Heartbeats keep going while tasks run, so the controller can tell a busy
+    // worker from a dead one and see how fast each task is going
+    std::mutex heartbeat_mutex;
+    std::condition_variable heartbeat_stop;
+    bool stopping = false;
+    std::thread heartbeat([&]()
+                          {
+        std::unique_lock<std::mutex> lock(heartbeat_mutex);
+        while (!heartbeat_stop.wait_for(lock, std::chrono::milliseconds(FrameProtocol::HEARTBEAT_INTERVAL_MS), [&]() { return stopping; }))
+            client->transmit(FrameType::HEARTBEAT, 0, FrameProtocol::encode(currentHeartbeat())); });
+
+    std::vector<std::thread> tasks;
+    Frame frame;
+    while (client->receive(frame))
     {
-        std::string message = client.receive();
-        if (message.empty())
-        {
-            std::cerr << "Connection lost. Exiting." << std::endl;
+        if (!handleMessage(frame, tasks))
             break;
-        }
-
-        handleMessage(message);
     }
 
-    client.cleanup();
+    // Let tasks in flight finish and report before closing the connection
+    for (auto &task : tasks)
+        task.join();
+    if (executor)
+        executor->drain();
+    {
+        std::lock_guard<std::mutex> lock(heartbeat_mutex);
+        stopping = true;
+    }
+    heartbeat_stop.notify_all();
+    heartbeat.join();
+    client->cleanup();
     return 0;
 }